@@ -0,0 +1,52 @@
+#include "Halide.h"
+
+namespace {
+
+// A vectorized pipeline exercising the vector operations that the C
+// backend emits with vector extensions: saturating arithmetic,
+// widening multiplies, shuffles, selects and horizontal reductions.
+class VectorPipeline : public Halide::Generator<VectorPipeline> {
+public:
+    Input<Buffer<uint8_t>> a{"a", 2};
+    Input<Buffer<uint8_t>> b{"b", 2};
+    Output<Buffer<int16_t>> output{"output", 2};
+
+    void generate() {
+        Var x, y;
+
+        // A saturating add and a saturating subtract.
+        Func sat_add, sat_sub;
+        sat_add(x, y) = cast<uint8_t>(min(cast<uint16_t>(a(x, y)) + b(x, y), 255));
+        sat_sub(x, y) = cast<uint8_t>(max(cast<int16_t>(a(x, y)) - b(x, y), 0));
+
+        // A widening multiply, of one input with the other reversed.
+        Func prod;
+        prod(x, y) = cast<int16_t>(a(x, y)) * cast<int16_t>(b(b.dim(0).extent() - 1 - x, y));
+
+        // An interleaving of the two saturated values.
+        Func interleaved;
+        interleaved(x, y) = select(x % 2 == 0, sat_add(x / 2, y), sat_sub(x / 2, y));
+
+        // A horizontal sum of each group of four adjacent values.
+        RDom r(0, 4);
+        Func sum;
+        sum(x, y) = cast<int16_t>(0);
+        sum(x, y) += cast<int16_t>(interleaved(4 * x + r, y));
+
+        output(x, y) = select(a(x, y) > b(x, y), prod(x, y), sum(x, y) - prod(x, y));
+
+        const int vector_size = natural_vector_size<int16_t>();
+        sat_add.compute_at(output, y).vectorize(x, vector_size);
+        sat_sub.compute_at(output, y).vectorize(x, vector_size);
+        interleaved.compute_at(output, y).vectorize(x, vector_size);
+        sum.compute_at(output, y).vectorize(x, vector_size);
+        // Vectorizing the RVar reduces the lanes of each vector of
+        // values horizontally.
+        sum.update().reorder(r, x).vectorize(r);
+        output.vectorize(x, vector_size).parallel(y, 8);
+    }
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(VectorPipeline, vector_pipeline)
@@ -103,6 +103,7 @@ class GEMMGenerator :
         } else {
             result_
                 .tile(i, j, ii, ji, s, 4)
+                .vectorize(ii).unroll(ji)
                 .tile(i, j, ti[0], tj[0], i, j, 1, s/4);
         }
 
@@ -139,7 +140,8 @@ class GEMMGenerator :
         }
 
 
-        AB.compute_at(result_, i)
+        // Keep the block of accumulators in registers.
+        AB.compute_at(result_, i).store_in_registers()
             .bound_extent(j, 4).unroll(j)
             .bound_extent(i, s).vectorize(i)
             .update()
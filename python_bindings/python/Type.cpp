@@ -30,6 +30,10 @@ std::string type_code_to_string(const h::Type &t) {
         code_string = "Handle";
         break;
 
+    case h::Type::BFloat:
+        code_string = "BFloat";
+        break;
+
     default:
         code_string = "unknown";
     }
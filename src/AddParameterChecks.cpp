@@ -99,6 +99,9 @@ Stmt add_parameter_checks(Stmt s, const Target &t) {
         ParamAssert p = asserts[i];
         // Upgrade the types to 64-bit versions for the error call
         Type wider = p.value.type().with_bits(64);
+        if (wider.is_bfloat()) {
+            wider = wider.with_code(Type::Float);
+        }
         p.limit_value = cast(wider, p.limit_value);
         p.value       = cast(wider, p.value);
 
@@ -59,12 +59,12 @@ ValType convert_halide_type_to_val_type(const Type &halide_t) {
         if (halide_t.bits() == 8) {
             val_t = ValType::Int8;
         } else if (halide_t.bits() == 16) {
-            val_t = ValType::UInt16;
+            val_t = ValType::Int16;
         } else if (halide_t.bits() == 32) {
-            val_t = ValType::UInt32;
+            val_t = ValType::Int32;
         } else {
             internal_assert(halide_t.bits() == 64);
-            val_t = ValType::UInt64;
+            val_t = ValType::Int64;
         }
     } else {
         internal_assert(halide_t.is_float());
@@ -324,6 +324,11 @@ const vector<AssociativePattern> &get_ops_table(const vector<Expr> &exprs) {
     vector<Type> types(exprs.size());
     for (size_t i = 0; i < exprs.size(); ++i) {
         types[i] = exprs[i].type();
+        if ((types[i].is_float() || types[i].is_bfloat()) && types[i].bits() == 16) {
+            // There are no tables for 16-bit floats.
+            debug(5) << "Returning empty table for type " << types[i] << "\n";
+            return empty;
+        }
     }
 
     RootExpr root = RootExpr::Unknown;
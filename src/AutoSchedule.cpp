@@ -1,8 +1,13 @@
 #include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <regex>
 
 #include "AutoSchedule.h"
 #include "AutoScheduleUtils.h"
+#include "Associativity.h"
 #include "ExprUsesVar.h"
 #include "FindCalls.h"
 #include "Func.h"
@@ -13,6 +18,7 @@
 #include "RegionCosts.h"
 #include "Scope.h"
 #include "Simplify.h"
+#include "ThreadPool.h"
 #include "Util.h"
 
 namespace Halide {
@@ -59,6 +65,68 @@ void merge_regions(map<string, Box> &result, const map<string, Box> &partial) {
     }
 }
 
+// Return the region of the Func 'prod' read by the extern stage 'ext' to
+// compute the region 'ext_region' of 'ext'. An extern stage is opaque, so
+// the region it reads has to be declared with estimates on 'prod'. Without
+// them, assume that the extern stage reads the same region of an input of
+// the same dimensionality as it computes (which is the case for most extern
+// stages which process images); the region of any other input is unknown.
+Box extern_input_footprint(const Function &prod, const Function &ext, const Box &ext_region) {
+    Box footprint;
+    const vector<Bound> &estimates = prod.schedule().estimates();
+    for (const string &arg : prod.args()) {
+        // If there are duplicates, use the most recent estimate.
+        for (int i = estimates.size() - 1; i >= 0; --i) {
+            if (estimates[i].var == arg) {
+                const Expr &min = estimates[i].min;
+                footprint.push_back(Interval(min, simplify(min + estimates[i].extent - 1)));
+                break;
+            }
+        }
+    }
+    if (footprint.size() == prod.args().size()) {
+        return footprint;
+    }
+    if (prod.dimensions() == ext.dimensions()) {
+        return ext_region;
+    }
+    return Box(vector<Interval>(prod.dimensions(), Interval()));
+}
+
+// Return the region of the buffer or image argument 'arg' of an extern stage
+// declared by its size or its bounds estimates. The dimensions for which
+// neither is known are unbounded.
+Box extern_input_footprint(const ExternFuncArgument &arg) {
+    Box footprint;
+    if (arg.is_buffer()) {
+        for (int d = 0; d < arg.buffer.dimensions(); d++) {
+            int min = arg.buffer.dim(d).min();
+            footprint.push_back(Interval(min, min + arg.buffer.dim(d).extent() - 1));
+        }
+    } else {
+        internal_assert(arg.is_image_param());
+        for (int d = 0; d < arg.image_param.dimensions(); d++) {
+            const Expr &min = arg.image_param.min_constraint_estimate(d);
+            const Expr &extent = arg.image_param.extent_constraint_estimate(d);
+            if (min.defined() && extent.defined()) {
+                footprint.push_back(Interval(min, simplify(min + extent - 1)));
+            } else {
+                footprint.push_back(Interval());
+            }
+        }
+    }
+    return footprint;
+}
+
+// Return the name of the buffer or image argument 'arg' of an extern stage.
+string extern_input_name(const ExternFuncArgument &arg) {
+    if (arg.is_buffer()) {
+        return arg.buffer.name();
+    }
+    internal_assert(arg.is_image_param());
+    return arg.image_param.name();
+}
+
 // Replace all occurrences of non-alphanumeric chars in 'name' with '_'.
 string get_sanitized_name(string name) {
     if (isdigit(name[0])) {
@@ -171,10 +239,15 @@ struct DependenceAnalysis {
     // Cache for bounds queries (bound queries with the same parameters are
     // common during the grouping process).
     map<RegionsRequiredQuery, vector<RegionsRequired>> regions_required_cache;
+    // Cache for the per-expression bounds queries made while walking the
+    // dependencies. The same stage is typically reached with the same
+    // bounds from many different queries.
+    BoundsCache bounds_cache;
 
     DependenceAnalysis(const map<string, Function> &env, const vector<string> &order,
                        const FuncValueBounds &func_val_bounds)
-        : env(env), order(order), func_val_bounds(func_val_bounds) {}
+        : env(env), order(order), func_val_bounds(func_val_bounds),
+          bounds_cache(func_val_bounds) {}
 
     // Return the regions of the producers ('prods') required to compute the region
     // of the function stage ('f', 'stage_num') specified by 'bounds'. When
@@ -426,49 +499,52 @@ DependenceAnalysis::regions_required(Function f, int stage_num,
 
                 // If the function has an extern definition, there is no visibility into
                 // the expression defining the function. So the regions required will be
-                // the entire domain of the inputs to the extern func. Use the estimates
-                // on the inputs to the extern function if available.
+                // the footprints declared with estimates on the inputs to the extern
+                // func (see extern_input_footprint).
                 //
                 // TODO: Query the extern function for bounds of the functions which it
                 // it depends on. This can be done by calling the extern func in the
                 // bounds query mode.
                 if (s.func.has_extern_definition()) {
+                    Box ext_region;
+                    for (const string &arg : s.func.args()) {
+                        const auto &b = curr_bounds.find(arg);
+                        if (b == curr_bounds.end()) {
+                            ext_region.push_back(Interval());
+                            continue;
+                        }
+                        Expr lower = SubstituteVarEstimates().mutate(b->second.min);
+                        Expr upper = SubstituteVarEstimates().mutate(b->second.max);
+                        ext_region.push_back(Interval(simplify(lower), simplify(upper)));
+                    }
+                    // Like any other stage, the extern stage writes to the region of
+                    // itself it computes.
+                    map<string, Box> ext_reg;
+                    ext_reg.emplace(s.func.name(), ext_region);
+                    merge_and_queue_regions(fs_bounds, regions, ext_reg, prods, env,
+                                            only_regions_computed, s.func.name(), visited);
                     for (const ExternFuncArgument &arg : s.func.extern_arguments()) {
                         if (arg.is_func()) {
-                            // If the argument is an entire function, the bounds of the
-                            // function required are unknown. Create an infinite region
-                            // of the correct dimension, update the region map, and
-                            // add it to the queue.
-                            string prod_name = Function(arg.func).name();
-                            const Function &prod_func = get_element(env, prod_name);
+                            // Update the region map with the footprint of the function,
+                            // and add it to the queue.
+                            Function prod_func(arg.func);
                             map<string, Box> prod_reg;
-                            const vector<string> &args = prod_func.args();
-                            for (size_t v = 0; v < args.size(); v++) {
-                                prod_reg[prod_name].push_back(Interval());
-                            }
+                            prod_reg.emplace(prod_func.name(),
+                                             extern_input_footprint(prod_func, s.func, ext_region));
                             merge_and_queue_regions(fs_bounds, regions, prod_reg, prods, env,
                                                     only_regions_computed, s.func.name(), visited);
                         } else if (arg.is_expr()) {
                             // Find the boxes required for the expression and add the regions
                             // to the queue.
                             Expr subs_arg = SubstituteVarEstimates().mutate(arg.expr);
-                            map<string, Box> arg_regions = boxes_required(subs_arg, curr_scope, func_val_bounds);
+                            map<string, Box> arg_regions = bounds_cache.boxes_required(subs_arg, curr_scope);
                             merge_and_queue_regions(fs_bounds, regions, arg_regions, prods, env,
                                                     only_regions_computed, s.func.name(), visited);
                         } else if (arg.is_image_param() || arg.is_buffer()) {
-                            // If the argument is an image or a buffer, the required
-                            // bounds are unknown. Create an infinite region of the
-                            // correct dimension and update the region map.
-                            Buffer<> buf;
-                            if (arg.is_image_param()) {
-                                buf = arg.image_param.get_buffer();
-                            } else {
-                                buf = arg.buffer;
-                            }
+                            // If the argument is an image or a buffer, update the
+                            // region map with its footprint.
                             map<string, Box> buf_reg;
-                            for (int v = 0; v < buf.dimensions(); v++) {
-                                buf_reg[buf.name()].push_back(Interval());
-                            }
+                            buf_reg.emplace(extern_input_name(arg), extern_input_footprint(arg));
                             merge_regions(regions, buf_reg);
                         }
                     }
@@ -480,7 +556,7 @@ DependenceAnalysis::regions_required(Function f, int stage_num,
                     // Substitute the parameter estimates into the expression and get
                     // the regions required for the expression.
                     Expr subs_val = SubstituteVarEstimates().mutate(val);
-                    map<string, Box> curr_regions = boxes_required(subs_val, curr_scope, func_val_bounds);
+                    map<string, Box> curr_regions = bounds_cache.boxes_required(subs_val, curr_scope);
 
                     // Arguments to the definition may require regions of functions.
                     // For example, update definitions in histograms where the bin is
@@ -488,13 +564,13 @@ DependenceAnalysis::regions_required(Function f, int stage_num,
                     Box left_reg;
                     for (const Expr &arg : def.args()) {
                         Expr subs_arg = SubstituteVarEstimates().mutate(arg);
-                        map<string, Box> arg_regions = boxes_required(subs_arg, curr_scope, func_val_bounds);
+                        map<string, Box> arg_regions = bounds_cache.boxes_required(subs_arg, curr_scope);
 
                         // Merge the regions with the regions found while looking at
                         // the values.
                         merge_regions(curr_regions, arg_regions);
 
-                        Interval arg_bounds = bounds_of_expr_in_scope(arg, curr_scope, func_val_bounds);
+                        Interval arg_bounds = bounds_cache.bounds_of_expr_in_scope(arg, curr_scope);
                         left_reg.push_back(arg_bounds);
                     }
 
@@ -652,52 +728,110 @@ DependenceAnalysis::overlap_regions(Function f, int stage_num,
     return conc_overlaps;
 }
 
-// Return the regions of each function required for computing the
-// outputs of the pipeline.
-map<string, Box> get_pipeline_bounds(DependenceAnalysis &analysis,
-                                     const vector<Function> &outputs,
-                                     const Scope<Interval> *input_estimates) {
-    map<string, Box> pipeline_bounds;
-
-    // Find the regions required for each of the outputs and merge them
-    // to compute the full pipeline_bounds.
-    for (const auto &out : outputs) {
-        DimBounds pure_bounds;
-        Box out_box;
-        // Use the estimates on the output for determining the output bounds.
-        // If there are duplicates, use the most recent estimate.
-        const auto &estimates = out.schedule().estimates();
-        for (const auto &arg : out.args()) {
-            int i;
-            for (i = estimates.size() - 1; i >= 0; --i) {
-                const auto &est = estimates[i];
-                if (est.var == arg) {
-                    Interval I = Interval(est.min, simplify(est.min + est.extent - 1));
-                    pure_bounds.emplace(arg, I);
-                    out_box.push_back(I);
-                    break;
-                }
+// Return the regions of the functions in 'prods' required for computing
+// the estimated region of the output 'out', including 'out' itself.
+map<string, Box> output_required_regions(DependenceAnalysis &analysis, const Function &out,
+                                         const set<string> &prods,
+                                         const Scope<Interval> *input_estimates) {
+    DimBounds pure_bounds;
+    Box out_box;
+    // Use the estimates on the output for determining the output bounds.
+    // If there are duplicates, use the most recent estimate.
+    const auto &estimates = out.schedule().estimates();
+    for (const auto &arg : out.args()) {
+        int i;
+        for (i = estimates.size() - 1; i >= 0; --i) {
+            const auto &est = estimates[i];
+            if (est.var == arg) {
+                Interval I = Interval(est.min, simplify(est.min + est.extent - 1));
+                pure_bounds.emplace(arg, I);
+                out_box.push_back(I);
+                break;
             }
-            internal_assert(i >= 0);
         }
+        internal_assert(i >= 0);
+    }
 
-        set<string> prods;
-        for (const pair<string, Function> &fpair : analysis.env) {
-            prods.insert(fpair.first);
-        }
+    map<string, Box> regions = analysis.regions_required(out, pure_bounds, prods,
+                                                         false, input_estimates);
 
-        map<string, Box> regions = analysis.regions_required(out, pure_bounds, prods,
-                                                             false, input_estimates);
+    // Add the output region to the pipeline bounds as well.
+    regions.emplace(out.name(), out_box);
+    return regions;
+}
 
-        // Add the output region to the pipeline bounds as well.
-        regions.emplace(out.name(), out_box);
+// Compute 'n' results concurrently, using the dependence analyses in
+// 'workers'. Since the caches of a DependenceAnalysis are not thread-safe,
+// each analysis is only used by a single task: 'fn(a, begin, stride)' must
+// return the results with indices begin, begin + stride, ... computed
+// using the analysis 'a'. The results are returned in order. If there are
+// fewer than two workers, 'fn' is run on 'analysis' on the calling thread.
+template<typename T, typename Fn>
+vector<T> map_with_analyses(DependenceAnalysis &analysis,
+                            const vector<std::shared_ptr<DependenceAnalysis>> &workers,
+                            size_t n, Fn fn) {
+    size_t num_workers = std::min(workers.size(), n);
+    if (num_workers <= 1) {
+        vector<T> results = fn(analysis, 0, 1);
+        internal_assert(results.size() == n);
+        return results;
+    }
+
+    ThreadPool<vector<T>> pool(num_workers);
+    vector<std::future<vector<T>>> futures;
+    for (size_t k = 0; k < num_workers; k++) {
+        DependenceAnalysis *a = workers[k].get();
+        futures.push_back(pool.async([&fn, a, k, num_workers]() {
+            return fn(*a, k, num_workers);
+        }));
+    }
+
+    vector<T> results(n);
+    for (size_t k = 0; k < num_workers; k++) {
+        vector<T> partial = futures[k].get();
+        for (size_t j = 0; j < partial.size(); j++) {
+            internal_assert(k + j * num_workers < n);
+            results[k + j * num_workers] = std::move(partial[j]);
+        }
+    }
+    return results;
+}
 
-        merge_regions(pipeline_bounds, regions);
+// Return the regions of each function required for computing the
+// outputs of the pipeline. The regions required for different outputs
+// are computed concurrently using the dependence analyses in 'workers'.
+map<string, Box> get_pipeline_bounds(DependenceAnalysis &analysis,
+                                     const vector<Function> &outputs,
+                                     const Scope<Interval> *input_estimates,
+                                     const vector<std::shared_ptr<DependenceAnalysis>> &workers) {
+    set<string> prods;
+    for (const auto &fpair : analysis.env) {
+        prods.insert(fpair.first);
     }
 
+    // Find the regions required for each of the outputs.
+    auto output_regions = [&](DependenceAnalysis &a, size_t begin, size_t stride) {
+        vector<map<string, Box>> result;
+        for (size_t o = begin; o < outputs.size(); o += stride) {
+            result.push_back(output_required_regions(a, outputs[o], prods, input_estimates));
+        }
+        return result;
+    };
+    vector<map<string, Box>> regions =
+        map_with_analyses<map<string, Box>>(analysis, workers, outputs.size(), output_regions);
+
+    // Merge them to compute the full pipeline_bounds.
+    map<string, Box> pipeline_bounds;
+    for (const auto &r : regions) {
+        merge_regions(pipeline_bounds, r);
+    }
     return pipeline_bounds;
 }
 
+// The first line of a serialized schedule. This should be changed whenever
+// the format changes.
+const char *const serialized_schedule_header = "# Halide auto-schedule v1";
+
 struct AutoSchedule {
     struct Stage {
         string function;
@@ -731,6 +865,16 @@ struct AutoSchedule {
     // function stages.
     map<string, map<int, set<string>>> used_vars;
 
+    // The names of the rvars of each update definition of the functions in the
+    // pipeline, before any schedule is applied (rfactor changes the rvars of
+    // the update definition it is applied to).
+    map<string, vector<vector<string>>> update_rvars;
+
+    // Intermediate functions created by rfactor(), mapped to the function
+    // stage they were created from. Their schedules are printed along with
+    // the schedules of that function.
+    map<string, Stage> intermediates;
+
     AutoSchedule(const map<string, Function> &env, const vector<string> &order) : env(env) {
         for (size_t i = 0; i < order.size(); ++i) {
             realization_order.emplace(order[i], i);
@@ -740,6 +884,14 @@ struct AutoSchedule {
             for (size_t i = 0; i < iter.second.updates().size() + 1; ++i) {
                 used_vars[iter.first][i];
             }
+            update_rvars[iter.first];
+            for (const Definition &def : iter.second.updates()) {
+                vector<string> rvars;
+                for (const ReductionVariable &rv : def.schedule().rvars()) {
+                    rvars.push_back(rv.var);
+                }
+                update_rvars[iter.first].push_back(rvars);
+            }
         }
     }
 
@@ -766,6 +918,9 @@ struct AutoSchedule {
         std::ostringstream schedule_ss;
 
         for (const auto &f : sched.func_schedules) {
+            if (sched.intermediates.count(f.first)) {
+                continue;
+            }
             const string &fname = get_sanitized_name(f.first);
             func_ss << "Func " << fname << " = " << sched.get_func_handle(f.first) << ";\n";
 
@@ -781,30 +936,28 @@ struct AutoSchedule {
                 }
             }
             set<string> declared_rvars;
-            for (size_t i = 0; i < func.updates().size(); ++i) {
-                const vector<ReductionVariable> &rvars = func.updates()[i].schedule().rvars();
-                const set<string> &var_list = sched.used_vars.at(func.name()).at(i);
+            const vector<vector<string>> &stage_rvars = sched.update_rvars.at(func.name());
+            for (size_t i = 0; i < stage_rvars.size(); ++i) {
+                const vector<string> &rvars = stage_rvars[i];
+                const set<string> &var_list = sched.used_vars.at(func.name()).at(i + 1);
                 for (size_t j = 0; j < rvars.size(); ++j) {
-                    if ((var_list.find(rvars[j].var) == var_list.end()) ||
-                        (declared_rvars.find(rvars[j].var) != declared_rvars.end())) {
+                    if ((var_list.find(rvars[j]) == var_list.end()) ||
+                        (declared_rvars.find(rvars[j]) != declared_rvars.end())) {
                         continue;
                     }
-                    declared_rvars.insert(rvars[j].var);
-                    schedule_ss << "    RVar " << rvars[j].var << "("
+                    declared_rvars.insert(rvars[j]);
+                    schedule_ss << "    RVar " << rvars[j] << "("
                                 << fname << ".update(" << i << ").get_schedule().rvars()[" << j << "].var);\n";
                 }
             }
 
             for (const auto &s : f.second) {
                 internal_assert(!s.second.empty());
-                schedule_ss << "    " << fname;
+                string stage_handle = fname;
                 if (s.first > 0) {
-                    schedule_ss << ".update(" << std::to_string(s.first - 1) << ")";
+                    stage_handle += ".update(" + std::to_string(s.first - 1) + ")";
                 }
-                for (size_t i = 0; i < s.second.size(); ++i) {
-                    schedule_ss << "\n        ." << s.second[i];
-                }
-                schedule_ss << ";\n";
+                sched.print_stage_schedule(schedule_ss, f.first, s.first, stage_handle, s.second);
             }
 
             schedule_ss << "}\n";
@@ -816,6 +969,137 @@ struct AutoSchedule {
         return stream;
     }
 
+    // Print the list of schedules 'schedules' applied to the stage 'stage_num'
+    // of function 'func', which is referred to as 'stage_handle'. An rfactor()
+    // ends the chain; it is followed by the schedules of the intermediate
+    // function it creates.
+    void print_stage_schedule(std::ostream &stream, const string &func, int stage_num,
+                              const string &stage_handle,
+                              const vector<string> &schedules) const {
+        bool open = false;
+        for (const string &s : schedules) {
+            if (starts_with(s, "rfactor(")) {
+                if (open) {
+                    stream << ";\n";
+                    open = false;
+                }
+                string intm;
+                for (const auto &iter : intermediates) {
+                    if ((iter.second.function == func) && ((int)iter.second.stage == stage_num)) {
+                        intm = iter.first;
+                    }
+                }
+                internal_assert(!intm.empty());
+                string intm_name = get_sanitized_name(intm);
+                stream << "    Func " << intm_name << " = " << stage_handle << "." << s << ";\n";
+                const auto &intm_iter = func_schedules.find(intm);
+                if (intm_iter != func_schedules.end()) {
+                    for (const auto &intm_s : intm_iter->second) {
+                        string intm_handle = intm_name;
+                        if (intm_s.first > 0) {
+                            intm_handle += ".update(" + std::to_string(intm_s.first - 1) + ")";
+                        }
+                        print_stage_schedule(stream, intm, intm_s.first, intm_handle, intm_s.second);
+                    }
+                }
+                continue;
+            }
+            if (!open) {
+                stream << "    " << stage_handle;
+                open = true;
+            }
+            stream << "\n        ." << s;
+        }
+        if (open) {
+            stream << ";\n";
+        }
+    }
+
+    // Write the schedules in the serialized form read by apply_schedules():
+    // a header line, followed by one line per schedule applied, of the form
+    // "<function> <stage> <directive> <args>...". The lines are in the order
+    // in which the schedules need to be applied.
+    void serialize(std::ostream &stream) const {
+        // The schedules refer to other functions by their sanitized names.
+        map<string, string> func_names;
+        for (const auto &iter : env) {
+            func_names.emplace(get_sanitized_name(iter.first), iter.first);
+        }
+        for (const auto &iter : intermediates) {
+            func_names.emplace(get_sanitized_name(iter.first), iter.first);
+        }
+
+        stream << serialized_schedule_header << '\n';
+        for (const auto &f : func_schedules) {
+            if (intermediates.count(f.first)) {
+                continue;
+            }
+            for (const auto &s : f.second) {
+                serialize_stage_schedule(stream, f.first, s.first, s.second, func_names);
+            }
+        }
+    }
+
+    // Write the list of schedules 'schedules' applied to the stage 'stage_num'
+    // of function 'func' in serialized form. An rfactor() is followed by the
+    // schedules of the intermediate function it creates.
+    void serialize_stage_schedule(std::ostream &stream, const string &func, int stage_num,
+                                  const vector<string> &schedules,
+                                  const map<string, string> &func_names) const {
+        for (const string &s : schedules) {
+            size_t open = s.find('(');
+            internal_assert((open != string::npos) && (s.back() == ')'));
+            string directive = s.substr(0, open);
+            string arg_list = s.substr(open + 1, s.size() - open - 2);
+            vector<string> args;
+            if (!arg_list.empty()) {
+                args = split_string(arg_list, ", ");
+            }
+
+            stream << func << ' ' << stage_num << ' ' << directive;
+            for (size_t i = 0; i < args.size(); i++) {
+                string arg = args[i];
+                if (((directive == "compute_at") || (directive == "store_at")) && (i == 0)) {
+                    arg = get_element(func_names, arg);
+                } else if ((directive == "split") && (i == 4)) {
+                    internal_assert(starts_with(arg, "TailStrategy::"));
+                    arg = arg.substr(std::string("TailStrategy::").size());
+                }
+                stream << ' ' << arg;
+            }
+
+            if (directive != "rfactor") {
+                stream << '\n';
+                continue;
+            }
+
+            string intm;
+            for (const auto &iter : intermediates) {
+                if ((iter.second.function == func) && ((int)iter.second.stage == stage_num)) {
+                    intm = iter.first;
+                }
+            }
+            internal_assert(!intm.empty());
+            stream << ' ' << intm << '\n';
+            const auto &intm_iter = func_schedules.find(intm);
+            if (intm_iter != func_schedules.end()) {
+                for (const auto &intm_s : intm_iter->second) {
+                    serialize_stage_schedule(stream, intm, intm_s.first, intm_s.second, func_names);
+                }
+            }
+        }
+    }
+
+    // Record that the stage 'stage_num' of the function named by 'stage_name'
+    // was rfactored with arguments 'args' into the intermediate function 'intm'.
+    void push_rfactor(const string &stage_name, size_t stage_num, const string &intm,
+                      const string &args, const set<string> &vars) {
+        vector<string> v = split_string(stage_name, ".");
+        internal_assert(!v.empty());
+        intermediates.emplace(intm, Stage(v[0], stage_num));
+        push_schedule(stage_name, stage_num, "rfactor(" + args + ")", vars);
+    }
+
     void push_schedule(const string &stage_name, size_t stage_num,
                        const string &sched, const set<string> &vars) {
         vector<string> v = split_string(stage_name, ".");
@@ -823,6 +1107,15 @@ struct AutoSchedule {
 
         used_vars[v[0]][stage_num].insert(vars.begin(), vars.end());
 
+        // The vars used by the schedule of an intermediate function are
+        // declared along with the function it was created from.
+        const auto &intm_iter = intermediates.find(v[0]);
+        if (intm_iter != intermediates.end()) {
+            const Stage &parent = intm_iter->second;
+            used_vars[parent.function][0].insert(vars.begin(), vars.end());
+            used_vars[parent.function][parent.stage].insert(vars.begin(), vars.end());
+        }
+
         // If the previous schedule applied is the same as this one,
         // there is no need to re-apply the schedule
         auto &schedules = func_schedules[v[0]][stage_num];
@@ -894,11 +1187,13 @@ struct Partitioner {
     // can be integrated into the cost model with out significantly increasing
     // the time to analyze a grouping configuration.
     //
-    // TODO: Add sliding window optimizations. For start, it may be enough to
-    // implement sliding window as a post-pass by moving the store level of all
-    // the members of the group to the outermost serial loop. This could possibly
-    // be incorporated in the cost model with some effort. Line-buffering
-    // presents additional challenges for this post-processing strategy though.
+    // Sliding window is implemented as a post-pass (see
+    // \ref Partitioner::should_slide) which moves the store level of the
+    // members of the group out to the tile loop enclosing the one they are
+    // computed at, when the innermost tile loop is serial.
+    //
+    // TODO: Incorporate sliding window into the cost model. Line-buffering
+    // presents additional challenges for the post-processing strategy.
     // A typical line-buffer would use terrible tile size for tiling, but its
     // performance will improve significantly once sliding window is turned on.
     //
@@ -1034,11 +1329,25 @@ struct Partitioner {
     RegionCosts &costs;
     // Output functions of the pipeline.
     const vector<Function> &outputs;
+    // Dependence analyses used to evaluate tile configurations and grouping
+    // choices concurrently, one per worker thread. When this is empty, they
+    // are evaluated serially with 'dep_analysis'.
+    vector<std::shared_ptr<DependenceAnalysis>> worker_analyses;
 
     Partitioner(const map<string, Box> &_pipeline_bounds, const MachineParams &_arch_params,
                 DependenceAnalysis &_dep_analysis, RegionCosts &_costs,
                 const vector<Function> &_outputs, const set<string> &unbounded);
 
+    // Copy the grouping state of 'other', but answer dependence queries with
+    // '_dep_analysis'. The caches of a DependenceAnalysis are not thread-safe,
+    // so partitioners which are used from different threads must each have
+    // their own. The copy evaluates everything serially.
+    Partitioner(const Partitioner &other, DependenceAnalysis &_dep_analysis)
+        : grouping_cache(other.grouping_cache), groups(other.groups),
+          children(other.children), group_costs(other.group_costs),
+          pipeline_bounds(other.pipeline_bounds), arch_params(other.arch_params),
+          dep_analysis(_dep_analysis), costs(other.costs), outputs(other.outputs) {}
+
     void initialize_groups();
 
     // Merge 'prod_group' into 'cons_group'. The output stage of 'cons_group'
@@ -1053,7 +1362,10 @@ struct Partitioner {
 
     // Given a grouping 'g', compute the estimated cost (arithmetic + memory) and
     // parallelism that can be potentially exploited when computing that group.
-    GroupAnalysis analyze_group(const Group &g, bool show_analysis);
+    // Dependence queries are answered by 'analysis', which is either
+    // 'dep_analysis' or one of 'worker_analyses' (see \ref map_with_analyses).
+    GroupAnalysis analyze_group(const Group &g, bool show_analysis,
+                                DependenceAnalysis &analysis);
 
     // For each group in the partition, return the regions of the producers
     // need to be allocated to compute a tile of the group's output.
@@ -1067,9 +1379,29 @@ struct Partitioner {
     // reached.
     void group(Partitioner::Level level);
 
+    // Same as \ref Partitioner::group, but rather than committing to the
+    // single best merge at each step, keep the 'beam_width' lowest cost
+    // partitions reachable by merging the 'beam_width' best choices of each
+    // partition in the beam, and finish with the lowest cost partition found.
+    // The partitions in the beam are expanded in parallel. Once 'time_budget'
+    // seconds have passed (if positive), the search continues greedily from
+    // the best partition in the beam.
+    void group_beam_search(Partitioner::Level level, int beam_width, double time_budget);
+
+    // Return the (producer, consumer) pairs of functions that can currently be
+    // grouped at 'level'. The consumer is empty when grouping by inlining.
+    vector<pair<string, string>> grouping_candidates(Partitioner::Level level);
+
+    // Merge the producer in 'best' into its consumers as specified by each
+    // of the choices, and update the children and the grouping cache.
+    void apply_grouping(const vector<pair<GroupingChoice, GroupConfig>> &best,
+                        Partitioner::Level level);
+
     // Given a grouping choice, return a configuration for the group that gives
-    // the highest estimated benefits.
-    GroupConfig evaluate_choice(const GroupingChoice &group, Partitioner::Level level);
+    // the highest estimated benefits. Dependence queries are answered by
+    // 'analysis', as in \ref Partitioner::analyze_group.
+    GroupConfig evaluate_choice(const GroupingChoice &group, Partitioner::Level level,
+                                DependenceAnalysis &analysis);
 
     // Pick the best choice among all the grouping options currently available. Uses
     // the cost model to estimate the benefit of each choice. This returns a vector of
@@ -1078,6 +1410,12 @@ struct Partitioner {
     choose_candidate_grouping(const vector<pair<string, string>> &cands,
                               Partitioner::Level level);
 
+    // Same as above, but this returns up to 'max_choices' of the beneficial
+    // grouping choices, ordered by decreasing benefit.
+    vector<vector<pair<GroupingChoice, GroupConfig>>>
+    choose_candidate_groupings(const vector<pair<string, string>> &cands,
+                               Partitioner::Level level, int max_choices);
+
     // Return the bounds required to produce a function stage.
     DimBounds get_bounds(const FStage &stg);
 
@@ -1094,8 +1432,10 @@ struct Partitioner {
 
     // Find the best tiling configuration for a group 'g' among a set of tile
     // configurations. This returns a pair of configuration with the highest
-    // estimated benefit and the estimated benefit.
-    pair<map<string, Expr>, GroupAnalysis> find_best_tile_config(const Group &g);
+    // estimated benefit and the estimated benefit. Dependence queries are
+    // answered by 'analysis', as in \ref Partitioner::analyze_group.
+    pair<map<string, Expr>, GroupAnalysis> find_best_tile_config(const Group &g,
+                                                                 DependenceAnalysis &analysis);
 
     // Estimate the benefit (arithmetic + memory) of 'new_grouping' over 'old_grouping'.
     // Positive values indicates that 'new_grouping' may be preferrable over 'old_grouping'.
@@ -1148,14 +1488,67 @@ struct Partitioner {
     void generate_cpu_schedule(const Target &t, AutoSchedule &sched);
 
     // Same as \ref Partitioner::generate_cpu_schedule, but this generates and
-    // applies schedules for a group of function stages.
-
+    // applies schedules for a group of function stages. 'l1_tile_sizes' are
+    // the sizes of the sub-tiles the tiles of the group output are split into
+    // so that each fits in L1 (see \ref Partitioner::group_l1_tile_sizes).
+    // If the loop over the tiles along one of the 'sliding_dims' ends up
+    // innermost and serial, the members are stored at the enclosing tile
+    // loop rather than at the tile.
     void generate_group_cpu_schedule(const Group &g, const Target &t,
                                      const map<FStage, DimBounds> &group_loop_bounds,
                                      const map<string, Box> &group_storage_bounds,
+                                     const map<string, Expr> &l1_tile_sizes,
+                                     const set<string> &sliding_dims,
                                      const set<string> &inlines,
                                      AutoSchedule &sched);
 
+    // Return the number of bytes accessed while computing a tile of size
+    // 'tile_sizes' of the output stage of group 'g', assuming the non-inlined
+    // members of the group have already been computed. Returns an undefined
+    // Expr if the footprint cannot be determined.
+    Expr tile_footprint(const Group &g, const map<string, Expr> &tile_sizes);
+
+    // For machines with a cache hierarchy, find the sizes of the sub-tiles of
+    // each group's output tiles whose footprint fits in the L1 cache. The
+    // tiles chosen by the grouping target the larger caches; computing the
+    // output in L1-sized sub-tiles inside them gives two levels of tiling.
+    // Groups which need no sub-tiling get an empty map.
+    map<FStage, map<string, Expr>> group_l1_tile_sizes();
+
+    // Same as \ref Partitioner::generate_cpu_schedule, but this maps each group
+    // onto a GPU. The output stage of a group is tiled into GPU blocks using the
+    // tile sizes chosen by the grouping, and the non-inlined members of the group
+    // are computed per block (and hence staged in shared memory) with their own
+    // dimensions mapped to GPU threads.
+    void generate_gpu_schedule(AutoSchedule &sched);
+
+    // Same as \ref Partitioner::generate_gpu_schedule, but this generates and
+    // applies schedules for a group of function stages.
+    void generate_group_gpu_schedule(const Group &g,
+                                     const map<FStage, DimBounds> &group_loop_bounds,
+                                     AutoSchedule &sched);
+
+    // Map up to three parallel dimensions of stage 'f_handle' onto GPU threads
+    // and, if 'map_blocks' is set, GPU blocks. Dimensions with an entry in
+    // 'tile_sizes' are first split into blocks of that size; the number of
+    // threads along each dimension is picked by \ref pick_gpu_threads. Return
+    // the innermost block dimension, or an unnamed VarOrRVar if none was created.
+    VarOrRVar gpu_tile_stage(
+        const Group &g, Stage f_handle, int stage_num, Definition def,
+        const string &func_name, bool is_group_output, bool map_blocks,
+        const map<string, Expr> &tile_sizes, set<string> &rvars,
+        map<string, Expr> &estimates, AutoSchedule &sched);
+
+    // Pick the number of GPU threads along each dimension of a stage given the
+    // extent of the dimension and the size of the block tile along it (an
+    // undefined block tile means the dimension is split into blocks of exactly
+    // one thread tile, and an undefined extent means unknown). Candidate thread
+    // tiles are warp multiples of 32 to 256 threads; the one which wastes the
+    // fewest threads on partial tiles while still launching enough blocks to
+    // occupy 'arch_params.parallelism' multiprocessors is chosen.
+    vector<int> pick_gpu_threads(const vector<Expr> &extents,
+                                 const vector<Expr> &block_tiles);
+
     // Split the dimension of stage 'f_handle' along 'v' into inner and outer
     // dimensions. Modify 'estimates' according to the split and append the split
     // schedule to 'sched'.
@@ -1164,6 +1557,35 @@ struct Partitioner {
         bool is_group_output, VarOrRVar v, const Expr &factor, string in_suffix,
         string out_suffix, map<string, Expr> &estimates, AutoSchedule &sched);
 
+    // If the update stage 'f_handle', which is the output of group 'g', can
+    // neither be parallelized enough along its pure dimensions nor along any of
+    // its RVars, but the reduction is associative, split its outermost RVar
+    // and rfactor() the outer part into an intermediate function computed at
+    // root, which computes the partial reductions in parallel. The stage is
+    // left to merge the partial results. Return true if the stage was
+    // rfactored.
+    bool rfactor_stage(const Group &g, Stage f_handle, Definition def,
+                       map<string, Expr> &estimates, AutoSchedule &sched);
+
+    // Return true if the non-inlined members of group 'g', which are computed
+    // within each tile of the group output, should instead be stored for a
+    // whole strip of tiles along the output dimension 'slide_dim', so that
+    // Halide's sliding window optimization only computes the values that were
+    // not already computed for the previous tile (and folds the storage). This
+    // trades the recomputation of the overlap between adjacent tiles for the
+    // storage of a strip, which must fit in the last level cache.
+    bool should_slide(const Group &g, const string &slide_dim);
+
+    // For each group in the partition, return the tiled dimensions of the
+    // group output along which its members should slide (see
+    // \ref Partitioner::should_slide).
+    map<FStage, set<string>> group_sliding_dims();
+
+    // Return true if the output of group 'g', which is computed at root, only
+    // depends on scalar parameters, and is expensive enough to compute that
+    // memoizing it across invocations of the pipeline pays off.
+    bool should_memoize(const Group &g);
+
     // Loop over the dimensions of function stage 'f_handle' starting from innermost
     // and vectorize the first pure dimension encountered.
     void vectorize_stage(
@@ -1361,10 +1783,25 @@ Partitioner::Partitioner(const map<string, Box> &_pipeline_bounds,
 }
 
 void Partitioner::initialize_groups() {
+    vector<Group *> to_init;
     for (pair<const FStage, Group> &g : groups) {
-        pair<map<string, Expr>, GroupAnalysis> best = find_best_tile_config(g.second);
-        g.second.tile_sizes = best.first;
-        group_costs.emplace(g.second.output, best.second);
+        to_init.push_back(&g.second);
+    }
+
+    auto tile_configs = [&](DependenceAnalysis &analysis, size_t begin, size_t stride) {
+        vector<pair<map<string, Expr>, GroupAnalysis>> result;
+        for (size_t i = begin; i < to_init.size(); i += stride) {
+            result.push_back(find_best_tile_config(*to_init[i], analysis));
+        }
+        return result;
+    };
+    vector<pair<map<string, Expr>, GroupAnalysis>> best =
+        map_with_analyses<pair<map<string, Expr>, GroupAnalysis>>(
+            dep_analysis, worker_analyses, to_init.size(), tile_configs);
+
+    for (size_t i = 0; i < to_init.size(); i++) {
+        to_init[i]->tile_sizes = best[i].first;
+        group_costs.emplace(to_init[i]->output, best[i].second);
     }
     grouping_cache.clear();
 }
@@ -1418,8 +1855,53 @@ map<string, Expr> Partitioner::evaluate_reuse(const FStage &stg,
 vector<pair<Partitioner::GroupingChoice, Partitioner::GroupConfig>>
 Partitioner::choose_candidate_grouping(const vector<pair<string, string>> &cands,
                                        Partitioner::Level level) {
-    vector<pair<GroupingChoice, GroupConfig>> best_grouping;
-    Expr best_benefit = make_zero(Int(64));
+    vector<vector<pair<GroupingChoice, GroupConfig>>> best =
+        choose_candidate_groupings(cands, level, 1);
+    if (best.empty()) {
+        return vector<pair<GroupingChoice, GroupConfig>>();
+    }
+    return best[0];
+}
+
+vector<vector<pair<Partitioner::GroupingChoice, Partitioner::GroupConfig>>>
+Partitioner::choose_candidate_groupings(const vector<pair<string, string>> &cands,
+                                        Partitioner::Level level, int max_choices) {
+    internal_assert(max_choices > 0);
+
+    // Evaluate all the choices which are not in the cache yet up front, so
+    // that they can be evaluated concurrently.
+    vector<GroupingChoice> to_eval;
+    set<GroupingChoice> seen;
+    for (const auto &p : cands) {
+        const Function &prod_f = get_element(dep_analysis.env, p.first);
+        FStage prod(prod_f, prod_f.updates().size());
+        for (const FStage &c : get_element(children, prod)) {
+            GroupingChoice cand_choice(prod_f.name(), c);
+            if ((grouping_cache.find(cand_choice) == grouping_cache.end()) &&
+                seen.insert(cand_choice).second) {
+                to_eval.push_back(cand_choice);
+            }
+        }
+    }
+
+    auto choice_configs = [&](DependenceAnalysis &analysis, size_t begin, size_t stride) {
+        vector<GroupConfig> result;
+        for (size_t i = begin; i < to_eval.size(); i += stride) {
+            result.push_back(evaluate_choice(to_eval[i], level, analysis));
+        }
+        return result;
+    };
+    vector<GroupConfig> configs =
+        map_with_analyses<GroupConfig>(dep_analysis, worker_analyses, to_eval.size(), choice_configs);
+
+    // Cache the result of the evaluation for each pair
+    for (size_t i = 0; i < to_eval.size(); i++) {
+        grouping_cache.emplace(to_eval[i], configs[i]);
+    }
+
+    // The beneficial groupings seen so far, ordered by decreasing benefit.
+    vector<vector<pair<GroupingChoice, GroupConfig>>> best_groupings;
+    vector<Expr> best_benefits;
     for (const auto &p : cands) {
         // Compute the aggregate benefit of inlining into all the children.
         vector<pair<GroupingChoice, GroupConfig>> grouping;
@@ -1430,20 +1912,8 @@ Partitioner::choose_candidate_grouping(const vector<pair<string, string>> &cands
         FStage prod(prod_f, final_stage);
 
         for (const FStage &c : get_element(children, prod)) {
-            GroupConfig best_config;
             GroupingChoice cand_choice(prod_f.name(), c);
-
-            // Check if the candidate has been evaluated for grouping before
-            const auto &iter = grouping_cache.find(cand_choice);
-            if (iter != grouping_cache.end()) {
-                best_config = iter->second;
-            } else {
-                best_config = evaluate_choice(cand_choice, level);
-                // Cache the result of the evaluation for the pair
-                grouping_cache.emplace(cand_choice, best_config);
-            }
-
-            grouping.push_back(make_pair(cand_choice, best_config));
+            grouping.push_back(make_pair(cand_choice, get_element(grouping_cache, cand_choice)));
         }
 
         bool no_redundant_work = false;
@@ -1454,23 +1924,38 @@ Partitioner::choose_candidate_grouping(const vector<pair<string, string>> &cands
             debug(3) << "  " << g.first;
         }
         debug(3) << "Candidate benefit: " << overall_benefit << '\n';
+        if (!overall_benefit.defined() || !can_prove(overall_benefit > 0)) {
+            continue;
+        }
+        // Insert the grouping ahead of the first grouping it is provably
+        // better than, so that the earliest of several choices with equal
+        // benefits is ranked first.
         // TODO: The grouping process can be non-deterministic when the costs
         // of two choices are equal
-        if (overall_benefit.defined() && can_prove(best_benefit < overall_benefit)) {
-            best_grouping = grouping;
-            best_benefit = overall_benefit;
+        size_t pos = 0;
+        while ((pos < best_benefits.size()) &&
+               !can_prove(best_benefits[pos] < overall_benefit)) {
+            pos++;
+        }
+        if (pos < (size_t)max_choices) {
+            best_groupings.insert(best_groupings.begin() + pos, grouping);
+            best_benefits.insert(best_benefits.begin() + pos, overall_benefit);
+            if (best_groupings.size() > (size_t)max_choices) {
+                best_groupings.pop_back();
+                best_benefits.pop_back();
+            }
         }
     }
 
     debug(3) << "\nBest grouping:\n";
-    for (const auto &g : best_grouping) {
-        debug(3) << "  " << g.first;
-    }
-    if (best_grouping.size() > 0) {
-        debug(3) << "Best benefit: " << best_benefit << '\n';
+    if (best_groupings.size() > 0) {
+        for (const auto &g : best_groupings[0]) {
+            debug(3) << "  " << g.first;
+        }
+        debug(3) << "Best benefit: " << best_benefits[0] << '\n';
     }
 
-    return best_grouping;
+    return best_groupings;
 }
 
 inline bool operator==(const map<string, Expr> &m1, const map<string, Expr> &m2) {
@@ -1584,14 +2069,14 @@ vector<map<string, Expr>> Partitioner::generate_tile_configs(const FStage &stg)
 }
 
 pair<map<string, Expr>, Partitioner::GroupAnalysis>
-Partitioner::find_best_tile_config(const Group &g) {
+Partitioner::find_best_tile_config(const Group &g, DependenceAnalysis &analysis) {
     // Initialize to no tiling
     map<string, Expr> no_tile_config;
     Group no_tile = g;
     no_tile.tile_sizes = no_tile_config;
 
     bool show_analysis = false;
-    GroupAnalysis no_tile_analysis = analyze_group(no_tile, show_analysis);
+    GroupAnalysis no_tile_analysis = analyze_group(no_tile, show_analysis, analysis);
 
     GroupAnalysis best_analysis = no_tile_analysis;
     map<string, Expr> best_config = no_tile_config;
@@ -1607,7 +2092,7 @@ Partitioner::find_best_tile_config(const Group &g) {
         Group new_group = g;
         new_group.tile_sizes = config;
 
-        GroupAnalysis new_analysis = analyze_group(new_group, show_analysis);
+        GroupAnalysis new_analysis = analyze_group(new_group, show_analysis, analysis);
 
         bool no_redundant_work = false;
         Expr benefit = estimate_benefit(best_analysis, new_analysis,
@@ -1632,57 +2117,126 @@ Partitioner::find_best_tile_config(const Group &g) {
     return make_pair(best_config, best_analysis);
 }
 
-void Partitioner::group(Partitioner::Level level) {
-    bool fixpoint = false;
-    while (!fixpoint) {
-        Cost pre_merge = get_pipeline_cost();
-
-        fixpoint = true;
-        vector<pair<string, string>> cand;
-        for (const pair<FStage, Group> &g : groups) {
-            bool is_output = false;
-            for (const Function &f : outputs) {
-                if (g.first.func.name() == f.name()) {
-                    is_output = true;
-                    break;
-                }
+vector<pair<string, string>> Partitioner::grouping_candidates(Partitioner::Level level) {
+    vector<pair<string, string>> cand;
+    for (const pair<FStage, Group> &g : groups) {
+        bool is_output = false;
+        for (const Function &f : outputs) {
+            if (g.first.func.name() == f.name()) {
+                is_output = true;
+                break;
             }
+        }
+
+        // All stages of a function are computed at a single location.
+        // The last stage of the function represents the candidate choice
+        // of grouping the function into a consumer.
 
-            // All stages of a function are computed at a single location.
-            // The last stage of the function represents the candidate choice
-            // of grouping the function into a consumer.
+        const Function &prod_f = get_element(dep_analysis.env, g.first.func.name());
+        bool is_final_stage = (g.first.stage_num == prod_f.updates().size());
 
-            const Function &prod_f = get_element(dep_analysis.env, g.first.func.name());
-            bool is_final_stage = (g.first.stage_num == prod_f.updates().size());
+        // Extern stages are opaque: they are computed at root in groups of
+        // their own.
+        if (is_output || !is_final_stage || prod_f.has_extern_definition()) {
+            continue;
+        }
 
-            if (is_output || !is_final_stage) {
+        const auto &iter = children.find(g.first);
+        if (iter != children.end()) {
+            // All the stages belonging to a function are considered to be a
+            // single child.
+            set<string> child_groups;
+            bool extern_child = false;
+            for (const FStage &s : iter->second) {
+                child_groups.insert(s.func.name());
+                extern_child = extern_child || s.func.has_extern_definition();
+            }
+            // A function consumed by an extern stage can neither be inlined
+            // nor be computed within a tile of it.
+            if (extern_child) {
                 continue;
             }
 
-            const auto &iter = children.find(g.first);
-            if (iter != children.end()) {
-                // All the stages belonging to a function are considered to be a
-                // single child.
-                set<string> child_groups;
-                for (const FStage &s : iter->second) {
-                    child_groups.insert(s.func.name());
-                }
+            int num_children = child_groups.size();
+            // Only groups with a single child are considered for grouping
+            // when grouping for computing in tiles.
+            // TODO: The current scheduling model does not allow functions
+            // to be computed at different points.
+            if ((num_children == 1) && (level == Partitioner::Level::FastMem)) {
+                const string &prod_name = prod_f.name();
+                const string &cons_name = (*child_groups.begin());
+                cand.push_back(make_pair(prod_name, cons_name));
+            } else if((level == Partitioner::Level::Inline) && prod_f.is_pure()) {
+                const string &prod_name = prod_f.name();
+                cand.push_back(make_pair(prod_name, ""));
+            }
+        }
+    }
+    return cand;
+}
 
-                int num_children = child_groups.size();
-                // Only groups with a single child are considered for grouping
-                // when grouping for computing in tiles.
-                // TODO: The current scheduling model does not allow functions
-                // to be computed at different points.
-                if ((num_children == 1) && (level == Partitioner::Level::FastMem)) {
-                    const string &prod_name = prod_f.name();
-                    const string &cons_name = (*child_groups.begin());
-                    cand.push_back(make_pair(prod_name, cons_name));
-                } else if((level == Partitioner::Level::Inline) && prod_f.is_pure()) {
-                    const string &prod_name = prod_f.name();
-                    cand.push_back(make_pair(prod_name, ""));
-                }
+void Partitioner::apply_grouping(const vector<pair<GroupingChoice, GroupConfig>> &best,
+                                 Partitioner::Level level) {
+    // The following code makes the assumption that all the stages of a function
+    // will be in the same group. 'choose_candidate_grouping' ensures that the
+    // grouping choice being returned adheres to this constraint.
+    const string &prod = best[0].first.prod;
+
+    const Function &prod_f = get_element(dep_analysis.env, prod);
+    size_t num_stages = prod_f.updates().size() + 1;
+
+    FStage final_stage(prod_f, num_stages - 1);
+    set<FStage> prod_group_children = get_element(children, final_stage);
+
+    // Invalidate entries of the grouping cache
+    set<GroupingChoice> invalid_keys;
+    for (const auto &c : prod_group_children) {
+        for (const auto &entry : grouping_cache) {
+            if ((entry.first.prod == c.func.name()) || (entry.first.cons == c)) {
+                invalid_keys.insert(entry.first);
+            }
+        }
+    }
+    for (const auto &key : invalid_keys) {
+        grouping_cache.erase(key);
+    }
+
+    for (const auto &group : best) {
+        internal_assert(group.first.prod == prod);
+        merge_groups(group.first, group.second, level);
+    }
+
+    for (size_t s = 0; s < num_stages; s++) {
+        FStage prod_group(prod_f, s);
+        groups.erase(prod_group);
+        group_costs.erase(prod_group);
+
+        // Update the children mapping
+        children.erase(prod_group);
+        for (auto &f : children) {
+            set<FStage> &cons = f.second;
+            auto iter = cons.find(prod_group);
+            if (iter != cons.end()) {
+                cons.erase(iter);
+                // For a function with multiple stages, all the stages will
+                // be in the same group and the consumers of the function
+                // only depend on the last stage. Therefore, when the
+                // producer group has multiple stages, parents of the
+                // producers should point to the consumers of the last
+                // stage of the producer.
+                cons.insert(prod_group_children.begin(), prod_group_children.end());
             }
         }
+    }
+}
+
+void Partitioner::group(Partitioner::Level level) {
+    bool fixpoint = false;
+    while (!fixpoint) {
+        Cost pre_merge = get_pipeline_cost();
+
+        fixpoint = true;
+        vector<pair<string, string>> cand = grouping_candidates(level);
 
         debug(3) << "\n============================" << '\n';
         debug(3) << "Current grouping candidates:" << '\n';
@@ -1698,62 +2252,152 @@ void Partitioner::group(Partitioner::Level level) {
             fixpoint = false;
         }
 
-        // The following code makes the assumption that all the stages of a function
-        // will be in the same group. 'choose_candidate_grouping' ensures that the
-        // grouping choice being returned adheres to this constraint.
-        const string &prod = best[0].first.prod;
+        apply_grouping(best, level);
 
-        const Function &prod_f = get_element(dep_analysis.env, prod);
-        size_t num_stages = prod_f.updates().size() + 1;
+        Cost post_merge = get_pipeline_cost();
+        if (debug::debug_level() >= 3) {
+            disp_pipeline_costs();
+        }
+    }
+}
 
-        FStage final_stage(prod_f, num_stages - 1);
-        set<FStage> prod_group_children = get_element(children, final_stage);
+void Partitioner::group_beam_search(Partitioner::Level level, int beam_width,
+                                    double time_budget) {
+    internal_assert(beam_width > 0);
+    auto start = std::chrono::steady_clock::now();
+
+    // A partition in the beam, its estimated cost, and whether there is any
+    // beneficial grouping left to do in it.
+    struct BeamEntry {
+        Partitioner part;
+        int64_t cost;
+        bool done;
+        BeamEntry(const Partitioner &part, int64_t cost, bool done)
+            : part(part), cost(cost), done(done) {}
+    };
 
-        // Invalidate entries of the grouping cache
-        set<GroupingChoice> invalid_keys;
-        for (const auto &c : prod_group_children) {
-            for (const auto &entry : grouping_cache) {
-                if ((entry.first.prod == c.func.name()) || (entry.first.cons == c)) {
-                    invalid_keys.insert(entry.first);
-                }
+    auto total_cost = [](Partitioner &part) {
+        Cost c = part.get_pipeline_cost();
+        if (c.defined()) {
+            const int64_t *i = as_const_int(simplify(c.arith + c.memory));
+            if (i) {
+                return *i;
             }
         }
-        for (const auto &key : invalid_keys) {
-            grouping_cache.erase(key);
-        }
+        return std::numeric_limits<int64_t>::max();
+    };
 
-        for (const auto &group : best) {
-            internal_assert(group.first.prod == prod);
-            merge_groups(group.first, group.second, level);
+    // Different merge orders often lead to the same partition; identify
+    // partitions by their groups so that the beam does not hold duplicates.
+    auto signature = [](const Partitioner &part) {
+        std::ostringstream ss;
+        for (const auto &g : part.groups) {
+            ss << g.second;
         }
+        return ss.str();
+    };
 
-        for (size_t s = 0; s < num_stages; s++) {
-            FStage prod_group(prod_f, s);
-            groups.erase(prod_group);
-            group_costs.erase(prod_group);
+    // Each beam slot has its own dependence analysis, so that the slots can
+    // be expanded concurrently.
+    vector<std::unique_ptr<DependenceAnalysis>> analyses;
+    for (int i = 0; i < beam_width; i++) {
+        analyses.emplace_back(new DependenceAnalysis(dep_analysis.env, dep_analysis.order,
+                                                     dep_analysis.func_val_bounds));
+    }
+
+    // Use a single thread when debugging, so that the debug output of the
+    // different slots is not interleaved.
+    size_t num_threads = (debug::debug_level() > 0) ? 1 : ThreadPool<void>::num_processors_online();
+    num_threads = std::max((size_t)1, std::min(num_threads, (size_t)beam_width));
+    ThreadPool<vector<BeamEntry>> pool(num_threads);
+
+    vector<BeamEntry> beam;
+    beam.emplace_back(*this, total_cost(*this), false);
+    int width = beam_width;
+    int step = 0;
+    while (true) {
+        if ((width > 1) && (time_budget > 0)) {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed.count() > time_budget) {
+                debug(1) << "Auto-scheduler beam search ran out of time after "
+                         << step << " steps; continuing greedily\n";
+                width = 1;
+            }
+        }
 
-            // Update the children mapping
-            children.erase(prod_group);
-            for (auto &f : children) {
-                set<FStage> &cons = f.second;
-                auto iter = cons.find(prod_group);
-                if (iter != cons.end()) {
-                    cons.erase(iter);
-                    // For a function with multiple stages, all the stages will
-                    // be in the same group and the consumers of the function
-                    // only depend on the last stage. Therefore, when the
-                    // producer group has multiple stages, parents of the
-                    // producers should point to the consumers of the last
-                    // stage of the producer.
-                    cons.insert(prod_group_children.begin(), prod_group_children.end());
+        // Expand every partition in the beam by each of its 'width' best
+        // grouping choices.
+        vector<std::future<vector<BeamEntry>>> futures;
+        for (size_t i = 0; i < beam.size(); i++) {
+            if (beam[i].done) {
+                continue;
+            }
+            futures.push_back(pool.async([&, i]() {
+                Partitioner part(beam[i].part, *analyses[i]);
+                vector<pair<string, string>> cand = part.grouping_candidates(level);
+                vector<vector<pair<GroupingChoice, GroupConfig>>> choices =
+                    part.choose_candidate_groupings(cand, level, width);
+                vector<BeamEntry> expanded;
+                if (choices.empty()) {
+                    expanded.emplace_back(part, beam[i].cost, true);
+                }
+                for (const auto &choice : choices) {
+                    Partitioner next(part);
+                    next.apply_grouping(choice, level);
+                    expanded.emplace_back(next, total_cost(next), false);
                 }
+                return expanded;
+            }));
+        }
+        if (futures.empty()) {
+            break;
+        }
+
+        vector<BeamEntry> candidates;
+        for (const BeamEntry &e : beam) {
+            if (e.done) {
+                candidates.push_back(e);
+            }
+        }
+        for (auto &f : futures) {
+            for (const BeamEntry &e : f.get()) {
+                candidates.push_back(e);
             }
         }
 
-        Cost post_merge = get_pipeline_cost();
-        if (debug::debug_level() >= 3) {
-            disp_pipeline_costs();
+        // Keep the 'width' lowest cost distinct partitions. Ties are broken
+        // in favor of the better choices from the better partitions, which
+        // come first.
+        vector<size_t> ranked(candidates.size());
+        for (size_t i = 0; i < ranked.size(); i++) {
+            ranked[i] = i;
+        }
+        std::stable_sort(ranked.begin(), ranked.end(), [&](size_t a, size_t b) {
+            return candidates[a].cost < candidates[b].cost;
+        });
+        beam.clear();
+        set<string> seen;
+        for (size_t i : ranked) {
+            if ((int)beam.size() == width) {
+                break;
+            }
+            if (seen.insert(signature(candidates[i].part)).second) {
+                beam.push_back(candidates[i]);
+            }
         }
+
+        step++;
+        debug(3) << "Beam search step " << step << ": best cost " << beam[0].cost << '\n';
+    }
+
+    const Partitioner &best = beam[0].part;
+    grouping_cache = best.grouping_cache;
+    groups = best.groups;
+    children = best.children;
+    group_costs = best.group_costs;
+
+    if (debug::debug_level() >= 3) {
+        disp_pipeline_costs();
     }
 }
 
@@ -1771,6 +2415,11 @@ DimBounds Partitioner::get_bounds(const FStage &s) {
 
 DimBounds Partitioner::get_bounds_from_tile_sizes(const FStage &s,
                                                   const map<string, Expr> &tile_sizes) {
+    if (s.func.has_extern_definition()) {
+        // Extern stages have no loops to tile.
+        return get_bounds(s);
+    }
+
     Definition def = get_stage_definition(s.func, s.stage_num);
     map<string, Interval> bounds;
 
@@ -1803,7 +2452,8 @@ DimBounds Partitioner::get_bounds_from_tile_sizes(const FStage &s,
     return bounds;
 }
 
-Partitioner::GroupAnalysis Partitioner::analyze_group(const Group &g, bool show_analysis) {
+Partitioner::GroupAnalysis Partitioner::analyze_group(const Group &g, bool show_analysis,
+                                                      DependenceAnalysis &analysis) {
     // Get the definition corresponding to the group output
     Definition def = get_stage_definition(g.output.func, g.output.stage_num);
 
@@ -1858,10 +2508,10 @@ Partitioner::GroupAnalysis Partitioner::analyze_group(const Group &g, bool show_
     // Get the regions of the pipeline required to compute a tile of the group
     DimBounds tile_bounds = get_bounds_from_tile_sizes(g.output, g.tile_sizes);
 
-    map<string, Box> alloc_regions = dep_analysis.regions_required(
+    map<string, Box> alloc_regions = analysis.regions_required(
         g.output.func, g.output.stage_num, tile_bounds, group_members, false, &costs.input_estimates);
 
-    map<string, Box> compute_regions = dep_analysis.regions_required(
+    map<string, Box> compute_regions = analysis.regions_required(
         g.output.func, g.output.stage_num, tile_bounds, group_members, true, &costs.input_estimates);
 
     map<string, Box> group_reg, prod_reg, input_reg;
@@ -1950,10 +2600,12 @@ Partitioner::GroupAnalysis Partitioner::analyze_group(const Group &g, bool show_
     // TODO: Use smooth step curve from Jon to better model cache behavior,
     // where each step corresponds to different cache level.
     //
-    // The current cost model drops off linearly. Larger memory footprint is
-    // penalized more than smaller memory footprint (since smaller one can fit
-    // more in the cache). The cost is clamped at 'balance', which is roughly at
-    // memory footprint equal to or larger than the last level cache size.
+    // The current cost model drops off linearly (piecewise linearly, with
+    // one segment per cache level, if the machine has a cache hierarchy).
+    // Larger memory footprint is penalized more than smaller memory footprint
+    // (since smaller one can fit more in the cache). The cost is clamped at
+    // 'balance', which is roughly at memory footprint equal to or larger than
+    // the last level cache size.
 
     // If 'model_reuse' is set, the cost model should take into account memory
     // reuse within the tile, e.g. matrix multiply reuses inputs multiple times.
@@ -1962,6 +2614,24 @@ Partitioner::GroupAnalysis Partitioner::analyze_group(const Group &g, bool show_
 
     // Linear dropoff
     Expr load_slope = cast<float>(arch_params.balance) / arch_params.last_level_cache_size;
+    auto load_cost_factor = [&](const Expr &footprint) {
+        if (!arch_params.has_cache_hierarchy()) {
+            return cast<int64_t>(min(1 + footprint * load_slope, arch_params.balance));
+        }
+        // With a cache hierarchy, loads are as cheap as arithmetic while the
+        // footprint fits in L1, then the cost rises linearly to 'l2_balance'
+        // as the footprint reaches the L2 size, and to 'balance' at the last
+        // level cache size.
+        Expr f = cast<float>(footprint);
+        Expr l1 = cast<float>(arch_params.l1_cache_size);
+        Expr l2 = cast<float>(arch_params.l2_cache_size);
+        Expr llc = cast<float>(arch_params.last_level_cache_size);
+        Expr l2_bal = cast<float>(arch_params.l2_balance);
+        Expr bal = cast<float>(arch_params.balance);
+        Expr factor = 1.0f + max(min(f, l2) - l1, 0.0f) * (l2_bal - 1.0f) / max(l2 - l1, 1.0f) +
+            max(min(f, llc) - l2, 0.0f) * (bal - l2_bal) / max(llc - l2, 1.0f);
+        return cast<int64_t>(min(factor, bal));
+    };
     for (const auto &f_load : group_load_costs) {
         internal_assert(g.inlined.find(f_load.first) == g.inlined.end())
             << "Intermediates of inlined pure fuction \"" << f_load.first
@@ -2003,8 +2673,7 @@ Partitioner::GroupAnalysis Partitioner::analyze_group(const Group &g, bool show_
             }
 
             if (model_reuse) {
-                Expr initial_factor =
-                    cast<int64_t>(min(1 + initial_footprint * load_slope, arch_params.balance));
+                Expr initial_factor = load_cost_factor(initial_footprint);
                 per_tile_cost.memory += initial_factor * footprint;
             } else {
                 footprint = initial_footprint;
@@ -2015,7 +2684,7 @@ Partitioner::GroupAnalysis Partitioner::analyze_group(const Group &g, bool show_
             }
         }
 
-        Expr cost_factor = cast<int64_t>(min(1 + footprint * load_slope, arch_params.balance));
+        Expr cost_factor = load_cost_factor(footprint);
         per_tile_cost.memory += cost_factor * f_load.second;
     }
 
@@ -2095,7 +2764,8 @@ void Partitioner::merge_groups(const GroupingChoice &choice, const GroupConfig &
 }
 
 Partitioner::GroupConfig Partitioner::evaluate_choice(const GroupingChoice &choice,
-                                                      Partitioner::Level level) {
+                                                      Partitioner::Level level,
+                                                      DependenceAnalysis &analysis) {
     // Create a group that reflects the grouping choice and evaluate the cost
     // of the group.
     const Function &prod_f = get_element(dep_analysis.env, choice.prod);
@@ -2140,11 +2810,11 @@ Partitioner::GroupConfig Partitioner::evaluate_choice(const GroupingChoice &choi
             group.inlined.insert(f);
         }
 
-        group_analysis = analyze_group(group, false);
+        group_analysis = analyze_group(group, false, analysis);
         best_tile_config = tile_sizes;
 
     } else {
-        pair<map<string, Expr>, GroupAnalysis> config = find_best_tile_config(group);
+        pair<map<string, Expr>, GroupAnalysis> config = find_best_tile_config(group, analysis);
         best_tile_config = config.first;
         group_analysis = config.second;
     }
@@ -2630,6 +3300,63 @@ void Partitioner::reorder_dims(Stage f_handle, int stage_num, Definition def,
     }
 }
 
+// Visitor to find out whether a function (or any function it calls) depends
+// on a buffer, a handle, an extern stage, or a call with side effects (such
+// as an extern function that isn't PureExtern), which rule out memoization.
+class FindNonScalarDependencies : public IRGraphVisitor {
+    using IRGraphVisitor::visit;
+
+    set<string> visited;
+
+    void check(const Parameter &p) {
+        if (p.defined() && (p.is_buffer() || p.type().is_handle())) {
+            found = true;
+        }
+    }
+
+    void visit(const Call *call) {
+        check(call->param);
+        if ((call->call_type != Call::Halide) && !call->is_pure()) {
+            // The result may not be the same every time, or the call may
+            // have effects which would be skipped on a cache hit.
+            found = true;
+        }
+        if (call->image.defined()) {
+            // The contents of a concrete buffer may change between
+            // invocations of the pipeline without changing the cache key.
+            found = true;
+        }
+        if (call->func.defined()) {
+            visit_function(Function(call->func));
+        }
+        IRGraphVisitor::visit(call);
+    }
+
+    void visit(const Load *load) {
+        check(load->param);
+        IRGraphVisitor::visit(load);
+    }
+
+    void visit(const Variable *var) {
+        check(var->param);
+        IRGraphVisitor::visit(var);
+    }
+
+public:
+    bool found = false;
+
+    void visit_function(const Function &f) {
+        if (!visited.insert(f.name()).second) {
+            return;
+        }
+        if (f.has_extern_definition()) {
+            found = true;
+            return;
+        }
+        f.accept(this);
+    }
+};
+
 // Visitor to find all the variables the depend on a variable.
 class FindVarsUsingVar : public IRVisitor {
     using IRVisitor::visit;
@@ -2653,6 +3380,8 @@ void Partitioner::generate_group_cpu_schedule(
         const Group &g, const Target &t,
         const map<FStage, DimBounds> &group_loop_bounds,
         const map<string, Box> &group_storage_bounds,
+        const map<string, Expr> &l1_tile_sizes,
+        const set<string> &sliding_dims,
         const set<string> &inlines,
         AutoSchedule &sched) {
     string out_f_name = g.output.func.name();
@@ -2679,6 +3408,11 @@ void Partitioner::generate_group_cpu_schedule(
     } else {
         Func(g_out).compute_root();
         sched.push_schedule(f_handle.name(), g.output.stage_num, "compute_root()", {});
+
+        if (should_memoize(g)) {
+            Func(g_out).memoize();
+            sched.push_schedule(f_handle.name(), g.output.stage_num, "memoize()", {});
+        }
     }
 
     if (g.output.func.has_extern_definition()) {
@@ -2688,6 +3422,9 @@ void Partitioner::generate_group_cpu_schedule(
 
     // Realize tiling and update the dimension estimates
     vector<VarOrRVar> outer_dims;
+    // The dimension of the output each of the outer dimensions iterates over.
+    map<string, string> outer_dim_vars;
+    vector<VarOrRVar> sub_tile_dims;
     vector<VarOrRVar> inner_dims;
 
     // 'dims' will get modified since we are going to apply the schedules
@@ -2713,6 +3450,19 @@ void Partitioner::generate_group_cpu_schedule(
         }
     }
 
+    bool rfactored = (g.output.stage_num > 0) &&
+        rfactor_stage(g, f_handle, def, stg_estimates, sched);
+    if (rfactored) {
+        // The stage now only merges the partial reductions; its RVars
+        // have changed.
+        rvars.clear();
+        for (int d = 0; d < (int)dims.size() - 1; d++) {
+            if (dims[d].is_rvar()) {
+                rvars.insert(get_base_name(dims[d].var));
+            }
+        }
+    }
+
     vector<string> dim_vars(dims.size() - 1);
     for (int d = 0; d < (int)dims.size() - 1; d++) {
         dim_vars[d] = get_base_name(dims[d].var);
@@ -2730,19 +3480,40 @@ void Partitioner::generate_group_cpu_schedule(
             const Expr &tile_size = iter->second;
             if (can_prove(tile_size == 1)) {
                 outer_dims.push_back(v);
+                outer_dim_vars[v.name()] = var;
             } else {
                 pair<VarOrRVar, VarOrRVar> tile_vars =
                     split_dim(g, f_handle, g.output.stage_num, def, true, v,
                               tile_size, "_i", "_o", stg_estimates, sched);
 
-                inner_dims.push_back(tile_vars.first);
                 outer_dims.push_back(tile_vars.second);
+                outer_dim_vars[tile_vars.second.name()] = var;
 
                 if (is_rvar) {
                     rvars.erase(var);
                     rvars.insert(tile_vars.first.name());
                     rvars.insert(tile_vars.second.name());
                 }
+
+                // Split the tile further into sub-tiles which fit in L1.
+                const auto &l1_iter = l1_tile_sizes.find(var);
+                if (l1_iter != l1_tile_sizes.end()) {
+                    pair<VarOrRVar, VarOrRVar> sub_tile_vars =
+                        split_dim(g, f_handle, g.output.stage_num, def, true,
+                                  tile_vars.first, l1_iter->second, "_i", "_o",
+                                  stg_estimates, sched);
+
+                    inner_dims.push_back(sub_tile_vars.first);
+                    sub_tile_dims.push_back(sub_tile_vars.second);
+
+                    if (is_rvar) {
+                        rvars.erase(tile_vars.first.name());
+                        rvars.insert(sub_tile_vars.first.name());
+                        rvars.insert(sub_tile_vars.second.name());
+                    }
+                } else {
+                    inner_dims.push_back(tile_vars.first);
+                }
             }
         } else {
             inner_dims.push_back(v);
@@ -2756,6 +3527,9 @@ void Partitioner::generate_group_cpu_schedule(
         for (const auto &v : inner_dims) {
             ordering.push_back(v);
         }
+        for (const auto &v : sub_tile_dims) {
+            ordering.push_back(v);
+        }
         for (const auto &v : outer_dims) {
             ordering.push_back(v);
         }
@@ -2831,7 +3605,9 @@ void Partitioner::generate_group_cpu_schedule(
         }
     }
 
-    if (can_prove(def_par < arch_params.parallelism)) {
+    // The partial reductions of a rfactored stage are computed in parallel;
+    // merging them is cheap.
+    if (!rfactored && can_prove(def_par < arch_params.parallelism)) {
         user_warning << "Insufficient parallelism for " << f_handle.name() << '\n';
     }
 
@@ -2844,6 +3620,19 @@ void Partitioner::generate_group_cpu_schedule(
         tile_inner_var = VarOrRVar(var_name, is_rvar);
     }
 
+    // Store the members for a whole strip of tiles at the next outer tile
+    // loop if the sliding window optimization is worth it. That requires
+    // the tiles in the strip to be computed in order.
+    VarOrRVar store_var("", false);
+    if ((outer_dims.size() > 1) && !tile_inner_var.is_rvar &&
+        (dims[tile_inner_index].for_type == ForType::Serial) &&
+        !dims[tile_inner_index + 1].is_rvar()) {
+        const auto &iter = outer_dim_vars.find(tile_inner_var.name());
+        if ((iter != outer_dim_vars.end()) && sliding_dims.count(iter->second)) {
+            store_var = VarOrRVar(get_base_name(dims[tile_inner_index + 1].var), false);
+        }
+    }
+
     for (const FStage &mem : g.members) {
         // Skip member stages that have been inlined or stage that is the
         // output stage of the group
@@ -2883,6 +3672,12 @@ void Partitioner::generate_group_cpu_schedule(
                 sched.push_schedule(mem_handle.name(), mem.stage_num,
                                     "compute_at(" + sanitized_g_out + ", " + tile_inner_var.name() + ")",
                                     {sanitized_g_out, tile_inner_var.name()});
+                if (!store_var.name().empty()) {
+                    Func(mem.func).store_at(Func(g_out), store_var.var);
+                    sched.push_schedule(mem_handle.name(), mem.stage_num,
+                                        "store_at(" + sanitized_g_out + ", " + store_var.name() + ")",
+                                        {sanitized_g_out, store_var.name()});
+                }
             } else {
                 user_warning << "Degenerate tiling. No dimensions are tiled" << '\n';
                 user_warning << "Computing \"" <<  mem.func.name() << "\" at root" << '\n';
@@ -2906,11 +3701,330 @@ void Partitioner::generate_group_cpu_schedule(
     }
 }
 
+bool Partitioner::should_slide(const Group &g, const string &slide_dim) {
+    Function g_out = g.output.func;
+    // Sliding window only applies to pure functions, and the loops of the
+    // output are only known for its pure definition.
+    if ((g.output.stage_num != 0) || !g_out.updates().empty()) {
+        return false;
+    }
+
+    set<string> members, prods;
+    for (const FStage &mem : g.members) {
+        if (mem.func.name() == g_out.name()) {
+            continue;
+        }
+        prods.insert(mem.func.name());
+        if (g.inlined.find(mem.func.name()) == g.inlined.end()) {
+            if (!mem.func.updates().empty()) {
+                return false;
+            }
+            members.insert(mem.func.name());
+        }
+    }
+    if (members.empty()) {
+        return false;
+    }
+
+    DimBounds tile_bounds = get_bounds_from_tile_sizes(g.output, g.tile_sizes);
+    DimBounds stg_bounds = get_bounds(g.output);
+    if ((tile_bounds.find(slide_dim) == tile_bounds.end()) ||
+        (stg_bounds.find(slide_dim) == stg_bounds.end())) {
+        return false;
+    }
+
+    // The work saved per tile: the regions of the members which the next
+    // tile along 'slide_dim' recomputes.
+    map<string, Box> overlaps = dep_analysis.redundant_regions(
+        g_out, 0, slide_dim, tile_bounds, prods, true, &costs.input_estimates);
+    Expr saved = make_zero(Int(64));
+    for (const string &m : members) {
+        const auto &iter = overlaps.find(m);
+        if (iter == overlaps.end()) {
+            continue;
+        }
+        Cost c = costs.region_cost(m, iter->second, g.inlined);
+        if (!c.defined()) {
+            return false;
+        }
+        saved += c.arith;
+    }
+    if (!can_prove(simplify(saved) > 0)) {
+        return false;
+    }
+
+    // The storage needed for a strip of tiles, should Halide not be able to
+    // fold it.
+    DimBounds strip_bounds = tile_bounds;
+    strip_bounds[slide_dim] = get_element(stg_bounds, slide_dim);
+    map<string, Box> strip_regions = dep_analysis.regions_required(
+        g_out, 0, strip_bounds, prods, false, &costs.input_estimates);
+    Expr strip_size = make_zero(Int(64));
+    for (const string &m : members) {
+        Expr size = costs.region_size(m, get_element(strip_regions, m));
+        if (!size.defined()) {
+            return false;
+        }
+        strip_size += size;
+    }
+    return can_prove(simplify(strip_size) <= arch_params.last_level_cache_size);
+}
+
+map<FStage, set<string>> Partitioner::group_sliding_dims() {
+    map<FStage, set<string>> sliding_dims;
+    for (const pair<const FStage, Group> &g : groups) {
+        set<string> &dims = sliding_dims[g.first];
+        for (const auto &tile : g.second.tile_sizes) {
+            if (should_slide(g.second, tile.first)) {
+                dims.insert(tile.first);
+            }
+        }
+    }
+    return sliding_dims;
+}
+
+bool Partitioner::should_memoize(const Group &g) {
+    Function g_out = g.output.func;
+    for (const Function &f : outputs) {
+        if (f.name() == g_out.name()) {
+            return false;
+        }
+    }
+
+    FindNonScalarDependencies find;
+    find.visit_function(g_out);
+    if (find.found) {
+        return false;
+    }
+
+    // Memoization costs a cache lookup per invocation, and the runtime's
+    // cache holds 1MB by default; anything larger would be evicted before
+    // it could be reused.
+    const int memoize_min_cost = 1024;
+    const int memoize_max_size = 1024 * 1024;
+
+    const auto &cost_iter = group_costs.find(g.output);
+    if ((cost_iter == group_costs.end()) || !cost_iter->second.cost.defined() ||
+        !can_prove(cost_iter->second.cost.arith >= memoize_min_cost)) {
+        return false;
+    }
+    Expr size = costs.region_size(g_out.name(), get_element(pipeline_bounds, g_out.name()));
+    return size.defined() && can_prove(size <= memoize_max_size);
+}
+
+bool Partitioner::rfactor_stage(const Group &g, Stage f_handle, Definition def,
+                                map<string, Expr> &estimates, AutoSchedule &sched) {
+    Function g_out = g.output.func;
+    int stage_num = g.output.stage_num;
+    internal_assert(stage_num > 0);
+
+    // The partial reductions are computed at root, so they can't consume
+    // members of the group which are computed within the tiles of the output.
+    for (const FStage &mem : g.members) {
+        if ((mem.func.name() != g_out.name()) &&
+            (g.inlined.find(mem.func.name()) == g.inlined.end())) {
+            return false;
+        }
+    }
+
+    const int64_t *parallelism = as_const_int(simplify(arch_params.parallelism));
+    if (!parallelism) {
+        return false;
+    }
+
+    const vector<Dim> &dims = def.schedule().dims();
+    int64_t pure_par = 1;
+    int outer_rvar = -1;
+    for (int d = 0; d < (int)dims.size() - 1; d++) {
+        string var = get_base_name(dims[d].var);
+        if (dims[d].is_rvar()) {
+            if (can_parallelize_rvar(var, g_out.name(), def)) {
+                // The RVar will be parallelized directly.
+                return false;
+            }
+            outer_rvar = d;
+        } else {
+            const auto &iter = estimates.find(var);
+            const int64_t *extent = (iter != estimates.end()) && iter->second.defined() ?
+                as_const_int(simplify(iter->second)) : nullptr;
+            if (!extent) {
+                return false;
+            }
+            pure_par *= *extent;
+        }
+    }
+    if ((outer_rvar < 0) || (pure_par >= *parallelism)) {
+        return false;
+    }
+
+    string rvar = get_base_name(dims[outer_rvar].var);
+    const auto &iter = estimates.find(rvar);
+    const int64_t *extent = (iter != estimates.end()) && iter->second.defined() ?
+        as_const_int(simplify(iter->second)) : nullptr;
+    // Split the RVar into enough pieces to saturate the machine, but only
+    // if each of them still does a reasonable amount of work.
+    const int64_t min_partial_extent = 64;
+    int64_t num_partials = (*parallelism + pure_par - 1) / pure_par;
+    if (!extent || (*extent < num_partials * min_partial_extent)) {
+        return false;
+    }
+
+    if (!prove_associativity(g_out.name(), def.args(), def.values()).associative()) {
+        return false;
+    }
+
+    int64_t factor = (*extent + num_partials - 1) / num_partials;
+    pair<VarOrRVar, VarOrRVar> split_vars =
+        split_dim(g, f_handle, stage_num, def, true, VarOrRVar(rvar, true),
+                  (int)factor, "_i", "_o", estimates, sched);
+    const VarOrRVar &outer = split_vars.second;
+
+    string u_name = get_sanitized_name(outer.name()) + "_u";
+    if (sched.internal_vars.find(u_name) == sched.internal_vars.end()) {
+        sched.internal_vars.emplace(u_name, VarOrRVar(u_name, false));
+    }
+    Var u(u_name);
+
+    Func intm = f_handle.rfactor(outer.rvar, u);
+    sched.push_rfactor(f_handle.name(), stage_num, intm.name(),
+                       outer.name() + ", " + u_name, {outer.name(), u_name});
+
+    intm.compute_root();
+    sched.push_schedule(intm.name(), 0, "compute_root()", {});
+
+    // The partial reductions over different pieces of the RVar are
+    // independent of each other.
+    intm.update(0).parallel(u);
+    sched.push_schedule(intm.name(), 1, "parallel(" + u_name + ")", {u_name});
+
+    return true;
+}
+
+Expr Partitioner::tile_footprint(const Group &g, const map<string, Expr> &tile_sizes) {
+    DimBounds tile_bounds = get_bounds_from_tile_sizes(g.output, tile_sizes);
+
+    // Inlined members are recomputed within the tile, so look through them
+    // to the regions they load.
+    map<string, Box> regions = dep_analysis.regions_required(
+        g.output.func, g.output.stage_num, tile_bounds, g.inlined, false, &costs.input_estimates);
+
+    if (g.output.stage_num == 0) {
+        Box out_box;
+        for (const string &arg : g.output.func.args()) {
+            const auto &iter = tile_bounds.find(arg);
+            if (iter == tile_bounds.end()) {
+                return Expr();
+            }
+            out_box.push_back(iter->second);
+        }
+        merge_regions(regions, {{g.output.func.name(), out_box}});
+    }
+
+    Expr footprint = make_zero(Int(64));
+    for (const auto &reg : regions) {
+        if (g.inlined.find(reg.first) != g.inlined.end()) {
+            continue;
+        }
+        Expr size;
+        if (dep_analysis.env.find(reg.first) != dep_analysis.env.end()) {
+            size = costs.region_size(reg.first, reg.second);
+        } else {
+            size = costs.input_region_size(reg.first, reg.second);
+        }
+        if (!size.defined()) {
+            return Expr();
+        }
+        footprint += size;
+    }
+    return simplify(footprint);
+}
+
+map<FStage, map<string, Expr>> Partitioner::group_l1_tile_sizes() {
+    map<FStage, map<string, Expr>> l1_tiles;
+    for (const pair<const FStage, Group> &gpair : groups) {
+        const Group &g = gpair.second;
+        map<string, Expr> &sub_tile = l1_tiles[gpair.first];
+        if (!arch_params.has_cache_hierarchy() || g.tile_sizes.empty() ||
+            g.output.func.has_extern_definition()) {
+            continue;
+        }
+
+        // Only dimensions that are actually split into tiles (of constant
+        // size) can be sub-tiled; they are listed innermost first.
+        Definition def = get_stage_definition(g.output.func, g.output.stage_num);
+        const vector<Dim> &dims = def.schedule().dims();
+        DimBounds stg_bounds = get_bounds(g.output);
+        vector<string> tiled_vars;
+        map<string, Expr> sizes = g.tile_sizes;
+        for (int d = 0; d < (int)dims.size() - 1; d++) {
+            const string &var = dims[d].var;
+            const auto &iter = sizes.find(var);
+            if (iter == sizes.end()) {
+                continue;
+            }
+            Expr extent = get_extent(get_element(stg_bounds, var));
+            const int64_t *size = as_const_int(iter->second);
+            if (extent.defined() && size && (*size > 1) && can_prove(extent > iter->second)) {
+                tiled_vars.push_back(var);
+            }
+        }
+        if (tiled_vars.empty()) {
+            continue;
+        }
+
+        // Repeatedly halve the outermost tiled dimension which has the
+        // largest sub-tile until the footprint fits in L1. The innermost
+        // dimension is only halved once the others can't be, and is kept
+        // wide enough to vectorize.
+        const int64_t min_inner_size = 8;
+        bool changed = false;
+        while (true) {
+            Expr footprint = tile_footprint(g, sizes);
+            if (!footprint.defined() || can_prove(footprint <= arch_params.l1_cache_size)) {
+                break;
+            }
+            string to_halve;
+            int64_t largest = 1;
+            for (int i = (int)tiled_vars.size() - 1; i >= 0; i--) {
+                int64_t size = *as_const_int(get_element(sizes, tiled_vars[i]));
+                int64_t min_size = (i == 0) ? min_inner_size : 1;
+                if ((size / 2 >= min_size) && (size > largest) &&
+                    ((i > 0) || to_halve.empty())) {
+                    to_halve = tiled_vars[i];
+                    largest = size;
+                }
+            }
+            if (to_halve.empty()) {
+                break;
+            }
+            sizes[to_halve] = make_const(Int(32), largest / 2);
+            changed = true;
+        }
+        if (!changed) {
+            continue;
+        }
+        for (const string &var : tiled_vars) {
+            const Expr &size = get_element(sizes, var);
+            if (!can_prove(size == get_element(g.tile_sizes, var))) {
+                sub_tile[var] = size;
+            }
+        }
+        debug(3) << "L1 sub-tiles for " << g.output << ":";
+        for (const auto &iter : sub_tile) {
+            debug(3) << " (" << iter.first << ", " << iter.second << ")";
+        }
+        debug(3) << "\n";
+    }
+    return l1_tiles;
+}
+
 void Partitioner::generate_cpu_schedule(const Target &t, AutoSchedule &sched) {
     // Grab the group bounds early as they rely on the dimensions of the group
     // outputs which will be altered by modifying schedules.
     map<FStage, map<FStage, DimBounds>> loop_bounds = group_loop_bounds();
     map<FStage, map<string, Box>> storage_bounds = group_storage_bounds();
+    map<FStage, map<string, Expr>> l1_tiles = group_l1_tile_sizes();
+    map<FStage, set<string>> sliding_dims = group_sliding_dims();
 
     set<string> inlines;
     // Mark all functions that are inlined.
@@ -2931,7 +4045,387 @@ void Partitioner::generate_cpu_schedule(const Target &t, AutoSchedule &sched) {
     // Realize schedule for each group in the pipeline.
     for (const auto &g : groups) {
         generate_group_cpu_schedule(g.second, t, get_element(loop_bounds, g.first),
-                                    get_element(storage_bounds, g.first), inlines, sched);
+                                    get_element(storage_bounds, g.first),
+                                    get_element(l1_tiles, g.first),
+                                    get_element(sliding_dims, g.first), inlines, sched);
+    }
+}
+
+vector<int> Partitioner::pick_gpu_threads(const vector<Expr> &extents,
+                                          const vector<Expr> &block_tiles) {
+    internal_assert(!extents.empty() && (extents.size() <= 3));
+    internal_assert(extents.size() == block_tiles.size());
+
+    // Assume extents we can't resolve are large enough to never be the
+    // limiting factor.
+    const int64_t unknown_extent = 1 << 16;
+    auto const_extent = [&](const Expr &e) {
+        if (!e.defined()) {
+            return unknown_extent;
+        }
+        const int64_t *i = as_const_int(simplify(e));
+        return (i && (*i > 0)) ? *i : unknown_extent;
+    };
+    vector<int64_t> ext, tiles;
+    for (size_t d = 0; d < extents.size(); d++) {
+        ext.push_back(const_extent(extents[d]));
+        tiles.push_back(block_tiles[d].defined() ? const_extent(block_tiles[d]) : 0);
+    }
+
+    const int64_t *par = as_const_int(simplify(arch_params.parallelism));
+    const double min_blocks = (par && (*par > 0)) ? (double)*par : 16.0;
+
+    // Enumerate power-of-two thread tiles, in order of preference: 128
+    // threads per block first, then larger and smaller blocks, and with the
+    // innermost dimension (along which accesses coalesce) a warp wide where
+    // possible.
+    vector<vector<int>> candidates;
+    for (int total : {128, 256, 64, 32}) {
+        for (int x : {32, 64, 16, 128, 8, 256, 4, 2, 1}) {
+            if (x > total) {
+                continue;
+            }
+            if (extents.size() == 1) {
+                if (x == total) {
+                    candidates.push_back({x});
+                }
+                continue;
+            }
+            for (int y = total / x; y >= 1; y /= 2) {
+                if (extents.size() == 2) {
+                    if (x * y == total) {
+                        candidates.push_back({x, y});
+                    }
+                    continue;
+                }
+                int z = total / (x * y);
+                if ((z >= 1) && (x * y * z == total) && (z <= 64)) {
+                    candidates.push_back({x, y, z});
+                }
+            }
+        }
+    }
+
+    vector<int> best;
+    double best_score = 0;
+    for (const auto &cand : candidates) {
+        // Fraction of the launched threads doing useful work, and number of
+        // blocks launched.
+        double utilization = 1.0;
+        double blocks = 1.0;
+        for (size_t d = 0; d < cand.size(); d++) {
+            int64_t span = (tiles[d] > 0) ? std::min(tiles[d], ext[d]) : ext[d];
+            int64_t launched = ((span + cand[d] - 1) / cand[d]) * cand[d];
+            utilization *= (double)span / launched;
+            if (tiles[d] > 0) {
+                blocks *= (double)((ext[d] + tiles[d] - 1) / tiles[d]);
+            } else {
+                blocks *= (double)((ext[d] + cand[d] - 1) / cand[d]);
+            }
+        }
+        double occupancy = std::min(1.0, blocks / min_blocks);
+        double score = utilization * occupancy;
+        if (best.empty() || (score > best_score * 1.0001)) {
+            best = cand;
+            best_score = score;
+        }
+    }
+    internal_assert(!best.empty());
+    return best;
+}
+
+VarOrRVar Partitioner::gpu_tile_stage(
+        const Group &g, Stage f_handle, int stage_num, Definition def,
+        const string &func_name, bool is_group_output, bool map_blocks,
+        const map<string, Expr> &tile_sizes, set<string> &rvars,
+        map<string, Expr> &estimates, AutoSchedule &sched) {
+    vector<Dim> &dims = def.schedule().dims();
+
+    // Find the (at most three) innermost dimensions that can be run in
+    // parallel and have known extents.
+    vector<string> gpu_dims;
+    for (int d = 0; (d < (int)dims.size() - 1) && (gpu_dims.size() < 3); d++) {
+        string var = get_base_name(dims[d].var);
+        if ((rvars.find(var) != rvars.end()) &&
+            !can_parallelize_rvar(var, func_name, def)) {
+            continue;
+        }
+        const auto &iter = estimates.find(var);
+        if ((iter != estimates.end()) && iter->second.defined()) {
+            gpu_dims.push_back(var);
+        }
+    }
+    if (gpu_dims.empty()) {
+        return VarOrRVar("", false);
+    }
+
+    // Determine the block tile along each dimension. Dimensions with a block
+    // tile of one only get mapped to blocks.
+    vector<Expr> block_tiles(gpu_dims.size());
+    vector<Expr> thread_extents, thread_tiles;
+    for (size_t i = 0; i < gpu_dims.size(); i++) {
+        const Expr &est = get_element(estimates, gpu_dims[i]);
+        const auto &iter = tile_sizes.find(gpu_dims[i]);
+        if (map_blocks && (iter != tile_sizes.end()) && can_prove(est > iter->second)) {
+            block_tiles[i] = iter->second;
+        }
+        if (!block_tiles[i].defined() || !can_prove(block_tiles[i] == 1)) {
+            thread_extents.push_back(est);
+            // Without blocks, every thread tile lives within a single block.
+            thread_tiles.push_back(map_blocks ? block_tiles[i] : est);
+        }
+    }
+    vector<int> threads;
+    if (!thread_extents.empty()) {
+        threads = pick_gpu_threads(thread_extents, thread_tiles);
+    }
+
+    vector<VarOrRVar> block_vars, thread_vars;
+    size_t thread_index = 0;
+    for (size_t i = 0; i < gpu_dims.size(); i++) {
+        const string &var = gpu_dims[i];
+        bool is_rvar = (rvars.find(var) != rvars.end());
+        VarOrRVar v(var, is_rvar);
+
+        if (block_tiles[i].defined() && can_prove(block_tiles[i] == 1)) {
+            block_vars.push_back(v);
+            continue;
+        }
+
+        // The dimension iterated over by the threads of one block.
+        VarOrRVar inner = v;
+        if (block_tiles[i].defined()) {
+            pair<VarOrRVar, VarOrRVar> tile_vars =
+                split_dim(g, f_handle, stage_num, def, is_group_output, v,
+                          block_tiles[i], "_i", "_o", estimates, sched);
+            inner = tile_vars.first;
+            block_vars.push_back(tile_vars.second);
+            if (is_rvar) {
+                rvars.erase(var);
+                rvars.insert(tile_vars.first.name());
+                rvars.insert(tile_vars.second.name());
+            }
+        }
+
+        int num_threads = threads[thread_index++];
+        const Expr &inner_est = get_element(estimates, inner.name());
+        if (num_threads == 1) {
+            // Not worth a thread dimension; without a block tile, the whole
+            // dimension enumerates blocks.
+            if (map_blocks && !block_tiles[i].defined()) {
+                block_vars.push_back(inner);
+            }
+        } else if (can_prove(inner_est > num_threads)) {
+            pair<VarOrRVar, VarOrRVar> thread_split =
+                split_dim(g, f_handle, stage_num, def, is_group_output, inner,
+                          num_threads, "_ti", "_to", estimates, sched);
+            thread_vars.push_back(thread_split.first);
+            // Without a block tile, the outer part of the split enumerates
+            // the blocks. Otherwise it is a serial loop within each thread.
+            if (map_blocks && !block_tiles[i].defined()) {
+                block_vars.push_back(thread_split.second);
+            }
+            if (inner.is_rvar) {
+                rvars.erase(inner.name());
+                rvars.insert(thread_split.first.name());
+                rvars.insert(thread_split.second.name());
+            }
+        } else {
+            thread_vars.push_back(inner);
+        }
+    }
+
+    // Threads go innermost and blocks outermost; all other loops of the
+    // stage run serially within each thread.
+    auto contains = [](const vector<VarOrRVar> &vars, const string &name) {
+        return std::find_if(vars.begin(), vars.end(), [&name](const VarOrRVar &v) {
+                   return v.name() == name;
+               }) != vars.end();
+    };
+    vector<VarOrRVar> ordering = thread_vars;
+    for (int d = 0; d < (int)dims.size() - 1; d++) {
+        string var = get_base_name(dims[d].var);
+        if (!contains(thread_vars, var) && !contains(block_vars, var)) {
+            ordering.push_back(VarOrRVar(var, dims[d].is_rvar()));
+        }
+    }
+    ordering.insert(ordering.end(), block_vars.begin(), block_vars.end());
+
+    if (dims != ordering) {
+        set<string> var_list;
+        string var_order = ordering[0].name();
+        for (size_t o = 1; o < ordering.size(); o++) {
+            var_order += ", " + ordering[o].name();
+            var_list.insert(ordering[o].name());
+        }
+        f_handle.reorder(ordering);
+        sched.push_schedule(f_handle.name(), stage_num, "reorder(" + var_order + ")", var_list);
+    }
+
+    auto var_names = [](const vector<VarOrRVar> &vars, set<string> &var_list) {
+        string names;
+        for (size_t i = 0; i < vars.size(); i++) {
+            names += (i > 0 ? ", " : "") + vars[i].name();
+            var_list.insert(vars[i].name());
+        }
+        return names;
+    };
+
+    if (!thread_vars.empty()) {
+        switch (thread_vars.size()) {
+        case 1:
+            f_handle.gpu_threads(thread_vars[0]);
+            break;
+        case 2:
+            f_handle.gpu_threads(thread_vars[0], thread_vars[1]);
+            break;
+        default:
+            f_handle.gpu_threads(thread_vars[0], thread_vars[1], thread_vars[2]);
+        }
+        set<string> var_list;
+        string names = var_names(thread_vars, var_list);
+        sched.push_schedule(f_handle.name(), stage_num, "gpu_threads(" + names + ")", var_list);
+    }
+
+    if (block_vars.empty()) {
+        return VarOrRVar("", false);
+    }
+    switch (block_vars.size()) {
+    case 1:
+        f_handle.gpu_blocks(block_vars[0]);
+        break;
+    case 2:
+        f_handle.gpu_blocks(block_vars[0], block_vars[1]);
+        break;
+    default:
+        f_handle.gpu_blocks(block_vars[0], block_vars[1], block_vars[2]);
+    }
+    set<string> var_list;
+    string names = var_names(block_vars, var_list);
+    sched.push_schedule(f_handle.name(), stage_num, "gpu_blocks(" + names + ")", var_list);
+
+    return block_vars[0];
+}
+
+void Partitioner::generate_group_gpu_schedule(
+        const Group &g,
+        const map<FStage, DimBounds> &group_loop_bounds,
+        AutoSchedule &sched) {
+    string out_f_name = g.output.func.name();
+    Function g_out = g.output.func;
+
+    debug(3) << "\n================\n";
+    debug(3) << "Scheduling group for GPU:\n";
+    debug(3) << "================\n";
+    debug(3) << g;
+
+    // Get the definition corresponding to the stage
+    Definition def = get_stage_definition(g_out, g.output.stage_num);
+
+    // Get the estimates for stage bounds
+    DimBounds stg_bounds = get_bounds(g.output);
+    map<string, Expr> stg_estimates = bounds_to_estimates(stg_bounds);
+
+    Stage f_handle = Stage(Func(g_out));
+
+    // Get a function handle for scheduling the stage
+    if (g.output.stage_num > 0) {
+        int stage_num = g.output.stage_num;
+        f_handle = Func(g_out).update(stage_num - 1);
+    } else {
+        Func(g_out).compute_root();
+        sched.push_schedule(f_handle.name(), g.output.stage_num, "compute_root()", {});
+    }
+
+    if (g.output.func.has_extern_definition()) {
+        internal_assert(g.members.size() == 1);
+        return;
+    }
+
+    set<string> rvars;
+    vector<Dim> &dims = def.schedule().dims();
+    for (int d = 0; d < (int)dims.size() - 1; d++) {
+        if (dims[d].is_rvar()) {
+            rvars.insert(get_base_name(dims[d].var));
+        }
+    }
+
+    VarOrRVar block_var =
+        gpu_tile_stage(g, f_handle, g.output.stage_num, def, g_out.name(), true,
+                       true, g.tile_sizes, rvars, stg_estimates, sched);
+
+    for (const FStage &mem : g.members) {
+        // Skip member stages that have been inlined or stage that is the
+        // output stage of the group
+        if ((g.inlined.find(mem.func.name()) != g.inlined.end()) ||
+            (mem == g.output)) {
+            continue;
+        }
+
+        Definition mem_def = get_stage_definition(mem.func, mem.stage_num);
+
+        set<string> mem_rvars;
+        vector<Dim> &mem_dims = mem_def.schedule().dims();
+        for (int d = 0; d < (int)mem_dims.size() - 1; d++) {
+            if (mem_dims[d].is_rvar()) {
+                mem_rvars.insert(get_base_name(mem_dims[d].var));
+            }
+        }
+
+        Stage mem_handle = Stage(Func(mem.func));
+        if (mem.stage_num > 0) {
+            mem_handle = Func(mem.func).update(mem.stage_num - 1);
+        }
+
+        // The other stages of the output function are computed at root
+        // with it, so they get their own blocks.
+        if (mem.func.name() == g_out.name()) {
+            map<string, Expr> mem_estimates = bounds_to_estimates(get_bounds(mem));
+            gpu_tile_stage(g, mem_handle, mem.stage_num, mem_def, mem.func.name(),
+                           false, true, {}, mem_rvars, mem_estimates, sched);
+            continue;
+        }
+
+        if (block_var.name().empty()) {
+            // No blocks to compute the member within; give it its own kernel.
+            if (mem.stage_num == 0) {
+                Func(mem.func).compute_root();
+                sched.push_schedule(mem_handle.name(), mem.stage_num, "compute_root()", {});
+            }
+            map<string, Expr> mem_estimates = bounds_to_estimates(get_bounds(mem));
+            gpu_tile_stage(g, mem_handle, mem.stage_num, mem_def, mem.func.name(),
+                           false, true, {}, mem_rvars, mem_estimates, sched);
+            continue;
+        }
+
+        // Compute the member once per block of the output so that it is
+        // staged in shared memory, and spread it over the block's threads.
+        if (mem.stage_num == 0) {
+            if (block_var.is_rvar) {
+                Func(mem.func).compute_at(Func(g_out), block_var.rvar);
+            } else {
+                Func(mem.func).compute_at(Func(g_out), block_var.var);
+            }
+            string sanitized_g_out = get_sanitized_name(g_out.name());
+            sched.push_schedule(mem_handle.name(), mem.stage_num,
+                                "compute_at(" + sanitized_g_out + ", " + block_var.name() + ")",
+                                {sanitized_g_out, block_var.name()});
+        }
+
+        map<string, Expr> mem_estimates =
+            bounds_to_estimates(get_element(group_loop_bounds, mem));
+        gpu_tile_stage(g, mem_handle, mem.stage_num, mem_def, mem.func.name(),
+                       false, false, {}, mem_rvars, mem_estimates, sched);
+    }
+}
+
+void Partitioner::generate_gpu_schedule(AutoSchedule &sched) {
+    // Grab the group bounds early as they rely on the dimensions of the group
+    // outputs which will be altered by modifying schedules.
+    map<FStage, map<FStage, DimBounds>> loop_bounds = group_loop_bounds();
+
+    for (const auto &g : groups) {
+        generate_group_gpu_schedule(g.second, get_element(loop_bounds, g.first), sched);
     }
 }
 
@@ -3183,13 +4677,35 @@ bool inline_all_trivial_functions(const vector<Function> &outputs,
     return inlined;
 }
 
+// Return true if 'f' is used by some extern Func, either as an input or
+// within one of the Expr arguments.
+bool used_by_extern_func(const map<string, Function> &env, const Function &f) {
+    for (const auto &iter : env) {
+        for (const ExternFuncArgument &arg : iter.second.extern_arguments()) {
+            if (arg.is_func()) {
+                if (Function(arg.func).name() == f.name()) {
+                    return true;
+                }
+            } else if (arg.is_expr()) {
+                FindAllCalls find;
+                arg.expr.accept(&find);
+                if (find.funcs_called.count(f.name())) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
 // Determine if a Func (order[index]) is only consumed by another single Func
 // in element-wise manner. If it is, return the name of the consumer Func;
 // otherwise, return an empty string.
 string is_func_called_element_wise(const vector<string> &order, size_t index,
                                    const map<string, Function> &env) {
     Function f1 = env.at(order[index]);
-    if (!f1.can_be_inlined()) {
+    // Extern stages need their inputs to be realized.
+    if (!f1.can_be_inlined() || used_by_extern_func(env, f1)) {
         return "";
     }
     internal_assert(index < order.size());
@@ -3264,20 +4780,6 @@ bool inline_all_element_wise_functions(const vector<Function> &outputs,
     return inlined;
 }
 
-// Return true if 'f' is used by some extern Func.
-bool used_by_extern_func(const map<string, Function> &env, const Function &f) {
-    for (const auto &iter : env) {
-        for (const ExternFuncArgument &arg : iter.second.extern_arguments()) {
-            if (arg.is_func()) {
-                if (Function(arg.func).name() == f.name()) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
-}
-
 // If the bounds of a Func are undefined, then we should just inline the Func
 // as long as it is not an extern Func or used by some extern Func.
 set<string> get_unbounded_functions(const map<string, Box> &pipeline_bounds,
@@ -3302,7 +4804,7 @@ set<string> get_unbounded_functions(const map<string, Box> &pipeline_bounds,
 // outputs. This applies the schedules and returns a string representation of
 // the schedules. The target architecture is specified by 'target'.
 string generate_schedules(const vector<Function> &outputs, const Target &target,
-                          const MachineParams &arch_params) {
+                          const MachineParams &arch_params, string *serialized) {
     // Make an environment map which is used throughout the auto scheduling process.
     map<string, Function> env;
     for (Function f : outputs) {
@@ -3395,11 +4897,23 @@ string generate_schedules(const vector<Function> &outputs, const Target &target,
     debug(2) << "Initializing dependence analysis...\n";
     DependenceAnalysis dep_analysis(env, order, func_val_bounds);
 
+    // The region queries dominate the time spent auto-scheduling large
+    // pipelines. Spread the independent ones over all cores, each with its
+    // own dependence analysis (and caches). Use a single thread when
+    // debugging, so that the debug output is not interleaved.
+    vector<std::shared_ptr<DependenceAnalysis>> worker_analyses;
+    size_t num_workers = (debug::debug_level() > 0) ? 1 : ThreadPool<void>::num_processors_online();
+    if (num_workers > 1) {
+        for (size_t i = 0; i < num_workers; i++) {
+            worker_analyses.push_back(std::make_shared<DependenceAnalysis>(env, order, func_val_bounds));
+        }
+    }
+
     // Compute bounds of all functions in the pipeline given estimates on
     // outputs. Also report functions which bounds could not be inferred.
     debug(2) << "Computing pipeline bounds...\n";
     map<string, Box> pipeline_bounds =
-        get_pipeline_bounds(dep_analysis, outputs, &costs.input_estimates);
+        get_pipeline_bounds(dep_analysis, outputs, &costs.input_estimates, worker_analyses);
 
     // Determine all unbounded functions that are not extern Func or
     // used by some extern Funcs.
@@ -3408,6 +4922,7 @@ string generate_schedules(const vector<Function> &outputs, const Target &target,
 
     debug(2) << "Initializing partitioner...\n";
     Partitioner part(pipeline_bounds, arch_params, dep_analysis, costs, outputs, unbounded);
+    part.worker_analyses = worker_analyses;
 
     // Compute and display reuse
     /* TODO: Use the reuse estimates to reorder loops
@@ -3439,15 +4954,40 @@ string generate_schedules(const vector<Function> &outputs, const Target &target,
         part.disp_pipeline_costs();
     }
 
+    // Greedily merging the single best choice at each step can lock in poor
+    // choices early on, e.g. on pipelines with diamond-shaped dependencies.
+    // HL_AUTO_SCHEDULE_BEAM_WIDTH > 1 searches over merge sequences instead,
+    // optionally limited to HL_AUTO_SCHEDULE_BEAM_TIME seconds per level.
+    int beam_width = 1;
+    double beam_time = 0;
+    string beam_width_str = get_env_variable("HL_AUTO_SCHEDULE_BEAM_WIDTH");
+    if (!beam_width_str.empty()) {
+        beam_width = atoi(beam_width_str.c_str());
+        user_assert(beam_width > 0)
+            << "HL_AUTO_SCHEDULE_BEAM_WIDTH must be a positive integer: " << beam_width_str << "\n";
+    }
+    string beam_time_str = get_env_variable("HL_AUTO_SCHEDULE_BEAM_TIME");
+    if (!beam_time_str.empty()) {
+        beam_time = atof(beam_time_str.c_str());
+    }
+
+    auto group = [&](Partitioner::Level level) {
+        if (beam_width > 1) {
+            part.group_beam_search(level, beam_width, beam_time);
+        } else {
+            part.group(level);
+        }
+    };
+
     debug(2) << "Partitioner computing inline group...\n";
-    part.group(Partitioner::Level::Inline);
+    group(Partitioner::Level::Inline);
     if (debug::debug_level() >= 3) {
         part.disp_grouping();
     }
 
     debug(2) << "Partitioner computing fast-mem group...\n";
     part.grouping_cache.clear();
-    part.group(Partitioner::Level::FastMem);
+    group(Partitioner::Level::FastMem);
     if (debug::debug_level() >= 3) {
         part.disp_pipeline_costs();
         part.disp_grouping();
@@ -3456,22 +4996,315 @@ string generate_schedules(const vector<Function> &outputs, const Target &target,
 
     debug(2) << "Initializing AutoSchedule...\n";
     AutoSchedule sched(env, full_order);
-    debug(2) << "Generating CPU schedule...\n";
-    part.generate_cpu_schedule(target, sched);
+    if (target.has_gpu_feature()) {
+        debug(2) << "Generating GPU schedule...\n";
+        part.generate_gpu_schedule(sched);
+    } else {
+        debug(2) << "Generating CPU schedule...\n";
+        part.generate_cpu_schedule(target, sched);
+    }
 
     std::ostringstream oss;
     oss << sched;
     string sched_string = oss.str();
 
+    if (serialized) {
+        std::ostringstream serialized_ss;
+        sched.serialize(serialized_ss);
+        *serialized = serialized_ss.str();
+    }
+
     debug(3) << "\n\n*******************************\nSchedule:\n"
              << "*******************************\n" << sched_string << "\n\n";
 
     // TODO: Unify both inlining and grouping for fast mem
-    // TODO: GPU scheduling
     // TODO: Hierarchical tiling
 
     return sched_string;
 }
 
+namespace {
+
+// Return 'name' without the suffix which unique_name() adds to the names of
+// Funcs when several Funcs are given the same name.
+string strip_unique_suffix(const string &name) {
+    size_t pos = name.rfind('$');
+    if ((pos != string::npos) && (pos + 1 < name.size()) &&
+        std::all_of(name.begin() + pos + 1, name.end(), ::isdigit)) {
+        return name.substr(0, pos);
+    }
+    return name;
 }
+
+// Find the dimension 'name' of the stage 'stage_num' of 'f', if any.
+bool find_stage_dim(const Function &f, int stage_num, const string &name, VarOrRVar &result) {
+    Definition def = get_stage_definition(f, stage_num);
+    for (const Dim &d : def.schedule().dims()) {
+        if ((d.var == name) || ends_with(d.var, "." + name)) {
+            result = VarOrRVar(name, d.is_rvar());
+            return true;
+        }
+    }
+    return false;
 }
+
+}  // anonymous namespace
+
+void apply_schedules(const vector<Function> &outputs, const string &serialized) {
+    map<string, Function> env;
+    for (Function f : outputs) {
+        map<string, Function> more_funcs = find_transitive_calls(f);
+        env.insert(more_funcs.begin(), more_funcs.end());
+    }
+
+    for (const auto &iter : env) {
+        validate_no_partial_schedules(iter.second);
+    }
+
+    // Functions are looked up by name. If the schedule was generated for a
+    // pipeline in which the functions were given different unique suffixes
+    // (e.g. a second instance of the same pipeline), fall back to matching
+    // the names without the suffixes, provided that is unambiguous.
+    map<string, vector<string>> base_names;
+    for (const auto &iter : env) {
+        base_names[strip_unique_suffix(iter.first)].push_back(iter.first);
+    }
+    // The intermediate functions created by rfactor() while applying the
+    // schedule, by the names they have in the schedule.
+    map<string, Function> intermediates;
+
+    auto find_func = [&](const string &name, int line_num) {
+        auto iter = intermediates.find(name);
+        if (iter != intermediates.end()) {
+            return iter->second;
+        }
+        iter = env.find(name);
+        if (iter != env.end()) {
+            return iter->second;
+        }
+        const auto &base_iter = base_names.find(strip_unique_suffix(name));
+        user_assert((base_iter != base_names.end()) && (base_iter->second.size() == 1))
+            << "Unable to apply schedule: line " << line_num << " refers to the function \""
+            << name << "\", which is not (unambiguously) in the pipeline.\n";
+        return get_element(env, base_iter->second[0]);
+    };
+
+    auto parse_int = [](const string &str, int line_num) {
+        char *end = nullptr;
+        long value = strtol(str.c_str(), &end, 10);
+        user_assert(!str.empty() && (*end == '\0'))
+            << "Unable to apply schedule: expected an integer on line " << line_num
+            << ", got \"" << str << "\".\n";
+        return (int)value;
+    };
+
+    std::istringstream in(serialized);
+    string line;
+    int line_num = 0;
+    vector<std::function<void()>> deferred;
+    while (std::getline(in, line)) {
+        line_num++;
+        if (line_num == 1) {
+            user_assert(line == serialized_schedule_header)
+                << "Unable to apply schedule: expected \"" << serialized_schedule_header
+                << "\" on the first line, got \"" << line << "\".\n";
+            continue;
+        }
+
+        vector<string> tokens;
+        std::istringstream line_ss(line);
+        string token;
+        while (line_ss >> token) {
+            tokens.push_back(token);
+        }
+        if (tokens.empty() || (tokens[0][0] == '#')) {
+            continue;
+        }
+        user_assert(tokens.size() >= 3)
+            << "Unable to apply schedule: can't parse line " << line_num << ": " << line << "\n";
+
+        Function f = find_func(tokens[0], line_num);
+        int stage_num = parse_int(tokens[1], line_num);
+        user_assert((stage_num >= 0) && (stage_num <= (int)f.updates().size()))
+            << "Unable to apply schedule: \"" << f.name() << "\" has no stage "
+            << stage_num << " (line " << line_num << ").\n";
+        const string &directive = tokens[2];
+        vector<string> args(tokens.begin() + 3, tokens.end());
+
+        Func func(f);
+        Stage stage = (stage_num == 0) ? Stage(func) : func.update(stage_num - 1);
+
+        auto check_num_args = [&](size_t min_args, size_t max_args) {
+            user_assert((args.size() >= min_args) && (args.size() <= max_args))
+                << "Unable to apply schedule: wrong number of arguments to "
+                << directive << " on line " << line_num << ": " << line << "\n";
+        };
+        auto dim = [&](const string &name) {
+            VarOrRVar v(name, false);
+            user_assert(find_stage_dim(f, stage_num, name, v))
+                << "Unable to apply schedule: stage " << stage_num << " of \"" << f.name()
+                << "\" has no dimension \"" << name << "\" (line " << line_num << ").\n";
+            return v;
+        };
+
+        if (directive == "compute_root") {
+            check_num_args(0, 0);
+            func.compute_root();
+        } else if (directive == "memoize") {
+            check_num_args(0, 0);
+            func.memoize();
+        } else if ((directive == "compute_at") || (directive == "store_at")) {
+            check_num_args(2, 2);
+            // The loop may be created by a schedule of the consumer further
+            // down, so look for it once everything else has been applied.
+            deferred.push_back([=]() mutable {
+                Function consumer = find_func(args[0], line_num);
+                VarOrRVar v(args[1], false);
+                bool found = false;
+                for (size_t s = 0; !found && (s <= consumer.updates().size()); s++) {
+                    found = find_stage_dim(consumer, s, args[1], v);
+                }
+                user_assert(found)
+                    << "Unable to apply schedule: \"" << consumer.name() << "\" has no dimension \""
+                    << args[1] << "\" (line " << line_num << ").\n";
+                LoopLevel level(Func(consumer), v);
+                if (directive == "compute_at") {
+                    func.compute_at(level);
+                } else {
+                    func.store_at(level);
+                }
+            });
+        } else if (directive == "split") {
+            check_num_args(4, 5);
+            VarOrRVar old = dim(args[0]);
+            VarOrRVar outer(args[1], old.is_rvar), inner(args[2], old.is_rvar);
+            int factor = parse_int(args[3], line_num);
+            TailStrategy tail = TailStrategy::Auto;
+            if (args.size() == 5) {
+                if (args[4] == "RoundUp") {
+                    tail = TailStrategy::RoundUp;
+                } else if (args[4] == "GuardWithIf") {
+                    tail = TailStrategy::GuardWithIf;
+                } else if (args[4] == "ShiftInwards") {
+                    tail = TailStrategy::ShiftInwards;
+                } else {
+                    user_error << "Unable to apply schedule: unknown tail strategy \"" << args[4]
+                               << "\" on line " << line_num << ".\n";
+                }
+            }
+            stage.split(old, outer, inner, factor, tail);
+        } else if (directive == "reorder") {
+            check_num_args(1, std::numeric_limits<size_t>::max());
+            vector<VarOrRVar> vars;
+            for (const string &a : args) {
+                vars.push_back(dim(a));
+            }
+            stage.reorder(vars);
+        } else if (directive == "parallel") {
+            check_num_args(1, 1);
+            stage.parallel(dim(args[0]));
+        } else if (directive == "vectorize") {
+            check_num_args(1, 1);
+            stage.vectorize(dim(args[0]));
+        } else if ((directive == "gpu_threads") || (directive == "gpu_blocks")) {
+            check_num_args(1, 3);
+            vector<VarOrRVar> vars;
+            for (const string &a : args) {
+                vars.push_back(dim(a));
+            }
+            if (directive == "gpu_threads") {
+                switch (vars.size()) {
+                case 1:
+                    stage.gpu_threads(vars[0]);
+                    break;
+                case 2:
+                    stage.gpu_threads(vars[0], vars[1]);
+                    break;
+                default:
+                    stage.gpu_threads(vars[0], vars[1], vars[2]);
+                }
+            } else {
+                switch (vars.size()) {
+                case 1:
+                    stage.gpu_blocks(vars[0]);
+                    break;
+                case 2:
+                    stage.gpu_blocks(vars[0], vars[1]);
+                    break;
+                default:
+                    stage.gpu_blocks(vars[0], vars[1], vars[2]);
+                }
+            }
+        } else if (directive == "rfactor") {
+            check_num_args(3, 3);
+            VarOrRVar r = dim(args[0]);
+            user_assert(r.is_rvar)
+                << "Unable to apply schedule: \"" << args[0] << "\" is not an RVar (line "
+                << line_num << ").\n";
+            Func intm = stage.rfactor(r.rvar, Var(args[1]));
+            intermediates.emplace(args[2], intm.function());
+        } else {
+            user_error << "Unable to apply schedule: unknown directive \"" << directive
+                       << "\" on line " << line_num << ".\n";
+        }
+    }
+    user_assert(line_num > 0) << "Unable to apply schedule: the schedule is empty.\n";
+
+    for (const auto &apply : deferred) {
+        apply();
+    }
+}
+
+}  // namespace Internal
+
+MachineParams::MachineParams(const std::string &s) {
+    std::vector<std::string> v = Internal::split_string(s, ",");
+    user_assert(v.size() == 3 || v.size() == 6)
+        << "Unable to parse MachineParams: " << s << "\n";
+    std::vector<int32_t> values;
+    for (const std::string &str : v) {
+        user_assert(!str.empty() && std::all_of(str.begin(), str.end(), ::isdigit))
+            << "Unable to parse MachineParams: " << s << "\n";
+        values.push_back(std::stoi(str));
+    }
+    parallelism = values[0];
+    if (values.size() == 3) {
+        last_level_cache_size = values[1];
+        balance = values[2];
+    } else {
+        l1_cache_size = values[1];
+        l2_cache_size = values[2];
+        last_level_cache_size = values[3];
+        l2_balance = values[4];
+        balance = values[5];
+    }
+}
+
+MachineParams MachineParams::generic() {
+    std::string params = Internal::get_env_variable("HL_MACHINE_PARAMS");
+    if (!params.empty()) {
+        return MachineParams(params);
+    }
+    return MachineParams(16, 16 * 1024 * 1024, 40);
+}
+
+std::string MachineParams::to_string() const {
+    auto str = [](const Expr &e) {
+        const int64_t *i = Internal::as_const_int(e);
+        internal_assert(i) << "MachineParams must be constant integers: " << e << "\n";
+        return std::to_string(*i);
+    };
+    std::ostringstream o;
+    o << str(parallelism);
+    if (has_cache_hierarchy()) {
+        o << "," << str(l1_cache_size) << "," << str(l2_cache_size);
+    }
+    o << "," << str(last_level_cache_size);
+    if (has_cache_hierarchy()) {
+        o << "," << str(l2_balance);
+    }
+    o << "," << str(balance);
+    return o.str();
+}
+
+}  // namespace Halide
@@ -22,8 +22,44 @@ struct MachineParams {
      * the cost of an arithmetic operation at last level cache. */
     Expr balance;
 
+    /** Sizes of the L1 and L2 data caches (in bytes). If these are
+     * undefined, the cost model treats the machine as having only a last
+     * level cache. */
+    Expr l1_cache_size, l2_cache_size;
+    /** Indicates how much more expensive is the cost of a load compared to
+     * the cost of an arithmetic operation at the L2 cache. Loads that hit
+     * in L1 cost the same as an arithmetic operation. */
+    Expr l2_balance;
+
     explicit MachineParams(int32_t parallelism, int32_t llc, int32_t balance)
         : parallelism(parallelism), last_level_cache_size(llc), balance(balance) {}
+
+    /** Describe a machine with a three level cache hierarchy. With this
+     * the auto-scheduler also tiles within the tiles sized for the last
+     * level cache, so that each sub-tile fits in L1. */
+    explicit MachineParams(int32_t parallelism, int32_t l1, int32_t l2, int32_t llc,
+                           int32_t l2_balance, int32_t balance)
+        : parallelism(parallelism), last_level_cache_size(llc), balance(balance),
+          l1_cache_size(l1), l2_cache_size(l2), l2_balance(l2_balance) {}
+
+    /** Reconstruct a MachineParams from canonical string form (see
+     * \ref MachineParams::to_string). */
+    EXPORT explicit MachineParams(const std::string &s);
+
+    /** Default machine parameters for a generic CPU architecture. If the
+     * environment variable HL_MACHINE_PARAMS is set (e.g. to the result of
+     * a calibration run on the host), those parameters are used instead. */
+    EXPORT static MachineParams generic();
+
+    /** Convert the MachineParams into canonical string form:
+     * "parallelism,llc,balance", or "parallelism,l1,l2,llc,l2_balance,balance"
+     * if it describes a cache hierarchy. */
+    EXPORT std::string to_string() const;
+
+    /** Returns true if the L1 and L2 cache parameters are set. */
+    bool has_cache_hierarchy() const {
+        return l1_cache_size.defined() && l2_cache_size.defined() && l2_balance.defined();
+    }
 };
 
 namespace Internal {
@@ -32,10 +68,20 @@ namespace Internal {
  * have specializations or schedules as the current auto-scheduler does not take
  * into account user-defined schedules or specializations. This applies the
  * schedules and returns a string representation of the schedules. The target
- * architecture is specified by 'target'. */
+ * architecture is specified by 'target'. If 'serialized' is non-null, it is
+ * set to the schedules in the form read by \ref apply_schedules. */
 EXPORT std::string generate_schedules(const std::vector<Function> &outputs,
                                       const Target &target,
-                                      const MachineParams &arch_params);
+                                      const MachineParams &arch_params,
+                                      std::string *serialized = nullptr);
+
+/** Apply schedules serialized by \ref generate_schedules to the Funcs within
+ * a pipeline, without re-running the auto-scheduler. The Funcs should not
+ * already have schedules. Functions and dimensions are referred to by name, so
+ * the pipeline must be defined in the same way as the one the schedules were
+ * generated for. */
+EXPORT void apply_schedules(const std::vector<Function> &outputs,
+                            const std::string &serialized);
 
 }
 }
@@ -131,14 +131,10 @@ set<string> get_parents(Function f, int stage) {
                 FindAllCalls find;
                 arg.expr.accept(&find);
                 parents.insert(find.funcs_called.begin(), find.funcs_called.end());
-            } else if (arg.is_image_param() || arg.is_buffer()) {
-                Buffer<> buf;
-                if (arg.is_image_param()) {
-                    buf = arg.image_param.get_buffer();
-                } else {
-                    buf = arg.buffer;
-                }
-                parents.insert(buf.name());
+            } else if (arg.is_image_param()) {
+                parents.insert(arg.image_param.name());
+            } else if (arg.is_buffer()) {
+                parents.insert(arg.buffer.name());
             }
         }
     } else {
@@ -135,7 +135,7 @@ private:
         // If overflow is impossible, cast the min and max. If it's
         // possible, use the bounds of the destination type.
         bool could_overflow = true;
-        if (to.can_represent(from) || to.is_float()) {
+        if (to.can_represent(from) || to.is_float() || to.is_bfloat()) {
             could_overflow = false;
         } else if (to.is_int() && to.bits() >= 32) {
             // If we cast to an int32 or greater, assume that it won't
@@ -248,7 +248,8 @@ private:
             }
 
             // Assume no overflow for float, int32, and int64
-            if (!op->type.is_float() && (!op->type.is_int() || op->type.bits() < 32)) {
+            if (!op->type.is_float() && !op->type.is_bfloat() &&
+                (!op->type.is_int() || op->type.bits() < 32)) {
                 if (interval.has_upper_bound()) {
                     Expr no_overflow = (cast<int>(a.max) + cast<int>(b.max) == cast<int>(interval.max));
                     if (!can_prove(no_overflow)) {
@@ -287,7 +288,8 @@ private:
             }
 
             // Assume no overflow for float, int32, and int64
-            if (!op->type.is_float() && (!op->type.is_int() || op->type.bits() < 32)) {
+            if (!op->type.is_float() && !op->type.is_bfloat() &&
+                (!op->type.is_int() || op->type.bits() < 32)) {
                 if (interval.has_upper_bound()) {
                     Expr no_overflow = (cast<int>(a.max) - cast<int>(b.min) == cast<int>(interval.max));
                     if (!can_prove(no_overflow)) {
@@ -362,7 +364,8 @@ private:
         }
 
         // Assume no overflow for float, int32, and int64
-        if (!op->type.is_float() && (!op->type.is_int() || op->type.bits() < 32)) {
+        if (!op->type.is_float() && !op->type.is_bfloat() &&
+            (!op->type.is_int() || op->type.bits() < 32)) {
             if (a.is_bounded() && b.is_bounded()) {
                 // Try to prove it can't overflow
                 Expr test1 = (cast<int>(a.min) * cast<int>(b.min) == cast<int>(a.min * b.min));
@@ -816,6 +819,51 @@ private:
         interval = result;
     }
 
+    void visit(const VectorReduce *op) {
+        op->value.accept(this);
+        switch (op->op) {
+        case VectorReduce::Add: {
+            Interval v = interval;
+            Expr factor = make_const(op->type.element_of(), op->value.type().lanes() / op->type.lanes());
+            if (v.has_upper_bound()) {
+                interval.max = v.max * factor;
+            }
+            if (v.has_lower_bound()) {
+                interval.min = v.min * factor;
+            }
+
+            // Assume no overflow for float, int32, and int64
+            if (!op->type.is_float() && !op->type.is_bfloat() &&
+                (!op->type.is_int() || op->type.bits() < 32)) {
+                if (interval.has_upper_bound()) {
+                    Expr no_overflow = (cast<int>(v.max) * cast<int>(factor) == cast<int>(interval.max));
+                    if (!can_prove(no_overflow)) {
+                        bounds_of_type(op->type);
+                        return;
+                    }
+                }
+                if (interval.has_lower_bound()) {
+                    Expr no_overflow = (cast<int>(v.min) * cast<int>(factor) == cast<int>(interval.min));
+                    if (!can_prove(no_overflow)) {
+                        bounds_of_type(op->type);
+                        return;
+                    }
+                }
+            }
+            break;
+        }
+        case VectorReduce::Min:
+        case VectorReduce::Max:
+        case VectorReduce::And:
+        case VectorReduce::Or:
+            // The bounds of the lanes of the value also bound the result.
+            break;
+        case VectorReduce::Mul:
+            bounds_of_type(op->type);
+            break;
+        }
+    }
+
     void visit(const LetStmt *) {
         internal_error << "Bounds of statement\n";
     }
@@ -1741,6 +1789,91 @@ Box box_touched(Stmt s, string fn, const Scope<Interval> &scope, const FuncValue
     return box_touched(Expr(), s, true, true, fn, scope, fb);
 }
 
+namespace {
+// Collect the names of all the variables referenced by an Expr, in a
+// deterministic order.
+class FindVariables : public IRGraphVisitor {
+    using IRGraphVisitor::visit;
+
+    void visit(const Variable *op) {
+        names.insert(op->name);
+    }
+public:
+    set<string> names;
+};
+}
+
+bool BoundsCache::Key::operator<(const Key &other) const {
+    if (const_bound != other.const_bound) {
+        return const_bound < other.const_bound;
+    }
+    if (names != other.names) {
+        return names < other.names;
+    }
+    internal_assert(exprs.size() == other.exprs.size());
+    for (size_t i = 0; i < exprs.size(); i++) {
+        if (exprs[i] < other.exprs[i]) {
+            return true;
+        } else if (other.exprs[i] < exprs[i]) {
+            return false;
+        }
+    }
+    return false;
+}
+
+BoundsCache::Key BoundsCache::make_key(const Expr &e, const Scope<Interval> &scope, bool const_bound) {
+    Key key;
+    key.const_bound = const_bound;
+    key.exprs.push_back(ExprWithCompareCache(e, &compare_cache));
+
+    // The result only depends on the bindings of the variables that
+    // the Expr actually refers to.
+    FindVariables vars;
+    e.accept(&vars);
+    for (const string &name : vars.names) {
+        if (scope.contains(name)) {
+            const Interval &in = scope.get(name);
+            key.names.push_back(name);
+            key.exprs.push_back(ExprWithCompareCache(in.min, &compare_cache));
+            key.exprs.push_back(ExprWithCompareCache(in.max, &compare_cache));
+        }
+    }
+    return key;
+}
+
+Interval BoundsCache::bounds_of_expr_in_scope(const Expr &e, const Scope<Interval> &scope, bool const_bound) {
+    Key key = make_key(e, scope, const_bound);
+    auto iter = interval_cache.find(key);
+    if (iter != interval_cache.end()) {
+        num_hits++;
+        return iter->second;
+    }
+    num_misses++;
+    Interval result = Internal::bounds_of_expr_in_scope(e, scope, func_bounds, const_bound);
+    interval_cache.emplace(std::move(key), result);
+    return result;
+}
+
+map<string, Box> BoundsCache::boxes_required(const Expr &e, const Scope<Interval> &scope) {
+    Key key = make_key(e, scope, false);
+    auto iter = boxes_cache.find(key);
+    if (iter != boxes_cache.end()) {
+        num_hits++;
+        return iter->second;
+    }
+    num_misses++;
+    map<string, Box> result = Internal::boxes_required(e, scope, func_bounds);
+    boxes_cache.emplace(std::move(key), result);
+    return result;
+}
+
+void BoundsCache::clear() {
+    interval_cache.clear();
+    boxes_cache.clear();
+    compare_cache.clear();
+    num_hits = num_misses = 0;
+}
+
 // Compute interval of all possible function's values (default + specialized values)
 Interval compute_pure_function_definition_value_bounds(
         const Definition &def, const Scope<Interval>& scope, const FuncValueBounds &fb, int dim) {
@@ -2054,6 +2187,36 @@ void bounds_test() {
 
     boxes_touched_test();
 
+    {
+        // Check that the bounds cache matches on value and only on the
+        // scope bindings of the variables the Expr refers to.
+        FuncValueBounds fb;
+        BoundsCache cache(fb);
+        Scope<Interval> cache_scope;
+        cache_scope.push("x", Interval(Expr(0), Expr(10)));
+        cache_scope.push("y", Interval(Expr(0), Expr(5)));
+
+        Interval i1 = cache.bounds_of_expr_in_scope(x*2 + 1, cache_scope);
+        Interval i2 = cache.bounds_of_expr_in_scope(x*2 + 1, cache_scope);
+        internal_assert(cache.hits() == 1 && cache.misses() == 1);
+        internal_assert(equal(simplify(i2.min), 1) && equal(simplify(i2.max), 21));
+        internal_assert(i1.min.same_as(i2.min) && i1.max.same_as(i2.max));
+
+        cache_scope.push("y", Interval(Expr(3), Expr(4)));
+        cache.bounds_of_expr_in_scope(x*2 + 1, cache_scope);
+        internal_assert(cache.hits() == 2 && cache.misses() == 1);
+        cache_scope.pop("y");
+
+        cache_scope.push("x", Interval(Expr(3), Expr(4)));
+        Interval i3 = cache.bounds_of_expr_in_scope(x*2 + 1, cache_scope);
+        internal_assert(cache.hits() == 2 && cache.misses() == 2);
+        internal_assert(equal(simplify(i3.min), 7) && equal(simplify(i3.max), 9));
+        cache_scope.pop("x");
+
+        cache.bounds_of_expr_in_scope(x*2 + 1, cache_scope, true);
+        internal_assert(cache.hits() == 2 && cache.misses() == 3);
+    }
+
     std::cout << "Bounds test passed" << std::endl;
 }
 
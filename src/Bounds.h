@@ -6,6 +6,7 @@
  * and the regions of a function read or written by a statement.
  */
 
+#include "IREquality.h"
 #include "IROperator.h"
 #include "Scope.h"
 #include "Interval.h"
@@ -153,6 +154,49 @@ Box box_touched(Stmt s, std::string fn,
                 const FuncValueBounds &func_bounds = FuncValueBounds());
 // @}
 
+/** Memoizes bounds_of_expr_in_scope and boxes_required on Exprs for
+ * a fixed set of function value bounds. Entries are keyed on the
+ * expression (compared by value, not identity) and on the scope
+ * bindings of the variables it refers to, so repeated queries from
+ * passes that rebuild equivalent Exprs (e.g. the auto-scheduler's
+ * dependence analysis) are only computed once. The function value
+ * bounds are held by reference and must outlive the cache. */
+class BoundsCache {
+public:
+    BoundsCache(const FuncValueBounds &fb) : func_bounds(fb), compare_cache(8) {}
+
+    Interval bounds_of_expr_in_scope(const Expr &e, const Scope<Interval> &scope,
+                                     bool const_bound = false);
+
+    std::map<std::string, Box> boxes_required(const Expr &e, const Scope<Interval> &scope);
+
+    /** Forget all cached results. */
+    void clear();
+
+    /** The number of queries answered from the cache, and the number
+     * of queries that had to be computed. */
+    // @{
+    size_t hits() const {return num_hits;}
+    size_t misses() const {return num_misses;}
+    // @}
+
+private:
+    struct Key {
+        bool const_bound;
+        std::vector<std::string> names;
+        std::vector<ExprWithCompareCache> exprs;
+        bool operator<(const Key &other) const;
+    };
+
+    Key make_key(const Expr &e, const Scope<Interval> &scope, bool const_bound);
+
+    const FuncValueBounds &func_bounds;
+    IRCompareCache compare_cache;
+    std::map<Key, Interval> interval_cache;
+    std::map<Key, std::map<std::string, Box>> boxes_cache;
+    size_t num_hits = 0, num_misses = 0;
+};
+
 /** Compute the maximum and minimum possible value for each function
  * in an environment. */
 FuncValueBounds compute_function_value_bounds(const std::vector<std::string> &order,
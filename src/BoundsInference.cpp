@@ -108,6 +108,7 @@ class BoundsInference : public IRMutator {
 public:
     const vector<Function> &funcs;
     const FuncValueBounds &func_bounds;
+    BoundsCache bounds_cache;
     set<string> in_pipeline, inner_productions;
     Scope<int> in_stages;
     const Target target;
@@ -641,7 +642,7 @@ public:
                     const vector<Function> &outputs,
                     const FuncValueBounds &fb,
                     const Target &target) :
-        funcs(f), func_bounds(fb), target(target) {
+        funcs(f), func_bounds(fb), bounds_cache(fb), target(target) {
         internal_assert(!f.empty());
 
         // Compute the intrinsic relationships between the stages of
@@ -756,7 +757,7 @@ public:
             } else {
                 for (const auto &cval : consumer.exprs) {
                     map<string, Box> new_boxes;
-                    new_boxes = boxes_required(cval.value, scope, func_bounds);
+                    new_boxes = bounds_cache.boxes_required(cval.value, scope);
                     for (auto &i : new_boxes) {
                         // Add the condition on which this value is evaluated to the box before merging
                         Box &box = i.second;
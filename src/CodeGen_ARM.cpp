@@ -427,10 +427,181 @@ void CodeGen_ARM::visit(const Div *op) {
     CodeGen_Posix::visit(op);
 }
 
+namespace {
+
+// A VectorReduce that adds together pairs of lanes of a value widened
+// from a narrower integer type can use the pairwise add long
+// instructions (vpaddl on arm, saddlp/uaddlp on aarch64), which sum
+// adjacent lanes into a lane of twice the width. Returns the narrowest
+// such operand, or an undefined Expr.
+Expr pairwise_add_long_operand(const VectorReduce *op, bool &is_signed) {
+    Type t = op->type;
+    const int input_lanes = op->value.type().lanes();
+    const int factor = input_lanes / t.lanes();
+    if (op->op != VectorReduce::Add || !(t.is_int() || t.is_uint()) ||
+        factor % 2 != 0 || input_lanes < 4) {
+        return Expr();
+    }
+    for (int bits = 8; bits * 2 <= t.bits(); bits *= 2) {
+        Expr narrow = lossless_cast(UInt(bits, input_lanes), op->value);
+        is_signed = false;
+        if (!narrow.defined() && t.is_int()) {
+            narrow = lossless_cast(Int(bits, input_lanes), op->value);
+            is_signed = true;
+        }
+        if (narrow.defined()) {
+            return narrow;
+        }
+    }
+    return Expr();
+}
+
+// A VectorReduce that adds together groups of four widened 8-bit
+// products (or widened 8-bit values) into 32-bit lanes can use the
+// ARMv8.2 dot product instructions. Returns the intrinsic to use and
+// the two 8-bit factors.
+bool should_use_dot_product(const VectorReduce *op, string &intrin, Expr &a, Expr &b) {
+    Type t = op->type;
+    const int input_lanes = op->value.type().lanes();
+    const int factor = input_lanes / t.lanes();
+    if (op->op != VectorReduce::Add || !(t.is_int() || t.is_uint()) ||
+        t.bits() != 32 || factor % 4 != 0 || input_lanes < 8) {
+        return false;
+    }
+
+    for (bool is_signed : {false, true}) {
+        Type narrow = is_signed ? Int(8, input_lanes) : UInt(8, input_lanes);
+        if (const Mul *mul = op->value.as<Mul>()) {
+            a = lossless_cast(narrow, mul->a);
+            b = lossless_cast(narrow, mul->b);
+        } else {
+            a = lossless_cast(narrow, op->value);
+            b = make_one(narrow);
+        }
+        if (a.defined() && b.defined()) {
+            intrin = is_signed ? "sdot" : "udot";
+            return true;
+        }
+    }
+    return false;
+}
+
+// The name of a pairwise add long intrinsic on 128-bit vectors of the
+// given narrow type, e.g. "llvm.arm.neon.vpaddlu.v8i16.v16i8".
+string pairwise_add_long_intrin(const Target &target, const string &op, Type narrow, bool is_signed) {
+    const int bits = narrow.bits();
+    const int lanes = 128 / bits;
+    ostringstream intrin;
+    if (target.bits == 32) {
+        intrin << "llvm.arm.neon.vpad" << op << (is_signed ? "s" : "u");
+    } else {
+        intrin << "llvm.aarch64.neon." << (is_signed ? "s" : "u") << op << "p";
+    }
+    intrin << ".v" << lanes / 2 << "i" << bits * 2
+           << ".v" << lanes << "i" << bits;
+    return intrin.str();
+}
+
+}
+
+Value *CodeGen_ARM::call_dot_product(Type t, const string &op, Expr acc, Expr a, Expr b) {
+    const int lanes = a.type().lanes() >= 16 ? 16 : 8;
+    string intrin = (target.bits == 32 ? "llvm.arm.neon." : "llvm.aarch64.neon.") + op +
+        ".v" + std::to_string(lanes / 4) + "i32.v" + std::to_string(lanes) + "i8";
+    return call_intrin(t, lanes / 4, intrin, {acc, a, b});
+}
+
 void CodeGen_ARM::visit(const Add *op) {
+    if (LLVM_VERSION >= 60 && target.has_feature(Target::ARMDotProd) &&
+        !neon_intrinsics_disabled()) {
+        // Accumulate a dot product with sdot/udot.
+        for (int i = 0; i < 2; i++) {
+            Expr acc = i == 0 ? op->a : op->b;
+            const VectorReduce *red = (i == 0 ? op->b : op->a).as<VectorReduce>();
+            string intrin;
+            Expr a, b;
+            if (red && red->value.type().lanes() == 4 * op->type.lanes() &&
+                should_use_dot_product(red, intrin, a, b)) {
+                value = call_dot_product(op->type, intrin, acc, a, b);
+                return;
+            }
+        }
+    }
+
+    if (neon_intrinsics_disabled() || target.bits != 32) {
+        // On aarch64, llvm fuses saddlp/uaddlp with an add into
+        // sadalp/uadalp by itself.
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    // Accumulate a widening pairwise sum with vpadal.
+    for (int i = 0; i < 2; i++) {
+        Expr acc = i == 0 ? op->a : op->b;
+        const VectorReduce *red = (i == 0 ? op->b : op->a).as<VectorReduce>();
+        bool is_signed = false;
+        Expr narrow;
+        if (red && red->value.type().lanes() == 2 * op->type.lanes()) {
+            narrow = pairwise_add_long_operand(red, is_signed);
+        }
+        if (narrow.defined() && narrow.type().bits() * 2 == op->type.bits()) {
+            string intrin = pairwise_add_long_intrin(target, "al", narrow.type(), is_signed);
+            value = call_intrin(op->type, 64 / narrow.type().bits(), intrin, {acc, narrow});
+            return;
+        }
+    }
+
     CodeGen_Posix::visit(op);
 }
 
+void CodeGen_ARM::visit(const VectorReduce *op) {
+    string dot_intrin;
+    Expr dot_a, dot_b;
+    if (LLVM_VERSION >= 60 && target.has_feature(Target::ARMDotProd) &&
+        !neon_intrinsics_disabled() &&
+        should_use_dot_product(op, dot_intrin, dot_a, dot_b)) {
+        // Sum groups of four products with sdot/udot, then sum any
+        // remaining groups of those.
+        const int dot_lanes = op->value.type().lanes() / 4;
+        Type dot_type = op->type.with_lanes(dot_lanes);
+        string dot_name = unique_name('t');
+        sym_push(dot_name, call_dot_product(dot_type, dot_intrin, make_zero(dot_type), dot_a, dot_b));
+        Expr dots = Variable::make(dot_type, dot_name);
+        if (dot_lanes > op->type.lanes()) {
+            dots = VectorReduce::make(VectorReduce::Add, dots, op->type.lanes());
+        }
+        value = codegen(dots);
+        sym_pop(dot_name);
+        return;
+    }
+
+    bool is_signed = false;
+    Expr narrow;
+    if (!neon_intrinsics_disabled()) {
+        narrow = pairwise_add_long_operand(op, is_signed);
+    }
+    if (!narrow.defined()) {
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    const int bits = narrow.type().bits();
+    const int pairs_lanes = narrow.type().lanes() / 2;
+    Type pairs_type = (is_signed ? Int(bits * 2) : UInt(bits * 2)).with_lanes(pairs_lanes);
+    string intrin = pairwise_add_long_intrin(target, "dl", narrow.type(), is_signed);
+    string pairs_name = unique_name('t');
+    sym_push(pairs_name, call_intrin(pairs_type, 64 / bits, intrin, {narrow}));
+
+    // Widen the pairwise sums the rest of the way, and sum any
+    // remaining groups of them.
+    Expr pairs = Cast::make(op->type.with_lanes(pairs_lanes), Variable::make(pairs_type, pairs_name));
+    if (pairs_lanes > op->type.lanes()) {
+        pairs = VectorReduce::make(VectorReduce::Add, pairs, op->type.lanes());
+    }
+    value = codegen(pairs);
+    sym_pop(pairs_name);
+}
+
 void CodeGen_ARM::visit(const Sub *op) {
     if (neon_intrinsics_disabled()) {
         CodeGen_Posix::visit(op);
@@ -471,7 +642,8 @@ void CodeGen_ARM::visit(const Sub *op) {
 }
 
 void CodeGen_ARM::visit(const Min *op) {
-    if (neon_intrinsics_disabled()) {
+    if (neon_intrinsics_disabled() ||
+        (op->type.is_float() && op->type.bits() == 16 && !target.has_feature(Target::ARMFp16))) {
         CodeGen_Posix::visit(op);
         return;
     }
@@ -503,13 +675,15 @@ void CodeGen_ARM::visit(const Min *op) {
         {Int(16, 4), "v4i16"},
         {Int(32, 2), "v2i32"},
         {Float(32, 2), "v2f32"},
+        {Float(16, 4), "v4f16"},
         {UInt(8, 16), "v16i8"},
         {UInt(16, 8), "v8i16"},
         {UInt(32, 4), "v4i32"},
         {Int(8, 16), "v16i8"},
         {Int(16, 8), "v8i16"},
         {Int(32, 4), "v4i32"},
-        {Float(32, 4), "v4f32"}
+        {Float(32, 4), "v4f32"},
+        {Float(16, 8), "v8f16"}
     };
 
     for (size_t i = 0; i < sizeof(patterns)/sizeof(patterns[0]); i++) {
@@ -544,7 +718,8 @@ void CodeGen_ARM::visit(const Min *op) {
 }
 
 void CodeGen_ARM::visit(const Max *op) {
-    if (neon_intrinsics_disabled()) {
+    if (neon_intrinsics_disabled() ||
+        (op->type.is_float() && op->type.bits() == 16 && !target.has_feature(Target::ARMFp16))) {
         CodeGen_Posix::visit(op);
         return;
     }
@@ -576,13 +751,15 @@ void CodeGen_ARM::visit(const Max *op) {
         {Int(16, 4), "v4i16"},
         {Int(32, 2), "v2i32"},
         {Float(32, 2), "v2f32"},
+        {Float(16, 4), "v4f16"},
         {UInt(8, 16), "v16i8"},
         {UInt(16, 8), "v8i16"},
         {UInt(32, 4), "v4i32"},
         {Int(8, 16), "v16i8"},
         {Int(16, 8), "v8i16"},
         {Int(32, 4), "v4i32"},
-        {Float(32, 4), "v4f32"}
+        {Float(32, 4), "v4f32"},
+        {Float(16, 8), "v8f16"}
     };
 
     for (size_t i = 0; i < sizeof(patterns)/sizeof(patterns[0]); i++) {
@@ -972,21 +1149,31 @@ string CodeGen_ARM::mcpu() const {
 }
 
 string CodeGen_ARM::mattrs() const {
+    string arch_flags;
     if (target.bits == 32) {
         if (target.has_feature(Target::ARMv7s)) {
-            return "+neon";
+            arch_flags = "+neon";
         } if (!target.has_feature(Target::NoNEON)) {
-            return "+neon";
+            arch_flags = "+neon";
         } else {
-            return "-neon";
+            arch_flags = "-neon";
         }
     } else {
         if (target.os == Target::IOS || target.os == Target::OSX) {
-            return "+reserve-x18";
-        } else {
-            return "";
+            arch_flags = "+reserve-x18";
         }
     }
+
+    // The ARMv8.2 extensions.
+    #if LLVM_VERSION >= 60
+    if (target.has_feature(Target::ARMDotProd)) {
+        arch_flags += arch_flags.empty() ? "+dotprod" : ",+dotprod";
+    }
+    #endif
+    if (target.has_feature(Target::ARMFp16)) {
+        arch_flags += arch_flags.empty() ? "+fullfp16" : ",+fullfp16";
+    }
+    return arch_flags;
 }
 
 bool CodeGen_ARM::use_soft_float_abi() const {
@@ -20,6 +20,11 @@ protected:
 
     Expr sorted_avg(Expr a, Expr b);
 
+    /** Call the ARMv8.2 dot product instruction op ("sdot" or "udot"),
+     * which adds the sums of groups of four products of the 8-bit
+     * lanes of a and b to the 32-bit lanes of acc. */
+    llvm::Value *call_dot_product(Type t, const std::string &op, Expr acc, Expr a, Expr b);
+
     using CodeGen_Posix::visit;
 
     /** Nodes for which we want to emit specific neon intrinsics */
@@ -34,6 +39,7 @@ protected:
     void visit(const Store *);
     void visit(const Load *);
     void visit(const Call *);
+    void visit(const VectorReduce *);
     // @}
 
     /** Various patterns to peephole match against */
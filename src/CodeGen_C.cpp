@@ -180,13 +180,23 @@ public:
         IRGraphVisitor::include(e);
     }
 
-    // GCC's __builtin_shuffle takes an integer vector of
-    // the size of its input vector. Make sure this type exists.
+    // Shuffles of more than two vectors concatenate them first. Make
+    // sure the type of the concatenation exists.
     void visit(const Shuffle *op) {
-        vector_types_used.insert(Int(32, op->vectors[0].type().lanes()));
+        if (op->vectors.size() > 2) {
+            Type t = op->vectors[0].type();
+            t = t.with_lanes(t.lanes() * (int) op->vectors.size());
+            vector_types_used.insert(t.is_bool() ? UInt(8, t.lanes()) : t);
+        }
         IRGraphVisitor::visit(op);
     }
 
+    // Horizontal reductions are emitted as a sequence of shuffles and
+    // binary operators on narrower vectors.
+    void visit(const VectorReduce *op) {
+        lower_vector_reduce(op).accept(this);
+    }
+
     void visit(const For *op) {
         for_types_used.insert(op->for_type);
         IRGraphVisitor::visit(op);
@@ -305,6 +315,11 @@ string type_to_c_type(Type type, bool include_space, bool c_plus_plus = true) {
     bool needs_space = true;
     ostringstream oss;
 
+    if (type.is_bfloat()) {
+        // bfloat16 values are carried around as their bits.
+        type = type.with_code(Type::UInt);
+    }
+
     if (type.is_float()) {
         if (type.bits() == 32) {
             oss << "float";
@@ -404,6 +419,15 @@ string type_to_c_type(Type type, bool include_space, bool c_plus_plus = true) {
     return oss.str();
 }
 
+// The shuffle indices that reverse a vector.
+vector<int> reversed_indices(int lanes) {
+    vector<int> indices(lanes);
+    for (int i = 0; i < lanes; i++) {
+        indices[i] = lanes - 1 - i;
+    }
+    return indices;
+}
+
 }
 
 void CodeGen_C::add_vector_typedefs(const std::set<Type> &vector_types) {
@@ -490,7 +514,12 @@ public:
         }
     }
 
-    static Vec shuffle(const Vec &a, const int32_t indices[Lanes]) {
+    // Select lanes of a vector with the same element type; an index of
+    // -1 leaves the corresponding lane undefined.
+    template<int... Indices, typename InputVec>
+    static Vec shuffle(const InputVec &a) {
+        static_assert(sizeof...(Indices) == Lanes, "Lanes mismatch");
+        const int32_t indices[Lanes] = { Indices... };
         Vec r(empty);
         for (size_t i = 0; i < Lanes; i++) {
             if (indices[i] < 0) {
@@ -501,6 +530,21 @@ public:
         return r;
     }
 
+    // Select lanes of the concatenation of two vectors.
+    template<int... Indices, typename InputVec>
+    static Vec shuffle(const InputVec &a, const InputVec &b) {
+        static_assert(sizeof...(Indices) == Lanes, "Lanes mismatch");
+        const int32_t indices[Lanes] = { Indices... };
+        Vec r(empty);
+        for (size_t i = 0; i < Lanes; i++) {
+            if (indices[i] < 0) {
+                continue;
+            }
+            r.elements[i] = indices[i] < (int32_t) InputVec::Lanes ? a[indices[i]] : b[indices[i] - InputVec::Lanes];
+        }
+        return r;
+    }
+
     template<size_t InputLanes>
     static Vec concat(size_t count, const CppVector<ElementType, InputLanes> vecs[]) {
         Vec r(empty);
@@ -528,6 +572,14 @@ public:
         return r;
     }
 
+    Mask operator!() const {
+        Mask r;
+        for (size_t i = 0; i < Lanes; i++) {
+            r.elements[i] = !elements[i] ? 0xff : 0x00;
+        }
+        return r;
+    }
+
     friend Vec operator+(const Vec &a, const Vec &b) {
         Vec r(empty);
         for (size_t i = 0; i < Lanes; i++) {
@@ -591,6 +643,27 @@ public:
         }
         return r;
     }
+    friend Vec operator^(const Vec &a, const Vec &b) {
+        Vec r(empty);
+        for (size_t i = 0; i < Lanes; i++) {
+            r.elements[i] = a[i] ^ b[i];
+        }
+        return r;
+    }
+    friend Mask operator&&(const Vec &a, const Vec &b) {
+        Mask r;
+        for (size_t i = 0; i < Lanes; i++) {
+            r.elements[i] = a[i] && b[i] ? 0xff : 0x00;
+        }
+        return r;
+    }
+    friend Mask operator||(const Vec &a, const Vec &b) {
+        Mask r;
+        for (size_t i = 0; i < Lanes; i++) {
+            r.elements[i] = a[i] || b[i] ? 0xff : 0x00;
+        }
+        return r;
+    }
 
     friend Vec operator+(const Vec &a, const ElementType &b) {
         Vec r(empty);
@@ -817,6 +890,13 @@ private:
 
         const char *native_vector_decl = R"INLINE_CODE(
 #if __has_attribute(ext_vector_type) || __has_attribute(vector_size)
+// The signed integer type of the given size in bytes.
+template <size_t Bytes> struct halide_cpp_int_of_size;
+template <> struct halide_cpp_int_of_size<1> { typedef int8_t type; };
+template <> struct halide_cpp_int_of_size<2> { typedef int16_t type; };
+template <> struct halide_cpp_int_of_size<4> { typedef int32_t type; };
+template <> struct halide_cpp_int_of_size<8> { typedef int64_t type; };
+
 template <typename ElementType_, size_t Lanes_>
 class NativeVector {
 public:
@@ -890,16 +970,40 @@ public:
         }
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
-    static Vec shuffle(const Vec &a, const int32_t indices[Lanes]) {
-        Vec r(empty);
-        for (size_t i = 0; i < Lanes; i++) {
-            if (indices[i] < 0) {
-                continue;
-            }
-            r.native_vector[i] = a[indices[i]];
-        }
-        return r;
+    // Select lanes of a vector with the same element type; an index of
+    // -1 leaves the corresponding lane undefined.
+    template<int... Indices, size_t InputLanes>
+    static Vec shuffle(const NativeVector<ElementType, InputLanes> &a) {
+        static_assert(sizeof...(Indices) == Lanes, "Lanes mismatch");
+#if __has_builtin(__builtin_shufflevector)
+        return Vec(from_native_vector, __builtin_shufflevector(a.native_vector, a.native_vector, Indices...));
+#else
+        return shuffle_lanes<Indices...>(a, a);
+#endif
+    }
+
+    // Select lanes of the concatenation of two vectors.
+    template<int... Indices, size_t InputLanes>
+    static Vec shuffle(const NativeVector<ElementType, InputLanes> &a, const NativeVector<ElementType, InputLanes> &b) {
+        static_assert(sizeof...(Indices) == Lanes, "Lanes mismatch");
+#if __has_builtin(__builtin_shufflevector)
+        return Vec(from_native_vector, __builtin_shufflevector(a.native_vector, b.native_vector, Indices...));
+#else
+        return shuffle_lanes<Indices...>(a, b);
+#endif
+    }
+
+    // The input might be a CppVector (e.g. when GCC rejects its width).
+    template<int... Indices, typename InputVec>
+    static Vec shuffle(const InputVec &a) {
+        static_assert(sizeof...(Indices) == Lanes, "Lanes mismatch");
+        return shuffle_lanes<Indices...>(a, a);
+    }
+
+    template<int... Indices, typename InputVec>
+    static Vec shuffle(const InputVec &a, const InputVec &b) {
+        static_assert(sizeof...(Indices) == Lanes, "Lanes mismatch");
+        return shuffle_lanes<Indices...>(a, b);
     }
 
     // TODO: this should be improved by taking advantage of native operator support.
@@ -954,6 +1058,9 @@ public:
     friend Vec operator|(const Vec &a, const Vec &b) {
         return Vec(from_native_vector, a.native_vector | b.native_vector);
     }
+    friend Vec operator^(const Vec &a, const Vec &b) {
+        return Vec(from_native_vector, a.native_vector ^ b.native_vector);
+    }
 
     friend Vec operator+(const Vec &a, const ElementType &b) {
         return Vec(from_native_vector, a.native_vector + b);
@@ -1011,67 +1118,55 @@ public:
         return Vec(from_native_vector, a | b.native_vector);
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
     friend Mask operator<(const Vec &a, const Vec &b) {
-        Mask r;
-        for (size_t i = 0; i < Lanes; i++) {
-            r.native_vector[i] = a[i] < b[i] ? 0xff : 0x00;
-        }
-        return r;
+        return to_mask(a.native_vector < b.native_vector);
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
     friend Mask operator<=(const Vec &a, const Vec &b) {
-        Mask r;
-        for (size_t i = 0; i < Lanes; i++) {
-            r.native_vector[i] = a[i] <= b[i] ? 0xff : 0x00;
-        }
-        return r;
+        return to_mask(a.native_vector <= b.native_vector);
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
     friend Mask operator>(const Vec &a, const Vec &b) {
-        Mask r;
-        for (size_t i = 0; i < Lanes; i++) {
-            r.native_vector[i] = a[i] > b[i] ? 0xff : 0x00;
-        }
-        return r;
+        return to_mask(a.native_vector > b.native_vector);
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
     friend Mask operator>=(const Vec &a, const Vec &b) {
-        Mask r;
-        for (size_t i = 0; i < Lanes; i++) {
-            r.native_vector[i] = a[i] >= b[i] ? 0xff : 0x00;
-        }
-        return r;
+        return to_mask(a.native_vector >= b.native_vector);
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
     friend Mask operator==(const Vec &a, const Vec &b) {
-        Mask r;
-        for (size_t i = 0; i < Lanes; i++) {
-            r.native_vector[i] = a[i] == b[i] ? 0xff : 0x00;
-        }
-        return r;
+        return to_mask(a.native_vector == b.native_vector);
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
     friend Mask operator!=(const Vec &a, const Vec &b) {
-        Mask r;
-        for (size_t i = 0; i < Lanes; i++) {
-            r.native_vector[i] = a[i] != b[i] ? 0xff : 0x00;
-        }
-        return r;
+        return to_mask(a.native_vector != b.native_vector);
+    }
+
+    friend Mask operator&&(const Vec &a, const Vec &b) {
+        return to_mask((a.native_vector != 0) & (b.native_vector != 0));
+    }
+
+    friend Mask operator||(const Vec &a, const Vec &b) {
+        return to_mask((a.native_vector != 0) | (b.native_vector != 0));
+    }
+
+    Mask operator!() const {
+        return to_mask(native_vector == 0);
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
     static Vec select(const Mask &cond, const Vec &true_value, const Vec &false_value) {
+#if __has_builtin(__builtin_convertvector)
+        // Widen the mask to the width of the lanes and blend bitwise.
+        typedef typename halide_cpp_int_of_size<sizeof(ElementType)>::type SignedElementType;
+        typedef typename NativeVector<SignedElementType, Lanes>::NativeVectorType SignedVectorType;
+        return blend(__builtin_convertvector(cond.native_vector, SignedVectorType) != 0, true_value, false_value);
+#else
         Vec r(empty);
         for (size_t i = 0; i < Lanes; i++) {
             r.native_vector[i] = cond[i] ? true_value[i] : false_value[i];
         }
         return r;
+#endif
     }
 
     template <typename OtherVec>
@@ -1079,37 +1174,32 @@ public:
         #if __cplusplus >= 201103L
         static_assert(Vec::Lanes == OtherVec::Lanes, "Lanes mismatch");
         #endif
-#if 0 // __has_builtin(__builtin_convertvector)
-        // Disabled (for now) because __builtin_convertvector appears to have
-        // different float->int rounding behavior in at least some situations;
-        // for now we'll use the much-slower-but-correct explicit C++ code.
+#if __has_builtin(__builtin_convertvector)
+        // __builtin_convertvector appears to have different float->int
+        // rounding behavior in at least some situations, so use the
+        // much-slower-but-correct explicit C++ code for those.
         // (https://github.com/halide/Halide/issues/2080)
-        return Vec(from_native_vector, __builtin_convertvector(src.native_vector, NativeVectorType));
-#else
+        const bool from_float = (typename OtherVec::ElementType) 0.5 != 0;
+        const bool to_float = (ElementType) 0.5 != 0;
+        if (!from_float || to_float) {
+            return Vec(from_native_vector, __builtin_convertvector(src.native_vector, NativeVectorType));
+        }
+#endif
         Vec r(empty);
         for (size_t i = 0; i < Lanes; i++) {
             r.native_vector[i] = static_cast<typename Vec::ElementType>(src.native_vector[i]);
         }
         return r;
-#endif
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
+    // clang doesn't support the ternary operator on OpenCL style vectors,
+    // so min and max blend the lanes with the result of the comparison.
     static Vec max(const Vec &a, const Vec &b) {
-        Vec r(empty);
-        for (size_t i = 0; i < Lanes; i++) {
-            r.native_vector[i] = ::halide_cpp_max(a[i], b[i]);
-        }
-        return r;
+        return blend(a.native_vector > b.native_vector, a, b);
     }
 
-    // TODO: this should be improved by taking advantage of native operator support.
     static Vec min(const Vec &a, const Vec &b) {
-        Vec r(empty);
-        for (size_t i = 0; i < Lanes; i++) {
-            r.native_vector[i] = ::halide_cpp_min(a[i], b[i]);
-        }
-        return r;
+        return blend(a.native_vector < b.native_vector, a, b);
     }
 
 private:
@@ -1126,6 +1216,41 @@ private:
     inline NativeVector(FromNativeVector, const NativeVectorType &src) {
         native_vector = src;
     }
+
+    // Comparisons of native vectors produce a vector of signed integers
+    // of the same width as the lanes, with all bits set in the lanes
+    // for which the comparison is true.
+    template <typename ComparisonVectorType>
+    static Mask to_mask(const ComparisonVectorType &cmp) {
+#if __has_builtin(__builtin_convertvector)
+        return Mask(Mask::from_native_vector, __builtin_convertvector(cmp, typename Mask::NativeVectorType));
+#else
+        Mask r(Mask::empty);
+        for (size_t i = 0; i < Lanes; i++) {
+            r.native_vector[i] = cmp[i] ? 0xff : 0x00;
+        }
+        return r;
+#endif
+    }
+
+    template <typename ComparisonVectorType>
+    static Vec blend(const ComparisonVectorType &cmp, const Vec &true_value, const Vec &false_value) {
+        return Vec(from_native_vector, (NativeVectorType)((cmp & (ComparisonVectorType)true_value.native_vector) |
+                                                          (~cmp & (ComparisonVectorType)false_value.native_vector)));
+    }
+
+    template <int... Indices, typename InputVec>
+    static Vec shuffle_lanes(const InputVec &a, const InputVec &b) {
+        const int32_t indices[Lanes] = { Indices... };
+        Vec r(empty);
+        for (size_t i = 0; i < Lanes; i++) {
+            if (indices[i] < 0) {
+                continue;
+            }
+            r.native_vector[i] = indices[i] < (int32_t) InputVec::Lanes ? a[indices[i]] : b[indices[i] - InputVec::Lanes];
+        }
+        return r;
+    }
 };
 #endif  // __has_attribute(ext_vector_type) || __has_attribute(vector_size)
 
@@ -2133,6 +2258,10 @@ void CodeGen_C::visit(const Call *op) {
         rhs << "__builtin_prefetch("
             << "((" << print_type(op->type) << " *)" << print_name(base->name)
             << " + " << print_expr(op->args[1]) << "), 1)";
+    } else if (op->is_intrinsic(Call::nontemporal)) {
+        // The C backend emits ordinary stores.
+        internal_assert(op->args.size() == 1);
+        rhs << print_expr(op->args[0]);
     } else if (op->is_intrinsic(Call::indeterminate_expression)) {
         user_error << "Indeterminate expression occurred during constant-folding.\n";
     } else if (op->is_intrinsic(Call::size_of_halide_buffer_t)) {
@@ -2202,6 +2331,13 @@ void CodeGen_C::visit(const Load *op) {
         internal_assert(t.is_vector());
         string id_ramp_base = print_expr(dense_ramp_base);
         rhs << print_type(t) + "::load(" << name << ", " << id_ramp_base << ")";
+    } else if (strided_ramp_base(op->index, -1).defined()) {
+        // If we're loading a reversed contiguous ramp, load the vector
+        // and reverse it.
+        Expr base = simplify(strided_ramp_base(op->index, -1) - (t.lanes() - 1));
+        string id_ramp_base = print_expr(base);
+        string id_loaded = print_assignment(t, print_type(t) + "::load(" + name + ", " + id_ramp_base + ")");
+        rhs << print_type(t) << "::shuffle<" << with_commas(reversed_indices(t.lanes())) << ">(" << id_loaded << ")";
     } else if (op->index.type().is_vector()) {
         // If index is a vector, gather vector elements.
         internal_assert(t.is_vector());
@@ -2239,6 +2375,15 @@ void CodeGen_C::visit(const Store *op) {
         string id_ramp_base = print_expr(dense_ramp_base);
         do_indent();
         stream << id_value + ".store(" << name << ", " << id_ramp_base << ");\n";
+    } else if (strided_ramp_base(op->index, -1).defined()) {
+        // If we're writing a reversed contiguous ramp, reverse the
+        // vector and store it.
+        internal_assert(t.is_vector());
+        Expr base = simplify(strided_ramp_base(op->index, -1) - (t.lanes() - 1));
+        string id_ramp_base = print_expr(base);
+        string id_reversed = print_assignment(t, print_type(t) + "::shuffle<" + with_commas(reversed_indices(t.lanes())) + ">(" + id_value + ")");
+        do_indent();
+        stream << id_reversed + ".store(" << name << ", " << id_ramp_base << ");\n";
     } else if (op->index.type().is_vector()) {
         // If index is a vector, scatter vector elements.
         internal_assert(t.is_vector());
@@ -2593,28 +2738,30 @@ void CodeGen_C::visit(const Shuffle *op) {
     for (Expr v : op->vectors) {
         vecs.push_back(print_expr(v));
     }
-    string src = vecs[0];
-    if (op->vectors.size() > 1) {
-        ostringstream rhs;
-        string storage_name = unique_name('_');
-        do_indent();
-        stream << "const " << print_type(op->vectors[0].type()) << " " << storage_name << "[] = { " << with_commas(vecs) << " };\n";
-
-        rhs << print_type(op->type) << "::concat(" << op->vectors.size() << ", " << storage_name << ")";
-        src = print_assignment(op->type, rhs.str());
-    }
     ostringstream rhs;
     if (op->type.is_scalar()) {
-        rhs << src << "[" << op->indices[0] << "]";
+        const int input_lanes = op->vectors[0].type().lanes();
+        rhs << vecs[op->indices[0] / input_lanes] << "[" << op->indices[0] % input_lanes << "]";
     } else {
-        string indices_name = unique_name('_');
-        do_indent();
-        stream << "const int32_t " << indices_name << "[" << op->indices.size() << "] = { " << with_commas(op->indices) << " };\n";
-        rhs << print_type(op->type) << "::shuffle(" << src << ", " << indices_name << ")";
+        if (op->vectors.size() > 2) {
+            // Concatenate the vectors into one, and shuffle that.
+            Type t = op->vectors[0].type().with_lanes(max_index);
+            string storage_name = unique_name('_');
+            do_indent();
+            stream << "const " << print_type(op->vectors[0].type()) << " " << storage_name << "[] = { " << with_commas(vecs) << " };\n";
+            vecs = {print_assignment(t, print_type(t) + "::concat(" + std::to_string(op->vectors.size()) + ", " + storage_name + ")")};
+        }
+        // The indices are template arguments, so that they are
+        // compile-time constants for __builtin_shufflevector.
+        rhs << print_type(op->type) << "::shuffle<" << with_commas(op->indices) << ">(" << with_commas(vecs) << ")";
     }
     print_assignment(op->type, rhs.str());
 }
 
+void CodeGen_C::visit(const VectorReduce *op) {
+    id = print_expr(lower_vector_reduce(op));
+}
+
 void CodeGen_C::test() {
     LoweredArgument buffer_arg("buf", Argument::OutputBuffer, Int(32), 3);
     LoweredArgument float_arg("alpha", Argument::InputScalar, Float(32), 0);
@@ -111,7 +111,10 @@ void unpack_closure(const Closure& closure,
 
 llvm::Type *llvm_type_of(LLVMContext *c, Halide::Type t) {
     if (t.lanes() == 1) {
-        if (t.is_float()) {
+        if (t.is_bfloat()) {
+            // LLVM has no bfloat type, so carry around the bits.
+            return llvm::Type::getIntNTy(*c, t.bits());
+        } else if (t.is_float()) {
             switch (t.bits()) {
             case 16:
                 return llvm::Type::getHalfTy(*c);
@@ -270,6 +273,75 @@ Expr lower_euclidean_mod(Expr a, Expr b) {
     }
 }
 
+Expr lower_vector_reduce(const VectorReduce *op) {
+    auto binop = [=](Expr a, Expr b) -> Expr {
+        switch (op->op) {
+        case VectorReduce::Add:
+            return Add::make(a, b);
+        case VectorReduce::Mul:
+            return Mul::make(a, b);
+        case VectorReduce::Min:
+            return Min::make(a, b);
+        case VectorReduce::Max:
+            return Max::make(a, b);
+        case VectorReduce::And:
+            return And::make(a, b);
+        case VectorReduce::Or:
+            return Or::make(a, b);
+        }
+        return Expr();
+    };
+
+    const int lanes = op->type.lanes();
+    Expr v = op->value;
+    int factor = v.type().lanes() / lanes;
+    vector<pair<string, Expr>> lets;
+
+    // Bind each intermediate vector to a Let, so that it is only
+    // computed once despite being sliced twice.
+    auto bind = [&](Expr e) {
+        string name = unique_name('t');
+        lets.push_back({name, e});
+        return Variable::make(e.type(), name);
+    };
+
+    if (lanes == 1) {
+        // A total reduction. Repeatedly add the top half of the
+        // vector to the bottom half.
+        while (factor > 1 && factor % 2 == 0) {
+            int half = factor / 2;
+            v = bind(v);
+            v = binop(Shuffle::make_slice(v, 0, 1, half),
+                      Shuffle::make_slice(v, half, 1, half));
+            factor = half;
+        }
+    } else {
+        // A partial reduction. Combine adjacent pairs of lanes.
+        while (factor > 1 && factor % 2 == 0) {
+            int n = v.type().lanes() / 2;
+            v = bind(v);
+            v = binop(Shuffle::make_slice(v, 0, 2, n),
+                      Shuffle::make_slice(v, 1, 2, n));
+            factor /= 2;
+        }
+    }
+
+    if (factor > 1) {
+        // Combine any remaining odd factor one strided slice at a time.
+        v = bind(v);
+        Expr result = Shuffle::make_slice(v, 0, factor, lanes);
+        for (int i = 1; i < factor; i++) {
+            result = binop(result, Shuffle::make_slice(v, i, factor, lanes));
+        }
+        v = result;
+    }
+
+    for (size_t i = lets.size(); i > 0; i--) {
+        v = Let::make(lets[i-1].first, lets[i-1].second, v);
+    }
+    return v;
+}
+
 namespace {
 
 // This mutator rewrites predicated loads and stores as unpredicated
@@ -62,6 +62,11 @@ Expr lower_euclidean_div(Expr a, Expr b);
 Expr lower_euclidean_mod(Expr a, Expr b);
 ///@}
 
+/** Given a VectorReduce node, define it in terms of shuffles and
+ * ordinary vector arithmetic, for targets without a native horizontal
+ * reduction for it. */
+Expr lower_vector_reduce(const VectorReduce *op);
+
 /** Replace predicated loads/stores with unpredicated equivalents
  * inside branches. */
 Stmt unpredicate_loads_stores(Stmt s);
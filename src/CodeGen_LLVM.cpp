@@ -250,7 +250,9 @@ CodeGen_LLVM::CodeGen_LLVM(Target t) :
 
     min_f64(Float(64).min()),
     max_f64(Float(64).max()),
-    destructor_block(nullptr) {
+    destructor_block(nullptr),
+    store_nontemporal(false),
+    emitted_nontemporal_stores(false) {
     initialize_llvm();
 }
 
@@ -690,7 +692,9 @@ void CodeGen_LLVM::compile_func(const LoweredFunc &f, const std::string &simple_
 
      // Generate the function body.
     debug(1) << "Generating llvm bitcode for function " << f.name << "...\n";
+    emitted_nontemporal_stores = false;
     f.body.accept(this);
+    fence_nontemporal_stores();
 
     // Clean up and return.
     end_func(f.args);
@@ -1127,7 +1131,13 @@ void CodeGen_LLVM::visit(const UIntImm *op) {
 }
 
 void CodeGen_LLVM::visit(const FloatImm *op) {
-    value = ConstantFP::get(llvm_type_of(op->type), op->value);
+    if (op->type.is_bfloat()) {
+        // Only reachable via argument metadata; bfloat16 math has
+        // already been lowered to operations on the bits.
+        value = ConstantInt::get(llvm_type_of(op->type), bfloat16_t(op->value).to_bits());
+    } else {
+        value = ConstantFP::get(llvm_type_of(op->type), op->value);
+    }
 }
 
 void CodeGen_LLVM::visit(const StringImm *op) {
@@ -2650,6 +2660,11 @@ void CodeGen_LLVM::visit(const Call *op) {
             " Halide.\n";
     } else if (op->is_intrinsic(Call::indeterminate_expression)) {
         user_error << "Indeterminate expression occurred during constant-folding.\n";
+    } else if (op->is_intrinsic(Call::nontemporal)) {
+        // Only meaningful as the value of a store, which is handled
+        // in visit(const Store *).
+        internal_assert(op->args.size() == 1);
+        value = codegen(op->args[0]);
     } else if (op->is_intrinsic(Call::size_of_halide_buffer_t)) {
         llvm::DataLayout d(module.get());
         value = ConstantInt::get(i32_t, (int)d.getTypeAllocSize(buffer_t_type));
@@ -3057,7 +3072,11 @@ void CodeGen_LLVM::visit(const For *op) {
         unpack_closure(closure, symbol_table, closure_t, closure_handle, builder);
 
         // Generate the new function body
+        bool parent_emitted_nontemporal_stores = emitted_nontemporal_stores;
+        emitted_nontemporal_stores = false;
         codegen(op->body);
+        fence_nontemporal_stores();
+        emitted_nontemporal_stores = parent_emitted_nontemporal_stores;
 
         // Return success
         return_with_error_code(ConstantInt::get(i32_t, 0));
@@ -3095,7 +3114,26 @@ void CodeGen_LLVM::visit(const For *op) {
     }
 }
 
+void CodeGen_LLVM::fence_nontemporal_stores() {
+    if (emitted_nontemporal_stores) {
+        builder->CreateFence(AtomicOrdering::SequentiallyConsistent);
+        emitted_nontemporal_stores = false;
+    }
+}
+
 void CodeGen_LLVM::visit(const Store *op) {
+    // Stores marked as non-temporal by inject_nontemporal_stores.
+    if (const Call *c = op->value.as<Call>()) {
+        if (c->is_intrinsic(Call::nontemporal)) {
+            internal_assert(c->args.size() == 1);
+            bool old_store_nontemporal = store_nontemporal;
+            store_nontemporal = true;
+            codegen(Store::make(op->name, c->args[0], op->index, op->param, op->predicate));
+            store_nontemporal = old_store_nontemporal;
+            return;
+        }
+    }
+
     // Even on 32-bit systems, Handles are treated as 64-bit in
     // memory, so convert stores of handles to stores of uint64_ts.
     if (op->value.type().is_handle()) {
@@ -3162,6 +3200,12 @@ void CodeGen_LLVM::visit(const Store *op) {
                 Value *vec_ptr = builder->CreatePointerCast(elt_ptr, slice_val->getType()->getPointerTo());
                 StoreInst *store = builder->CreateAlignedStore(slice_val, vec_ptr, alignment);
                 add_tbaa_metadata(store, op->name, slice_index);
+                // Non-temporal stores must be aligned to the size of the vector.
+                if (store_nontemporal && alignment >= slice_lanes * value_type.bytes()) {
+                    llvm::Metadata *one = ConstantAsMetadata::get(ConstantInt::get(i32_t, 1));
+                    store->setMetadata(LLVMContext::MD_nontemporal, MDNode::get(*context, one));
+                    emitted_nontemporal_stores = true;
+                }
             }
         } else if (ramp) {
             Type ptr_type = value_type.element_of();
@@ -3271,6 +3315,11 @@ void CodeGen_LLVM::visit(const Shuffle *op) {
     }
 }
 
+void CodeGen_LLVM::visit(const VectorReduce *op) {
+    // Targets with native horizontal reductions override this.
+    value = codegen(lower_vector_reduce(op));
+}
+
 Value *CodeGen_LLVM::create_alloca_at_entry(llvm::Type *t, int n, bool zero_initialize, const string &name) {
     IRBuilderBase::InsertPoint here = builder->saveIP();
     BasicBlock *entry = &builder->GetInsertBlock()->getParent()->getEntryBlock();
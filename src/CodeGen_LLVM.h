@@ -257,6 +257,11 @@ protected:
      * the destructor block. */
     void return_with_error_code(llvm::Value *error_code);
 
+    /** If any non-temporal stores have been emitted in the current
+     * function, emit a fence so that they are visible to other
+     * threads before it returns. */
+    void fence_nontemporal_stores();
+
     /** Put a string constant in the module as a global variable and return a pointer to it. */
     llvm::Constant *create_string_constant(const std::string &str);
 
@@ -344,6 +349,7 @@ protected:
     virtual void visit(const Evaluate *);
     virtual void visit(const Shuffle *);
     virtual void visit(const Prefetch *);
+    virtual void visit(const VectorReduce *);
     // @}
 
     /** Generate code for an allocate node. It has no default
@@ -457,6 +463,14 @@ private:
      * to this block. */
     llvm::BasicBlock *destructor_block;
 
+    /** Whether the store being generated is non-temporal, and whether
+     * any non-temporal stores have been emitted in the current
+     * function. Non-temporal stores are weakly ordered, so a function
+     * that emits them must end with a fence. */
+    // @{
+    bool store_nontemporal, emitted_nontemporal_stores;
+    // @}
+
     /** Embed an instance of halide_filter_metadata_t in the code, using
      * the given name (by convention, this should be ${FUNCTIONNAME}_metadata)
      * as extern "C" linkage. Note that the return value is a function-returning-
@@ -60,12 +60,84 @@ bool should_use_pmaddwd(Expr a, Expr b, vector<Expr> &result) {
     return true;
 }
 
+void collect_summands(Expr e, vector<Expr> &terms) {
+    if (const Add *add = e.as<Add>()) {
+        collect_summands(add->a, terms);
+        collect_summands(add->b, terms);
+    } else {
+        terms.push_back(e);
+    }
+}
+
+// acc + i32(u8_a)*i32(i8_b) + i32(u8_c)*i32(i8_d) + ... (four
+// products) can be done with vpdpbusd, and acc + i32(i16_a)*i32(i16_b)
+// + i32(i16_c)*i32(i16_d) with vpdpwssd. These add the sums of the
+// products of adjacent bytes or words within each 32-bit lane to the
+// accumulator, so we interleave the narrowed factors. The remaining
+// summands become the accumulator.
+bool should_use_vnni(const Add *op, string &intrin, vector<Expr> &result) {
+    Type t = op->type;
+
+    if (!(t.is_int() && t.bits() == 32 && t.lanes() >= 16)) {
+        return false;
+    }
+
+    vector<Expr> terms;
+    collect_summands(op, terms);
+
+    for (bool bytes : {true, false}) {
+        const size_t products = bytes ? 4 : 2;
+        Type narrow_a = bytes ? UInt(8, t.lanes()) : Int(16, t.lanes());
+        Type narrow_b = bytes ? Int(8, t.lanes()) : Int(16, t.lanes());
+
+        vector<Expr> a, b;
+        Expr acc;
+        for (const Expr &term : terms) {
+            const Mul *mul = term.as<Mul>();
+            Expr ma, mb;
+            if (mul && a.size() < products) {
+                ma = lossless_cast(narrow_a, mul->a);
+                mb = lossless_cast(narrow_b, mul->b);
+                if (!ma.defined() || !mb.defined()) {
+                    ma = lossless_cast(narrow_a, mul->b);
+                    mb = lossless_cast(narrow_b, mul->a);
+                }
+            }
+            if (ma.defined() && mb.defined()) {
+                a.push_back(ma);
+                b.push_back(mb);
+            } else {
+                acc = acc.defined() ? acc + term : term;
+            }
+        }
+
+        if (a.size() < products) {
+            continue;
+        }
+        if (!acc.defined()) {
+            acc = make_zero(t);
+        }
+
+        result = {acc,
+                  reinterpret(t, Shuffle::make_interleave(a)),
+                  reinterpret(t, Shuffle::make_interleave(b)),
+                  make_const(Int(16), -1)};
+        intrin = bytes ? "llvm.x86.avx512.mask.vpdpbusd.512" : "llvm.x86.avx512.mask.vpdpwssd.512";
+        return true;
+    }
+    return false;
+}
+
 }
 
 
 void CodeGen_X86::visit(const Add *op) {
     vector<Expr> matches;
-    if (should_use_pmaddwd(op->a, op->b, matches)) {
+    string intrin;
+    if (LLVM_VERSION >= 60 && target.has_feature(Target::AVX512_VNNI) &&
+        should_use_vnni(op, intrin, matches)) {
+        value = call_intrin(op->type, 16, intrin, matches);
+    } else if (should_use_pmaddwd(op->a, op->b, matches)) {
         codegen(Call::make(op->type, "pmaddwd", matches, Call::Extern));
     } else {
         CodeGen_Posix::visit(op);
@@ -88,6 +160,78 @@ void CodeGen_X86::visit(const Sub *op) {
     }
 }
 
+void CodeGen_X86::visit(const VectorReduce *op) {
+    const int lanes = op->type.lanes();
+    const int input_lanes = op->value.type().lanes();
+    const int factor = input_lanes / lanes;
+
+    if (op->op != VectorReduce::Add || !(op->type.is_int() || op->type.is_uint())) {
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    // Sums of groups of eight unsigned bytes can be done with psadbw
+    // against zero, which produces one 64-bit sum per eight bytes.
+    Expr narrow = lossless_cast(UInt(8, input_lanes), op->value);
+    if (narrow.defined() && factor % 8 == 0 && input_lanes >= 16) {
+        const bool has_avx512bw = (target.has_feature(Target::AVX512_Skylake) ||
+                                   target.has_feature(Target::AVX512_Cannonlake) ||
+                                   target.has_feature(Target::AVX512_VNNI));
+        int intrin_lanes = 2;
+        string intrin = "llvm.x86.sse2.psad.bw";
+        if (LLVM_VERSION >= 40 && has_avx512bw && input_lanes >= 64) {
+            intrin_lanes = 8;
+            intrin = "llvm.x86.avx512.psad.bw.512";
+        } else if (target.has_feature(Target::AVX2) && input_lanes >= 32) {
+            intrin_lanes = 4;
+            intrin = "llvm.x86.avx2.psad.bw";
+        }
+        Type sum_type = UInt(64, input_lanes / 8);
+        string sums_name = unique_name('t');
+        sym_push(sums_name, call_intrin(sum_type, intrin_lanes, intrin,
+                                        {narrow, make_zero(narrow.type())}));
+        Expr sums = Cast::make(op->type.with_lanes(input_lanes / 8),
+                               Variable::make(sum_type, sums_name));
+        if (factor > 8) {
+            sums = VectorReduce::make(VectorReduce::Add, sums, lanes);
+        }
+        value = codegen(sums);
+        sym_pop(sums_name);
+        return;
+    }
+
+    // Sums of pairs of widened 16-bit products (or of widened 16-bit
+    // values) can be done with pmaddwd.
+    if (op->type.is_int() && op->type.bits() == 32 &&
+        factor % 2 == 0 && input_lanes / 2 >= 4) {
+        Type narrow16 = Int(16, input_lanes);
+        Expr a, b;
+        if (const Mul *mul = op->value.as<Mul>()) {
+            a = lossless_cast(narrow16, mul->a);
+            b = lossless_cast(narrow16, mul->b);
+        } else {
+            a = lossless_cast(narrow16, op->value);
+            b = make_one(narrow16);
+        }
+        if (a.defined() && b.defined()) {
+            const int pairs_lanes = input_lanes / 2;
+            Expr pairs = Call::make(Int(32, pairs_lanes), "pmaddwd",
+                                    {Shuffle::make_slice(a, 0, 2, pairs_lanes),
+                                     Shuffle::make_slice(b, 0, 2, pairs_lanes),
+                                     Shuffle::make_slice(a, 1, 2, pairs_lanes),
+                                     Shuffle::make_slice(b, 1, 2, pairs_lanes)},
+                                    Call::Extern);
+            if (factor > 2) {
+                pairs = VectorReduce::make(VectorReduce::Add, pairs, lanes);
+            }
+            value = codegen(pairs);
+            return;
+        }
+    }
+
+    CodeGen_Posix::visit(op);
+}
+
 void CodeGen_X86::visit(const GT *op) {
     if (op->type.is_vector()) {
         // Non-native vector widths get legalized poorly by llvm. We
@@ -207,6 +351,29 @@ void CodeGen_X86::visit(const Cast *op) {
         return;
     }
 
+    if (target.has_feature(Target::F16C) && target.has_feature(Target::AVX)) {
+        // Use vcvtph2ps and vcvtps2ph to convert between float16 and
+        // float32, eight lanes at a time. LLVM otherwise converts
+        // vectors of float16 one lane at a time.
+        Type src = op->value.type().element_of();
+        Type dst = op->type.element_of();
+        if (src == Float(16) && dst == Float(32)) {
+            value = call_intrin(op->type, 8, "vcvtph2psx8", {op->value});
+            return;
+        } else if (src == Float(32) && dst == Float(16)) {
+            value = call_intrin(op->type, 8, "vcvtps2phx8", {op->value});
+            return;
+        } else if (src == Float(16) ||
+                   (dst == Float(16) && (src.is_int() || src.is_uint()))) {
+            // Go via float32. Every float16 is exact in float32, and
+            // any integer that isn't exact in float32 is out of range
+            // for float16 anyway, so there's no double rounding.
+            Type f32 = Float(32, op->type.lanes());
+            codegen(Cast::make(op->type, Cast::make(f32, op->value)));
+            return;
+        }
+    }
+
     vector<Expr> matches;
 
     struct Pattern {
@@ -219,6 +386,35 @@ void CodeGen_X86::visit(const Cast *op) {
     };
 
     static Pattern patterns[] = {
+#if LLVM_VERSION >= 40
+        // Use the AVX512BW versions (from x86_avx512.ll) if we have
+        // more than 32 bytes.
+        {Target::AVX512_Skylake, true, Int(8, 64), 33, "paddsbx64",
+         i8_sat(wild_i16x_ + wild_i16x_)},
+        {Target::AVX512_Skylake, true, Int(8, 64), 33, "psubsbx64",
+         i8_sat(wild_i16x_ - wild_i16x_)},
+        {Target::AVX512_Skylake, true, UInt(8, 64), 33, "paddusbx64",
+         u8_sat(wild_u16x_ + wild_u16x_)},
+        {Target::AVX512_Skylake, true, UInt(8, 64), 33, "psubusbx64",
+         u8(max(wild_i16x_ - wild_i16x_, 0))},
+        {Target::AVX512_Skylake, true, Int(16, 32), 17, "paddswx32",
+         i16_sat(wild_i32x_ + wild_i32x_)},
+        {Target::AVX512_Skylake, true, Int(16, 32), 17, "psubswx32",
+         i16_sat(wild_i32x_ - wild_i32x_)},
+        {Target::AVX512_Skylake, true, UInt(16, 32), 17, "padduswx32",
+         u16_sat(wild_u32x_ + wild_u32x_)},
+        {Target::AVX512_Skylake, true, UInt(16, 32), 17, "psubuswx32",
+         u16(max(wild_i32x_ - wild_i32x_, 0))},
+        {Target::AVX512_Skylake, true, Int(16, 32), 17, "pmulhwx32",
+         i16((wild_i32x_ * wild_i32x_) / 65536)},
+        {Target::AVX512_Skylake, true, UInt(16, 32), 17, "pmulhuwx32",
+         u16((wild_u32x_ * wild_u32x_) / 65536)},
+        {Target::AVX512_Skylake, true, UInt(8, 64), 33, "pavgbx64",
+         u8(((wild_u16x_ + wild_u16x_) + 1) / 2)},
+        {Target::AVX512_Skylake, true, UInt(16, 32), 17, "pavgwx32",
+         u16(((wild_u32x_ + wild_u32x_) + 1) / 2)},
+#endif
+
         {Target::FeatureEnd, true, Int(8, 16), 0, "llvm.x86.sse2.padds.b",
          i8_sat(wild_i16x_ + wild_i16x_)},
         {Target::FeatureEnd, true, Int(8, 16), 0, "llvm.x86.sse2.psubs.b",
@@ -269,10 +465,19 @@ void CodeGen_X86::visit(const Cast *op) {
          u16_sat(wild_i32x_)}
     };
 
+    // AVX512BW is part of all of the AVX512 flavors from Skylake on.
+    const bool has_avx512bw = (target.has_feature(Target::AVX512_Skylake) ||
+                               target.has_feature(Target::AVX512_Cannonlake) ||
+                               target.has_feature(Target::AVX512_VNNI));
+
     for (size_t i = 0; i < sizeof(patterns)/sizeof(patterns[0]); i++) {
         const Pattern &pattern = patterns[i];
 
-        if (!target.has_feature(pattern.feature)) {
+        if (pattern.feature == Target::AVX512_Skylake) {
+            if (!has_avx512bw) {
+                continue;
+            }
+        } else if (!target.has_feature(pattern.feature)) {
             continue;
         }
 
@@ -371,7 +576,8 @@ void CodeGen_X86::visit(const Call *op) {
 string CodeGen_X86::mcpu() const {
     #if LLVM_VERSION >= 40
     if (target.has_feature(Target::AVX512_Cannonlake)) return "cannonlake";
-    if (target.has_feature(Target::AVX512_Skylake)) return "skylake-avx512";
+    if (target.has_feature(Target::AVX512_Skylake) ||
+        target.has_feature(Target::AVX512_VNNI)) return "skylake-avx512";
     if (target.has_feature(Target::AVX512_KNL)) return "knl";
     #endif
     if (target.has_feature(Target::AVX2)) return "haswell";
@@ -401,19 +607,26 @@ string CodeGen_X86::mattrs() const {
     if (target.has_feature(Target::AVX512) ||
         target.has_feature(Target::AVX512_KNL) ||
         target.has_feature(Target::AVX512_Skylake) ||
-        target.has_feature(Target::AVX512_Cannonlake)) {
+        target.has_feature(Target::AVX512_Cannonlake) ||
+        target.has_feature(Target::AVX512_VNNI)) {
         features += separator + "+avx512f,+avx512cd";
         separator = ",";
         if (target.has_feature(Target::AVX512_KNL)) {
             features += ",+avx512pf,+avx512er";
         }
         if (target.has_feature(Target::AVX512_Skylake) ||
-            target.has_feature(Target::AVX512_Cannonlake)) {
+            target.has_feature(Target::AVX512_Cannonlake) ||
+            target.has_feature(Target::AVX512_VNNI)) {
             features += ",+avx512vl,+avx512bw,+avx512dq";
         }
         if (target.has_feature(Target::AVX512_Cannonlake)) {
             features += ",+avx512ifma,+avx512vbmi";
         }
+        #if LLVM_VERSION >= 60
+        if (target.has_feature(Target::AVX512_VNNI)) {
+            features += ",+avx512vnni";
+        }
+        #endif
     }
     #endif
     return features;
@@ -427,7 +640,8 @@ int CodeGen_X86::native_vector_bits() const {
     if (target.has_feature(Target::AVX512) ||
         target.has_feature(Target::AVX512_Skylake) ||
         target.has_feature(Target::AVX512_KNL) ||
-        target.has_feature(Target::AVX512_Cannonlake)) {
+        target.has_feature(Target::AVX512_Cannonlake) ||
+        target.has_feature(Target::AVX512_VNNI)) {
         return 512;
     } else if (target.has_feature(Target::AVX) ||
                target.has_feature(Target::AVX2)) {
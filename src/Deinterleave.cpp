@@ -326,6 +326,25 @@ private:
             expr = Shuffle::make({op}, indices);
         }
     }
+
+    void visit(const VectorReduce *op) {
+        if (op->type.is_scalar()) {
+            expr = op;
+        } else {
+            // Each lane of the result reduces a group of adjacent
+            // lanes of the value, so take the groups for the lanes
+            // we want.
+            int factor = op->value.type().lanes() / op->type.lanes();
+            std::vector<int> indices;
+            for (int i = 0; i < new_lanes; i++) {
+                int idx = i * lane_stride + starting_lane;
+                for (int j = 0; j < factor; j++) {
+                    indices.push_back(idx * factor + j);
+                }
+            }
+            expr = VectorReduce::make(op->op, Shuffle::make({op->value}, indices), new_lanes);
+        }
+    }
 };
 
 Expr extract_odd_lanes(Expr e, const Scope<int> &lets) {
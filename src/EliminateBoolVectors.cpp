@@ -207,6 +207,25 @@ private:
         }
     }
 
+    void visit(const VectorReduce *op) {
+        Expr value = mutate(op->value);
+        if (value.same_as(op->value)) {
+            expr = op;
+        } else if (op->value.type().is_bool()) {
+            // The lanes are now masks of all ones or all zeros. The
+            // masks are signed, so 'and' is the max over the lanes,
+            // and 'or' is the min.
+            VectorReduce::Operator reduce_op =
+                op->op == VectorReduce::And ? VectorReduce::Max : VectorReduce::Min;
+            expr = VectorReduce::make(reduce_op, value, op->type.lanes());
+            if (op->type.is_scalar()) {
+                expr = expr != make_zero(expr.type());
+            }
+        } else {
+            expr = VectorReduce::make(op->op, value, op->type.lanes());
+        }
+    }
+
     template <typename NodeType, typename LetType>
     NodeType visit_let(const LetType *op) {
         Expr value = mutate(op->value);
@@ -0,0 +1,227 @@
+#include "EmulateFloat16Math.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+
+namespace Halide {
+namespace Internal {
+
+Expr bfloat16_to_float32(Expr e) {
+    internal_assert(e.type().is_uint() && e.type().bits() == 16);
+    int lanes = e.type().lanes();
+    e = cast(UInt(32, lanes), e);
+    e = e << make_const(UInt(32, lanes), 16);
+    return reinterpret(Float(32, lanes), e);
+}
+
+Expr float32_to_bfloat16(Expr e) {
+    internal_assert(e.type() == Float(32, e.type().lanes()));
+    Type u32 = UInt(32, e.type().lanes());
+    Expr bits = reinterpret(u32, e);
+    // Round to nearest, ties to even. Adding the rounding bias to a NaN
+    // could carry into the exponent or sign, so instead truncate NaNs
+    // and keep them quiet.
+    Expr is_nan = (bits & make_const(u32, 0x7fffffff)) > make_const(u32, 0x7f800000);
+    Expr bias = make_const(u32, 0x7fff) + ((bits >> make_const(u32, 16)) & make_const(u32, 1));
+    Expr rounded = select(is_nan, bits | make_const(u32, 0x00400000), bits + bias);
+    return cast(u32.with_bits(16), rounded >> make_const(u32, 16));
+}
+
+namespace {
+
+Type bits_type(Type t) {
+    return t.is_bfloat() ? t.with_code(Type::UInt) : t;
+}
+
+class EmulateFloat16Math : public IRMutator {
+    using IRMutator::visit;
+
+    // Whether to also do float16 math in float32.
+    bool widen_float16;
+
+    bool is_float16(Type t) {
+        return t.is_float() && t.bits() == 16;
+    }
+
+    bool needs_widening(Type t) {
+        return t.is_bfloat() || (widen_float16 && is_float16(t));
+    }
+
+    // Mutate an expression, widening it to float32 if it was a 16-bit
+    // float that we're emulating.
+    Expr widen(const Expr &e) {
+        Expr m = mutate(e);
+        if (e.type().is_bfloat()) {
+            return bfloat16_to_float32(m);
+        } else if (widen_float16 && is_float16(e.type())) {
+            return cast(Float(32, e.type().lanes()), m);
+        }
+        return m;
+    }
+
+    // Round a float32 result back to the given 16-bit float type.
+    Expr narrow(Expr e, Type t) {
+        if (t.is_bfloat()) {
+            return float32_to_bfloat16(e);
+        } else {
+            return cast(t, e);
+        }
+    }
+
+    template<typename T>
+    void visit_arith(const T *op) {
+        if (needs_widening(op->type)) {
+            expr = narrow(T::make(widen(op->a), widen(op->b)), op->type);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    template<typename T>
+    void visit_cmp(const T *op) {
+        if (needs_widening(op->a.type())) {
+            expr = T::make(widen(op->a), widen(op->b));
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Add *op) {visit_arith(op);}
+    void visit(const Sub *op) {visit_arith(op);}
+    void visit(const Mul *op) {visit_arith(op);}
+    void visit(const Div *op) {visit_arith(op);}
+    void visit(const Mod *op) {visit_arith(op);}
+    void visit(const Min *op) {visit_arith(op);}
+    void visit(const Max *op) {visit_arith(op);}
+    void visit(const EQ *op) {visit_cmp(op);}
+    void visit(const NE *op) {visit_cmp(op);}
+    void visit(const LT *op) {visit_cmp(op);}
+    void visit(const LE *op) {visit_cmp(op);}
+    void visit(const GT *op) {visit_cmp(op);}
+    void visit(const GE *op) {visit_cmp(op);}
+
+    void visit(const FloatImm *op) {
+        if (op->type.is_bfloat()) {
+            expr = UIntImm::make(UInt(16), bfloat16_t(op->value).to_bits());
+        } else {
+            expr = op;
+        }
+    }
+
+    void visit(const Cast *op) {
+        Type from = op->value.type();
+        if (op->type.is_bfloat()) {
+            Expr value = widen(op->value);
+            expr = float32_to_bfloat16(cast(Float(32, op->type.lanes()), value));
+        } else if (from.is_bfloat()) {
+            expr = cast(op->type, widen(op->value));
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Variable *op) {
+        if (op->type.is_bfloat()) {
+            expr = Variable::make(bits_type(op->type), op->name, op->image, op->param, op->reduction_domain);
+        } else {
+            expr = op;
+        }
+    }
+
+    void visit(const Load *op) {
+        if (op->type.is_bfloat()) {
+            expr = Load::make(bits_type(op->type), op->name, mutate(op->index),
+                              op->image, op->param, mutate(op->predicate));
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const VectorReduce *op) {
+        if (needs_widening(op->type)) {
+            expr = narrow(VectorReduce::make(op->op, widen(op->value), op->type.lanes()), op->type);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const For *op) {
+        if (widen_float16 &&
+            op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            // Leave float16 math on other devices alone.
+            bool old = widen_float16;
+            widen_float16 = false;
+            IRMutator::visit(op);
+            widen_float16 = old;
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Call *op) {
+        bool any_bfloat = op->type.is_bfloat();
+        for (const Expr &e : op->args) {
+            any_bfloat |= e.type().is_bfloat();
+        }
+        if (!any_bfloat) {
+            IRMutator::visit(op);
+        } else if (op->is_intrinsic(Call::abs)) {
+            // Just clear the sign bit.
+            Expr bits = mutate(op->args[0]);
+            expr = bits & make_const(bits.type(), 0x7fff);
+        } else if (op->is_intrinsic(Call::absd) ||
+                   op->is_intrinsic(Call::lerp) ||
+                   op->is_intrinsic(Call::stringify)) {
+            // These depend on the value, so do them in float.
+            std::vector<Expr> args;
+            for (const Expr &e : op->args) {
+                args.push_back(widen(e));
+            }
+            if (op->type.is_bfloat()) {
+                Type t = Float(32, op->type.lanes());
+                expr = float32_to_bfloat16(Call::make(t, op->name, args, op->call_type));
+            } else {
+                expr = Call::make(op->type, op->name, args, op->call_type);
+            }
+        } else {
+            // Everything else (reinterpret, make_struct, extern calls,
+            // etc) just moves the bits around.
+            std::vector<Expr> args;
+            for (const Expr &e : op->args) {
+                args.push_back(mutate(e));
+            }
+            expr = Call::make(bits_type(op->type), op->name, args, op->call_type,
+                              op->func, op->value_index, op->image, op->param);
+        }
+    }
+
+    void visit(const Allocate *op) {
+        if (op->type.is_bfloat()) {
+            std::vector<Expr> extents;
+            for (const Expr &e : op->extents) {
+                extents.push_back(mutate(e));
+            }
+            Expr new_expr;
+            if (op->new_expr.defined()) {
+                new_expr = mutate(op->new_expr);
+            }
+            stmt = Allocate::make(op->name, bits_type(op->type), extents,
+                                  mutate(op->condition), mutate(op->body),
+                                  new_expr, op->free_function);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    EmulateFloat16Math(bool widen_float16) : widen_float16(widen_float16) {}
+};
+
+}
+
+Stmt emulate_float16_math(Stmt s, const Target &t) {
+    return EmulateFloat16Math(t.arch == Target::X86).mutate(s);
+}
+
+}
+}
@@ -0,0 +1,39 @@
+#ifndef HALIDE_EMULATE_FLOAT16_MATH_H
+#define HALIDE_EMULATE_FLOAT16_MATH_H
+
+#include "Expr.h"
+#include "Target.h"
+
+/** \file
+ * Defines a lowering pass that lowers 16-bit float math to float32
+ * math.
+ */
+
+namespace Halide {
+namespace Internal {
+
+/** Widen the uint16 bits of a bfloat16 to a float32. This is exact. */
+Expr bfloat16_to_float32(Expr e);
+
+/** Round a float32 to the nearest bfloat16 (ties to even), returning
+ * the uint16 bits of the result. NaNs stay NaNs. */
+Expr float32_to_bfloat16(Expr e);
+
+/** Replace all bfloat16 values with their uint16 bits. Arithmetic,
+ * comparisons and casts on bfloat16 values are done by widening to
+ * float32 and, where the result is a bfloat16, rounding back
+ * again. Loads and stores just move the bits, so the backends never
+ * see a bfloat16.
+ *
+ * On x86, float16 arithmetic and comparisons are also done in
+ * float32, with a cast back to float16 after each operation. Float16
+ * values stay float16 in memory, and the backend can select
+ * vectorized conversion instructions (e.g. F16C) for the casts. As
+ * float32 has more than twice the precision of float16, the results
+ * are the same as if each operation was done in float16. */
+Stmt emulate_float16_math(Stmt s, const Target &t);
+
+}
+}
+
+#endif
@@ -13,6 +13,7 @@
 #include "Float16.h"
 #include "Type.h"
 #include "IntrusivePtr.h"
+#include "IRArena.h"
 #include "Util.h"
 
 namespace Halide {
@@ -64,6 +65,7 @@ enum class IRNodeType {
     Evaluate,
     Shuffle,
     Prefetch,
+    VectorReduce,
 };
 
 /** The abstract base classes for a node in the Halide IR. */
@@ -77,6 +79,14 @@ struct IRNode {
     IRNode(IRNodeType t) : node_type(t) {}
     virtual ~IRNode() {}
 
+    /** IR nodes may be allocated from an arena during lowering (see
+     * IRArenaScope), so their storage is also released through the
+     * arena, including when a constructor throws. */
+    // @{
+    static void *operator new(size_t size) {return ir_node_allocate(size);}
+    static void operator delete(void *p) {ir_node_deallocate(p);}
+    // @}
+
     /** These classes are all managed with intrusive reference
      * counting, so we also track a reference count. It's mutable
      * so that we can do reference counting even through const
@@ -225,13 +235,17 @@ struct FloatImm : public ExprNode<FloatImm> {
     double value;
 
     static const FloatImm *make(Type t, double value) {
-        internal_assert(t.is_float() && t.is_scalar())
-            << "FloatImm must be a scalar Float\n";
+        internal_assert((t.is_float() || t.is_bfloat()) && t.is_scalar())
+            << "FloatImm must be a scalar Float or BFloat\n";
         FloatImm *node = new FloatImm;
         node->type = t;
         switch (t.bits()) {
         case 16:
-            node->value = (double)((float16_t)value);
+            if (t.is_bfloat()) {
+                node->value = (double)((bfloat16_t)value);
+            } else {
+                node->value = (double)((float16_t)value);
+            }
             break;
         case 32:
             node->value = (float)value;
@@ -286,6 +300,7 @@ struct Expr : public Internal::IRHandle {
     EXPORT explicit Expr(uint32_t x)  : IRHandle(Internal::UIntImm::make(UInt(32), x)) {}
     EXPORT explicit Expr(uint64_t x)  : IRHandle(Internal::UIntImm::make(UInt(64), x)) {}
     EXPORT          Expr(float16_t x) : IRHandle(Internal::FloatImm::make(Float(16), (double)x)) {}
+    EXPORT          Expr(bfloat16_t x) : IRHandle(Internal::FloatImm::make(BFloat(16), (double)x)) {}
     EXPORT          Expr(float x)     : IRHandle(Internal::FloatImm::make(Float(32), x)) {}
     EXPORT explicit Expr(double x)    : IRHandle(Internal::FloatImm::make(Float(64), x)) {}
     // @}
@@ -2,6 +2,8 @@
 #include "Error.h"
 #include "LLVM_Headers.h"
 
+#include <string.h>
+
 using namespace Halide;
 
 // These helper functions are not members of float16_t because
@@ -370,4 +372,72 @@ uint16_t float16_t::to_bits() const {
     return this->data;
 }
 
+namespace {
+uint32_t float_to_bits(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+float bits_to_float(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+}  // namespace
+
+bfloat16_t::bfloat16_t(float value) {
+    uint32_t bits = float_to_bits(value);
+    if ((bits & 0x7fffffff) > 0x7f800000) {
+        // NaN. Truncate, but keep it quiet so that it can't become an infinity.
+        data = (uint16_t)((bits >> 16) | 0x40);
+    } else {
+        // Round to nearest, ties to even.
+        bits += 0x7fff + ((bits >> 16) & 1);
+        data = (uint16_t)(bits >> 16);
+    }
+}
+
+bfloat16_t::bfloat16_t(double value) : bfloat16_t((float)value) {}
+
+bfloat16_t::bfloat16_t() : data(0) {}
+
+bfloat16_t::operator float() const {
+    return bits_to_float(((uint32_t)data) << 16);
+}
+
+bfloat16_t::operator double() const {
+    return (double)(float)(*this);
+}
+
+bfloat16_t bfloat16_t::make_from_bits(uint16_t bits) {
+    bfloat16_t result;
+    result.data = bits;
+    return result;
+}
+
+bfloat16_t bfloat16_t::operator-() const {
+    return make_from_bits(data ^ 0x8000);
+}
+
+bool bfloat16_t::is_nan() const {
+    return (data & 0x7fff) > 0x7f80;
+}
+
+bool bfloat16_t::is_infinity() const {
+    return (data & 0x7fff) == 0x7f80;
+}
+
+bool bfloat16_t::is_negative() const {
+    return (data & 0x8000) != 0;
+}
+
+bool bfloat16_t::is_zero() const {
+    return (data & 0x7fff) == 0;
+}
+
+uint16_t bfloat16_t::to_bits() const {
+    return data;
+}
+
 }  // namespace halide
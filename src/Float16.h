@@ -198,6 +198,70 @@ private:
     // this data type is 16-bits wide.
     uint16_t data;
 };
+
+/** Class that provides a type that implements brain floating point
+ *  (bfloat16) in software. A bfloat16 is the upper 16 bits of an IEEE754
+ *  binary32 float: it has the same exponent range as a float, but only 8
+ *  bits of significand precision.
+ *
+ *  Like float16_t, this type holds only the raw bits, so that it can be
+ *  used as the element type of a Buffer.
+ * */
+struct bfloat16_t {
+    /// \name Constructors
+    /// @{
+
+    /** Construct from a float, rounding to the nearest representable
+     * value (ties to even). NaNs stay NaNs. */
+    EXPORT explicit bfloat16_t(float value);
+
+    /** Construct from a double. The double is first rounded to a float. */
+    EXPORT explicit bfloat16_t(double value);
+
+    /** Construct a bfloat16_t with the bits initialised to 0. This
+     * represents positive zero.*/
+    EXPORT bfloat16_t();
+
+    /// @}
+
+    /** Cast to float. This is exact. */
+    EXPORT explicit operator float() const;
+    /** Cast to double. This is exact. */
+    EXPORT explicit operator double() const;
+
+    /** Get a new bfloat16_t with the given raw bits */
+    EXPORT static bfloat16_t make_from_bits(uint16_t bits);
+
+    /** Return a new bfloat16_t with a negated sign bit */
+    EXPORT bfloat16_t operator-() const;
+
+    /** \name Comparison operators
+     * These compare the values as floats. */
+    /**@{*/
+    EXPORT bool operator==(bfloat16_t rhs) const { return (float)(*this) == (float)rhs; }
+    EXPORT bool operator!=(bfloat16_t rhs) const { return !(*this == rhs); }
+    EXPORT bool operator>(bfloat16_t rhs) const { return (float)(*this) > (float)rhs; }
+    EXPORT bool operator<(bfloat16_t rhs) const { return (float)(*this) < (float)rhs; }
+    EXPORT bool operator>=(bfloat16_t rhs) const { return (float)(*this) >= (float)rhs; }
+    EXPORT bool operator<=(bfloat16_t rhs) const { return (float)(*this) <= (float)rhs; }
+    /**@}*/
+
+    /** \name Properties */
+    /*@{*/
+    EXPORT bool is_nan() const;
+    EXPORT bool is_infinity() const;
+    EXPORT bool is_negative() const;
+    EXPORT bool is_zero() const;
+    /*@}*/
+
+    /** Returns the bits that represent this bfloat16_t. */
+    EXPORT uint16_t to_bits() const;
+
+private:
+    // The raw bits. This must be the only data member.
+    uint16_t data;
+};
+
 }  // namespace Halide
 
 template<>
@@ -205,4 +269,9 @@ HALIDE_ALWAYS_INLINE halide_type_t halide_type_of<Halide::float16_t>() {
     return halide_type_t(halide_type_float, 16);
 }
 
+template<>
+HALIDE_ALWAYS_INLINE halide_type_t halide_type_of<Halide::bfloat16_t>() {
+    return halide_type_t(halide_type_bfloat, 16);
+}
+
 #endif
@@ -269,6 +269,41 @@ bool var_name_match(string candidate, string var) {
     if (candidate == var) return true;
     return Internal::ends_with(candidate, "." + var);
 }
+
+template<typename T>
+bool is_binary_op_of_vars(const Expr &e) {
+    const T *op = e.as<T>();
+    return op && op->a.template as<Variable>() && op->b.template as<Variable>();
+}
+
+// Check if an update definition is a commutative and associative
+// reduction into a single site that doesn't depend on the reduction
+// domain, e.g. f(x) = f(x) + g(x, r). Vectorizing one of its RVars
+// is lowered to a horizontal reduction of the vector of values, so
+// it doesn't introduce a race condition.
+bool is_vectorizable_reduction(const string &func_name, const Definition &definition) {
+    const vector<Expr> &args = definition.args();
+    const vector<Expr> &values = definition.values();
+    if (values.size() != 1) {
+        return false;
+    }
+    for (const ReductionVariable &rv : definition.schedule().rvars()) {
+        for (const Expr &arg : args) {
+            if (expr_uses_var(arg, rv.var)) {
+                return false;
+            }
+        }
+    }
+
+    const AssociativeOp &prover_result = prove_associativity(func_name, args, values);
+    if (!prover_result.associative() || !prover_result.commutative()) {
+        return false;
+    }
+    const Expr &op = prover_result.pattern.ops[0];
+    return (is_binary_op_of_vars<Add>(op) || is_binary_op_of_vars<Mul>(op) ||
+            is_binary_op_of_vars<Min>(op) || is_binary_op_of_vars<Max>(op) ||
+            is_binary_op_of_vars<And>(op) || is_binary_op_of_vars<Or>(op));
+}
 }
 
 const std::string &Stage::name() const {
@@ -287,7 +322,9 @@ void Stage::set_dim_type(VarOrRVar var, ForType t) {
             // validate that this doesn't introduce a race condition.
             if (!dims[i].is_pure() && var.is_rvar &&
                 (t == ForType::Vectorized || t == ForType::Parallel ||
-                 t == ForType::GPUBlock || t == ForType::GPUThread)) {
+                 t == ForType::GPUBlock || t == ForType::GPUThread) &&
+                !(t == ForType::Vectorized &&
+                  is_vectorizable_reduction(function.name(), definition))) {
                 user_assert(definition.schedule().allow_race_conditions())
                     << "In schedule for " << stage_name
                     << ", marking var " << var.name()
@@ -1114,7 +1151,7 @@ Stage Stage::specialize(Expr condition) {
     const vector<Specialization> &specializations = definition.specializations();
     for (size_t i = 0; i < specializations.size(); i++) {
         if (equal(condition, specializations[i].condition)) {
-            return Stage(specializations[i].definition, stage_name, dim_vars, func_schedule);
+            return Stage(function, specializations[i].definition, stage_name, dim_vars);
         }
     }
 
@@ -1123,7 +1160,7 @@ Stage Stage::specialize(Expr condition) {
         << "Cannot add new specializations after specialize_fail().";
     const Specialization &s = definition.add_specialization(condition);
 
-    return Stage(s.definition, stage_name, dim_vars, func_schedule);
+    return Stage(function, s.definition, stage_name, dim_vars);
 }
 
 void Stage::specialize_fail(const std::string &message) {
@@ -1425,6 +1462,43 @@ Stage &Stage::unroll(VarOrRVar var, Expr factor, TailStrategy tail) {
     return *this;
 }
 
+Stage &Stage::unroll_and_jam(VarOrRVar var, Expr factor, TailStrategy tail) {
+    string inner_name;
+    if (var.is_rvar) {
+        RVar tmp;
+        split(var.rvar, var.rvar, tmp, factor, tail);
+        unroll(tmp);
+        inner_name = tmp.name();
+    } else {
+        Var tmp;
+        split(var.var, var.var, tmp, factor, tail);
+        unroll(tmp);
+        inner_name = tmp.name();
+    }
+
+    // Move the unrolled loop inwards until only the innermost loop
+    // is inside it.
+    vector<Dim> &dims = definition.schedule().dims();
+    size_t idx = 0;
+    while (!var_name_match(dims[idx].var, inner_name)) {
+        idx++;
+    }
+    if (idx > 1) {
+        for (size_t i = 1; i < idx; i++) {
+            user_assert(dims[idx].is_pure() || dims[i].is_pure())
+                << "In schedule for " << name()
+                << ", can't unroll and jam " << var.name()
+                << " inside " << dims[i].var
+                << " because it may change the meaning of the algorithm.\n";
+        }
+        Dim inner = dims[idx];
+        dims.erase(dims.begin() + idx);
+        dims.insert(dims.begin() + 1, inner);
+    }
+
+    return *this;
+}
+
 Stage &Stage::tile(VarOrRVar x, VarOrRVar y,
                    VarOrRVar xo, VarOrRVar yo,
                    VarOrRVar xi, VarOrRVar yi,
@@ -1731,6 +1805,18 @@ Stage &Stage::prefetch(const Internal::Parameter &param, VarOrRVar var, Expr off
     return *this;
 }
 
+Stage &Stage::prefetch(const Func &f, PrefetchBoundStrategy strategy) {
+    PrefetchDirective prefetch = {f.name(), "", Expr(), strategy, Parameter()};
+    definition.schedule().prefetches().push_back(prefetch);
+    return *this;
+}
+
+Stage &Stage::prefetch(const Internal::Parameter &param, PrefetchBoundStrategy strategy) {
+    PrefetchDirective prefetch = {param.name(), "", Expr(), strategy, param};
+    definition.schedule().prefetches().push_back(prefetch);
+    return *this;
+}
+
 void Func::invalidate_cache() {
     if (pipeline_.defined()) {
         pipeline_.invalidate_cache();
@@ -1904,24 +1990,24 @@ Func Func::copy_to_host() {
 
 Func &Func::split(VarOrRVar old, VarOrRVar outer, VarOrRVar inner, Expr factor, TailStrategy tail) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).split(old, outer, inner, factor, tail);
+    Stage(func, func.definition(), name(), args()).split(old, outer, inner, factor, tail);
     return *this;
 }
 
 Func &Func::fuse(VarOrRVar inner, VarOrRVar outer, VarOrRVar fused) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).fuse(inner, outer, fused);
+    Stage(func, func.definition(), name(), args()).fuse(inner, outer, fused);
     return *this;
 }
 
 Func &Func::rename(VarOrRVar old_name, VarOrRVar new_name) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).rename(old_name, new_name);
+    Stage(func, func.definition(), name(), args()).rename(old_name, new_name);
     return *this;
 }
 
 Func &Func::allow_race_conditions() {
-    Stage(func.definition(), name(), args(), func.schedule()).allow_race_conditions();
+    Stage(func, func.definition(), name(), args()).allow_race_conditions();
     return *this;
 }
 
@@ -1931,55 +2017,73 @@ Func &Func::memoize() {
     return *this;
 }
 
+Func &Func::store_in_registers() {
+    invalidate_cache();
+    func.schedule().store_in_registers() = true;
+    return *this;
+}
+
+Func &Func::store_nontemporal() {
+    invalidate_cache();
+    func.schedule().store_nontemporal() = true;
+    return *this;
+}
+
 Stage Func::specialize(Expr c) {
     invalidate_cache();
-    return Stage(func.definition(), name(), args(), func.schedule()).specialize(c);
+    return Stage(func, func.definition(), name(), args()).specialize(c);
 }
 
 void Func::specialize_fail(const std::string &message) {
     invalidate_cache();
-    (void) Stage(func.definition(), name(), args(), func.schedule()).specialize_fail(message);
+    (void) Stage(func, func.definition(), name(), args()).specialize_fail(message);
 }
 
 Func &Func::serial(VarOrRVar var) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).serial(var);
+    Stage(func, func.definition(), name(), args()).serial(var);
     return *this;
 }
 
 Func &Func::parallel(VarOrRVar var) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).parallel(var);
+    Stage(func, func.definition(), name(), args()).parallel(var);
     return *this;
 }
 
 Func &Func::vectorize(VarOrRVar var) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).vectorize(var);
+    Stage(func, func.definition(), name(), args()).vectorize(var);
     return *this;
 }
 
 Func &Func::unroll(VarOrRVar var) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).unroll(var);
+    Stage(func, func.definition(), name(), args()).unroll(var);
     return *this;
 }
 
 Func &Func::parallel(VarOrRVar var, Expr factor, TailStrategy tail) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).parallel(var, factor, tail);
+    Stage(func, func.definition(), name(), args()).parallel(var, factor, tail);
     return *this;
 }
 
 Func &Func::vectorize(VarOrRVar var, Expr factor, TailStrategy tail) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).vectorize(var, factor, tail);
+    Stage(func, func.definition(), name(), args()).vectorize(var, factor, tail);
     return *this;
 }
 
 Func &Func::unroll(VarOrRVar var, Expr factor, TailStrategy tail) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).unroll(var, factor, tail);
+    Stage(func, func.definition(), name(), args()).unroll(var, factor, tail);
+    return *this;
+}
+
+Func &Func::unroll_and_jam(VarOrRVar var, Expr factor, TailStrategy tail) {
+    invalidate_cache();
+    Stage(func, func.definition(), name(), args()).unroll_and_jam(var, factor, tail);
     return *this;
 }
 
@@ -2071,7 +2175,7 @@ Func &Func::tile(VarOrRVar x, VarOrRVar y,
                  Expr xfactor, Expr yfactor,
                  TailStrategy tail) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).tile(x, y, xo, yo, xi, yi, xfactor, yfactor, tail);
+    Stage(func, func.definition(), name(), args()).tile(x, y, xo, yo, xi, yi, xfactor, yfactor, tail);
     return *this;
 }
 
@@ -2080,91 +2184,91 @@ Func &Func::tile(VarOrRVar x, VarOrRVar y,
                  Expr xfactor, Expr yfactor,
                  TailStrategy tail) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).tile(x, y, xi, yi, xfactor, yfactor, tail);
+    Stage(func, func.definition(), name(), args()).tile(x, y, xi, yi, xfactor, yfactor, tail);
     return *this;
 }
 
 Func &Func::reorder(const std::vector<VarOrRVar> &vars) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).reorder(vars);
+    Stage(func, func.definition(), name(), args()).reorder(vars);
     return *this;
 }
 
 Func &Func::gpu_threads(VarOrRVar tx, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_threads(tx, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_threads(tx, device_api);
     return *this;
 }
 
 Func &Func::gpu_threads(VarOrRVar tx, VarOrRVar ty, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_threads(tx, ty, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_threads(tx, ty, device_api);
     return *this;
 }
 
 Func &Func::gpu_threads(VarOrRVar tx, VarOrRVar ty, VarOrRVar tz, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_threads(tx, ty, tz, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_threads(tx, ty, tz, device_api);
     return *this;
 }
 
 Func &Func::gpu_blocks(VarOrRVar bx, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_blocks(bx, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_blocks(bx, device_api);
     return *this;
 }
 
 Func &Func::gpu_blocks(VarOrRVar bx, VarOrRVar by, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_blocks(bx, by, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_blocks(bx, by, device_api);
     return *this;
 }
 
 Func &Func::gpu_blocks(VarOrRVar bx, VarOrRVar by, VarOrRVar bz, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_blocks(bx, by, bz, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_blocks(bx, by, bz, device_api);
     return *this;
 }
 
 Func &Func::gpu_single_thread(DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_single_thread(device_api);
+    Stage(func, func.definition(), name(), args()).gpu_single_thread(device_api);
     return *this;
 }
 
 Func &Func::gpu(VarOrRVar bx, VarOrRVar tx, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu(bx, tx, device_api);
+    Stage(func, func.definition(), name(), args()).gpu(bx, tx, device_api);
     return *this;
 }
 
 Func &Func::gpu(VarOrRVar bx, VarOrRVar by, VarOrRVar tx, VarOrRVar ty, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu(bx, by, tx, ty, device_api);
+    Stage(func, func.definition(), name(), args()).gpu(bx, by, tx, ty, device_api);
     return *this;
 }
 
 Func &Func::gpu(VarOrRVar bx, VarOrRVar by, VarOrRVar bz, VarOrRVar tx, VarOrRVar ty, VarOrRVar tz, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu(bx, by, bz, tx, ty, tz, device_api);
+    Stage(func, func.definition(), name(), args()).gpu(bx, by, bz, tx, ty, tz, device_api);
     return *this;
 }
 
 Func &Func::gpu_tile(VarOrRVar x, VarOrRVar bx, Var tx, Expr x_size, TailStrategy tail, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_tile(x, bx, tx, x_size, tail, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_tile(x, bx, tx, x_size, tail, device_api);
     return *this;
 }
 
 Func &Func::gpu_tile(VarOrRVar x, VarOrRVar bx, RVar tx, Expr x_size, TailStrategy tail, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_tile(x, bx, tx, x_size, tail, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_tile(x, bx, tx, x_size, tail, device_api);
     return *this;
 }
 
 Func &Func::gpu_tile(VarOrRVar x, VarOrRVar tx, Expr x_size, TailStrategy tail, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_tile(x, tx, x_size, tail, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_tile(x, tx, x_size, tail, device_api);
     return *this;
 }
 
@@ -2175,7 +2279,7 @@ Func &Func::gpu_tile(VarOrRVar x, VarOrRVar y,
                      TailStrategy tail,
                      DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule())
+    Stage(func, func.definition(), name(), args())
         .gpu_tile(x, y, bx, by, tx, ty, x_size, y_size, tail, device_api);
     return *this;
 }
@@ -2186,7 +2290,7 @@ Func &Func::gpu_tile(VarOrRVar x, VarOrRVar y,
                      TailStrategy tail,
                      DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule())
+    Stage(func, func.definition(), name(), args())
         .gpu_tile(x, y, tx, ty, x_size, y_size, tail, device_api);
     return *this;
 }
@@ -2197,7 +2301,7 @@ Func &Func::gpu_tile(VarOrRVar x, VarOrRVar y,
                      TailStrategy tail,
                      DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule())
+    Stage(func, func.definition(), name(), args())
         .gpu_tile(x, y, tx, ty, x_size, y_size, tail, device_api);
     return *this;
 }
@@ -2209,7 +2313,7 @@ Func &Func::gpu_tile(VarOrRVar x, VarOrRVar y, VarOrRVar z,
                      TailStrategy tail,
                      DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule())
+    Stage(func, func.definition(), name(), args())
         .gpu_tile(x, y, z, bx, by, bz, tx, ty, tz, x_size, y_size, z_size, tail, device_api);
     return *this;
 }
@@ -2220,14 +2324,14 @@ Func &Func::gpu_tile(VarOrRVar x, VarOrRVar y, VarOrRVar z,
                      TailStrategy tail,
                      DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule())
+    Stage(func, func.definition(), name(), args())
         .gpu_tile(x, y, z, tx, ty, tz, x_size, y_size, z_size, tail, device_api);
     return *this;
 }
 
 Func &Func::gpu_tile(VarOrRVar x, Expr x_size, TailStrategy tail, DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_tile(x, x_size, tail, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_tile(x, x_size, tail, device_api);
     return *this;
 }
 
@@ -2236,7 +2340,7 @@ Func &Func::gpu_tile(VarOrRVar x, VarOrRVar y,
                      TailStrategy tail,
                      DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_tile(x, y, x_size, y_size, tail, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_tile(x, y, x_size, y_size, tail, device_api);
     return *this;
 }
 
@@ -2245,7 +2349,7 @@ Func &Func::gpu_tile(VarOrRVar x, VarOrRVar y, VarOrRVar z,
                      TailStrategy tail,
                      DeviceAPI device_api) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_tile(x, y, z, x_size, y_size, z_size, tail, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_tile(x, y, z, x_size, y_size, z_size, tail, device_api);
     return *this;
 }
 
@@ -2258,7 +2362,7 @@ Func &Func::shader(Var x, Var y, Var c, DeviceAPI device_api) {
 
     // TODO: Set appropriate constraints if this is the output buffer?
 
-    Stage(func.definition(), name(), args(), func.schedule()).gpu_blocks(x, y, device_api);
+    Stage(func, func.definition(), name(), args()).gpu_blocks(x, y, device_api);
 
     bool constant_bounds = false;
     FuncSchedule &sched = func.schedule();
@@ -2280,19 +2384,31 @@ Func &Func::glsl(Var x, Var y, Var c) {
 
 Func &Func::hexagon(VarOrRVar x) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).hexagon(x);
+    Stage(func, func.definition(), name(), args()).hexagon(x);
     return *this;
 }
 
 Func &Func::prefetch(const Func &f, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).prefetch(f, var, offset, strategy);
+    Stage(func, func.definition(), name(), args()).prefetch(f, var, offset, strategy);
     return *this;
 }
 
 Func &Func::prefetch(const Internal::Parameter &param, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).prefetch(param, var, offset, strategy);
+    Stage(func, func.definition(), name(), args()).prefetch(param, var, offset, strategy);
+    return *this;
+}
+
+Func &Func::prefetch(const Func &f, PrefetchBoundStrategy strategy) {
+    invalidate_cache();
+    Stage(func, func.definition(), name(), args()).prefetch(f, strategy);
+    return *this;
+}
+
+Func &Func::prefetch(const Internal::Parameter &param, PrefetchBoundStrategy strategy) {
+    invalidate_cache();
+    Stage(func, func.definition(), name(), args()).prefetch(param, strategy);
     return *this;
 }
 
@@ -2437,14 +2553,14 @@ Stage Func::update(int idx) {
       "Call to update with index larger than last defined update stage for Func \"" <<
       name() << "\".\n";
     invalidate_cache();
-    return Stage(func.update(idx),
+    return Stage(func,
+                 func.update(idx),
                  name() + ".update(" + std::to_string(idx) + ")",
-                 args(),
-                 func.schedule());
+                 args());
 }
 
 Func::operator Stage() const {
-    return Stage(func.definition(), name(), args(), func.schedule());
+    return Stage(func, func.definition(), name(), args());
 }
 
 namespace {
@@ -2566,16 +2682,16 @@ Stage FuncRef::operator=(const Tuple &e) {
             expanded_args_str[i] = v->name;
         }
         func.define(expanded_args_str, e.as_vector());
-        return Stage(func.definition(), func.name(), func.args(), func.schedule());
+        return Stage(func, func.definition(), func.name(), func.args());
 
     } else {
         func.define_update(args, e.as_vector());
 
         size_t update_stage = func.updates().size() - 1;
-        return Stage(func.update(update_stage),
+        return Stage(func,
+                     func.update(update_stage),
                      func.name() + ".update(" + std::to_string(update_stage) + ")",
-                     func.args(),
-                     func.schedule());
+                     func.args());
     }
 }
 
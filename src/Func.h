@@ -50,6 +50,8 @@ struct StorageDim;
 
 /** A single definition of a Func. May be a pure or update definition. */
 class Stage {
+    /** The Function this Stage is a definition of. */
+    Internal::Function function;
     Internal::Definition definition;
     std::string stage_name;
     /** Pure Vars of the Function (from the init definition). */
@@ -66,16 +68,17 @@ class Stage {
     Stage &purify(VarOrRVar old_name, VarOrRVar new_name);
 
 public:
-    Stage(Internal::Definition d, const std::string &n, const std::vector<Var> &args,
-          const Internal::FuncSchedule &func_s)
-            : definition(d), stage_name(n), dim_vars(args), func_schedule(func_s) {
+    Stage(Internal::Function f, Internal::Definition d, const std::string &n,
+          const std::vector<Var> &args)
+            : function(f), definition(d), stage_name(n), dim_vars(args),
+              func_schedule(f.schedule()) {
         internal_assert(definition.args().size() == dim_vars.size());
         definition.schedule().touched() = true;
     }
 
-    Stage(Internal::Definition d, const std::string &n, const std::vector<std::string> &args,
-          const Internal::FuncSchedule &func_s)
-            : definition(d), stage_name(n), func_schedule(func_s) {
+    Stage(Internal::Function f, Internal::Definition d, const std::string &n,
+          const std::vector<std::string> &args)
+            : function(f), definition(d), stage_name(n), func_schedule(f.schedule()) {
         definition.schedule().touched() = true;
 
         std::vector<Var> dim_vars(args.size());
@@ -183,6 +186,7 @@ public:
     EXPORT Stage &parallel(VarOrRVar var, Expr task_size, TailStrategy tail = TailStrategy::Auto);
     EXPORT Stage &vectorize(VarOrRVar var, Expr factor, TailStrategy tail = TailStrategy::Auto);
     EXPORT Stage &unroll(VarOrRVar var, Expr factor, TailStrategy tail = TailStrategy::Auto);
+    EXPORT Stage &unroll_and_jam(VarOrRVar var, Expr factor, TailStrategy tail = TailStrategy::Auto);
     EXPORT Stage &tile(VarOrRVar x, VarOrRVar y,
                        VarOrRVar xo, VarOrRVar yo,
                        VarOrRVar xi, VarOrRVar yi, Expr
@@ -296,6 +300,15 @@ public:
                     PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf) {
         return prefetch(image.parameter(), var, offset, strategy);
     }
+    EXPORT Stage &prefetch(const Func &f,
+                           PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+    EXPORT Stage &prefetch(const Internal::Parameter &param,
+                           PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+    template<typename T>
+    Stage &prefetch(const T &image,
+                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf) {
+        return prefetch(image.parameter(), strategy);
+    }
     // @}
 };
 
@@ -1234,6 +1247,19 @@ public:
      * dimension of the split. 'factor' must be an integer. */
     EXPORT Func &unroll(VarOrRVar var, Expr factor, TailStrategy tail = TailStrategy::Auto);
 
+    /** Split a dimension by the given factor, unroll the inner
+     * dimension, and move it inwards to just outside the innermost
+     * loop. The unrolled copies of the loop body are then jammed
+     * together inside the innermost (typically vectorized) loop,
+     * so that each iteration of it computes 'factor' independent
+     * values. This is the usual way to block the accumulators of a
+     * matrix multiply into registers. After this call, var refers to
+     * the outer dimension of the split. 'factor' must be an
+     * integer. When the loops are unrolled, Halide warns if the
+     * values carried between iterations of an enclosing loop are
+     * likely to need more vector registers than the target has. */
+    EXPORT Func &unroll_and_jam(VarOrRVar var, Expr factor, TailStrategy tail = TailStrategy::Auto);
+
     /** Statically declare that the range over which a function should
      * be evaluated is given by the second and third arguments. This
      * can let Halide perform some optimizations. E.g. if you know
@@ -1674,6 +1700,42 @@ public:
     }
     // @}
 
+    /** Prefetch data read from a Func or an ImageParam, picking the loop
+     * level and the iteration offset automatically. The prefetch goes in
+     * the innermost serial or parallel loop of this Func over which the
+     * region of f that is accessed moves. The offset is chosen from how
+     * far that region moves on each iteration, and how much new data it
+     * covers, so that enough cache lines are requested ahead of time to
+     * hide the memory latency of the target. Loops that access a lot of
+     * new data per iteration (e.g. with large strides) get small offsets,
+     * and loops that only move a few bytes per iteration get large
+     * ones. If the region doesn't move over any loop, or it isn't a
+     * constant size, no prefetch is inserted. For example:
+     \code
+     Func f, g;
+     Var x, y;
+     f(x, y) = x + y;
+     g(x, y) = 2 * f(y, x);
+     f.compute_root();
+     g.prefetch(f);
+     \endcode
+     *
+     * prefetches from f in g's loop over x. Every iteration reads a new
+     * row of f, so the offset is large enough to have a few rows in
+     * flight.
+     */
+    // @{
+    EXPORT Func &prefetch(const Func &f,
+                          PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+    EXPORT Func &prefetch(const Internal::Parameter &param,
+                          PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+    template<typename T>
+    Func &prefetch(const T &image,
+                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf) {
+        return prefetch(image.parameter(), strategy);
+    }
+    // @}
+
     /** Specify how the storage for the function is laid out. These
      * calls let you specify the nesting order of the dimensions. For
      * example, foo.reorder_storage(y, x) tells Halide to use
@@ -1867,6 +1929,32 @@ public:
      */
     EXPORT Func &memoize();
 
+    /** Keep the storage for this function in registers instead of
+     * memory. This is for small accumulator tiles, e.g. the block of
+     * a matrix multiply that is updated on every iteration of the
+     * loop over the reduction domain. The function must be computed
+     * at some loop level inside the pipeline, over a region of
+     * constant size (use \ref Func::bound_extent if necessary), and
+     * every loop over its storage must be unrolled or vectorized, so
+     * that after lowering each access is at a constant
+     * index. Halide then replaces the storage with a separate
+     * variable for each scalar or vector that is accessed. These are
+     * only ever loaded and stored whole, so LLVM promotes them to
+     * registers. If any of these conditions doesn't hold, lowering
+     * fails with an error. */
+    EXPORT Func &store_in_registers();
+
+    /** Write this function's values with non-temporal stores, which
+     * bypass the caches. This is for large outputs that won't be read
+     * again soon, which would otherwise evict more useful data from
+     * the caches. Only dense vector stores are affected, so the
+     * function should be vectorized. The stores are only
+     * non-temporal when their addresses are aligned to the vector
+     * size, so for an output it's a good idea to set the host
+     * alignment of \ref Func::output_buffer, and to constrain its
+     * min and stride so that every vector is aligned. */
+    EXPORT Func &store_nontemporal();
+
 
     /** Allocate storage for this function within f's loop over
      * var. Scheduling storage is optional, and can be used to
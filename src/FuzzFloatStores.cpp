@@ -11,7 +11,7 @@ class FuzzFloatStores : public IRMutator {
 
     void visit(const Store *op) {
         Type t = op->value.type();
-        if (t.is_float()) {
+        if (t.is_float() || t.is_bfloat()) {
             // Drop the last bit of the mantissa.
             Expr value = op->value;
             Expr mask = make_one(t.with_code(Type::UInt));
@@ -1,7 +1,15 @@
 #include <cmath>
+#include <cstdio>
 #include <fstream>
+#include <iostream>
 #include <set>
 
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "Generator.h"
 #include "Outputs.h"
 #include "Simplify.h"
@@ -742,7 +750,8 @@ const std::map<std::string, Type> &get_halide_type_enum_map() {
         {"uint16", UInt(16)},
         {"uint32", UInt(32)},
         {"float32", Float(32)},
-        {"float64", Float(64)}
+        {"float64", Float(64)},
+        {"bfloat16", BFloat(16)}
     };
     return halide_type_enum_map;
 }
@@ -753,6 +762,7 @@ std::string halide_type_to_c_source(const Type &t) {
         { halide_type_uint, "UInt" },
         { halide_type_float, "Float" },
         { halide_type_handle, "Handle" },
+        { halide_type_bfloat, "BFloat" },
     };
     std::ostringstream oss;
     oss << "Halide::" << m.at(t.code()) << "(" << t.bits() << + ")";
@@ -773,6 +783,7 @@ std::string halide_type_to_c_type(const Type &t) {
         { encode(UInt(64)), "uint64_t" },
         { encode(Float(32)), "float" },
         { encode(Float(64)), "double" },
+        { encode(BFloat(16)), "Halide::bfloat16_t" },
         { encode(Handle(64)), "void*" }
     };
     internal_assert(m.count(encode(t))) << t << " " << encode(t);
@@ -787,13 +798,95 @@ const std::map<std::string, LoopLevel> &get_halide_looplevel_enum_map() {
     return halide_looplevel_enum_map;
 }
 
+namespace {
+
+// Serve compile requests read from 'in', one per line. Each line holds the
+// same arguments generate_filter_main() accepts on the command line
+// (whitespace-separated, no quoting); after each request a single line
+// of "ok" or "error" is written to 'out'. Keeping the process alive lets
+// a build issue many generator invocations without paying for process
+// startup, Generator registration, and LLVM initialization each time.
+int generate_filter_server(std::istream &in, FILE *out, std::ostream &cerr) {
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> args = { "gengen" };
+        std::istringstream tokens(line);
+        std::string arg;
+        while (tokens >> arg) {
+            args.push_back(arg);
+        }
+        if (args.size() == 1) {
+            continue;
+        }
+
+        int result = 1;
+        if (args[1] == "-s") {
+            cerr << "-s is not allowed within a compile request\n";
+        } else {
+            std::vector<char *> argv;
+            for (std::string &a : args) {
+                argv.push_back(&a[0]);
+            }
+            argv.push_back(nullptr);
+#ifdef WITH_EXCEPTIONS
+            // Report a failed request and keep serving; without
+            // exceptions a user_error terminates the server instead.
+            try {
+                result = generate_filter_main((int)args.size(), argv.data(), cerr);
+            } catch (const Halide::Error &e) {
+                cerr << e.what() << "\n";
+                result = 1;
+            }
+#else
+            result = generate_filter_main((int)args.size(), argv.data(), cerr);
+#endif
+        }
+        // Anything printed while compiling must come out before the reply.
+        cerr.flush();
+        std::cout.flush();
+        fflush(stdout);
+        fprintf(out, "%s\n", result == 0 ? "ok" : "error");
+        fflush(out);
+    }
+    return 0;
+}
+
+// Run generate_filter_server() on stdin and stdout. Generators (or
+// anything else) printing to stdout while compiling would corrupt the
+// replies, so the replies get a private copy of stdout, and stdout
+// itself is pointed at stderr for as long as the server runs.
+int generate_filter_server_on_stdio(std::ostream &cerr) {
+    std::cout.flush();
+    fflush(stdout);
+    int reply_fd = dup(fileno(stdout));
+    if (reply_fd < 0 || dup2(fileno(stderr), fileno(stdout)) < 0) {
+        cerr << "Unable to redirect stdout for the compile server\n";
+        return 1;
+    }
+    FILE *replies = fdopen(reply_fd, "w");
+    internal_assert(replies);
+    int result = generate_filter_server(std::cin, replies, cerr);
+    fclose(replies);
+    return result;
+}
+
+}  // namespace
+
 int generate_filter_main(int argc, char **argv, std::ostream &cerr) {
+    if (argc == 2 && std::string(argv[1]) == "-s") {
+        return generate_filter_server_on_stdio(cerr);
+    }
+
     const char kUsage[] = "gengen [-g GENERATOR_NAME] [-f FUNCTION_NAME] [-o OUTPUT_DIR] [-r RUNTIME_NAME] [-e EMIT_OPTIONS] [-x EXTENSION_OPTIONS] [-n FILE_BASE_NAME] "
                           "target=target-string[,target-string...] [generator_arg=value [...]]\n\n"
                           "  -e  A comma separated list of files to emit. Accepted values are "
                           "[assembly, bitcode, cpp, h, html, o, static_library, stmt, cpp_stub]. If omitted, default value is [static_library, h].\n"
                           "  -x  A comma separated list of file extension pairs to substitute during file naming, "
-                          "in the form [.old=.new[,.old2=.new2]]\n";
+                          "in the form [.old=.new[,.old2=.new2]]\n\n"
+                          "gengen -s\n\n"
+                          "  -s  Run as a compile server: read one set of the arguments above per line from stdin "
+                          "and write \"ok\" or \"error\" to stdout after each. Anything else that would "
+                          "be printed to stdout goes to stderr instead.\n";
 
     std::map<std::string, std::string> flags_info = { { "-f", "" },
                                                       { "-g", "" },
@@ -1415,6 +1508,18 @@ std::string GeneratorBase::auto_schedule_outputs() {
     return get_pipeline().auto_schedule(get_target());
 }
 
+std::string GeneratorBase::auto_schedule_outputs_serialized(const MachineParams &arch_params) {
+    return get_pipeline().auto_schedule_serialized(get_target(), arch_params);
+}
+
+std::string GeneratorBase::auto_schedule_outputs_serialized() {
+    return get_pipeline().auto_schedule_serialized(get_target());
+}
+
+void GeneratorBase::apply_schedule(const std::string &serialized) {
+    get_pipeline().apply_schedule(serialized);
+}
+
 Module GeneratorBase::build_module(const std::string &function_name,
                                    const LoweredFunc::LinkageType linkage_type) {
     Pipeline pipeline = build_pipeline();
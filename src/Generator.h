@@ -301,7 +301,15 @@ EXPORT std::string halide_type_to_c_type(const Type &t);
 
 /** generate_filter_main() is a convenient wrapper for GeneratorRegistry::create() +
  * compile_to_files(); it can be trivially wrapped by a "real" main() to produce a
- * command-line utility for ahead-of-time filter compilation. */
+ * command-line utility for ahead-of-time filter compilation.
+ *
+ * If the only argument is "-s", it instead runs as a compile server: each
+ * line read from stdin is treated as a separate set of command-line
+ * arguments and compiled in-process, and "ok" or "error" is written to
+ * stdout when it completes. Everything else written to stdout while
+ * serving is sent to stderr, so it can't be mistaken for a reply. This
+ * avoids re-launching the generator (and re-initializing LLVM) for
+ * every variant in a large build. */
 EXPORT int generate_filter_main(int argc, char **argv, std::ostream &cerr);
 
 // select_type<> is to std::conditional as switch is to if:
@@ -2462,6 +2470,18 @@ public:
     EXPORT std::string auto_schedule_outputs();
     //@}
 
+    /** Generate a schedule for the Generator's pipeline, and return it in
+     * the serialized form of \ref Pipeline::auto_schedule_serialized. */
+    //@{
+    EXPORT std::string auto_schedule_outputs_serialized(const MachineParams &arch_params);
+    EXPORT std::string auto_schedule_outputs_serialized();
+    //@}
+
+    /** Apply a serialized schedule to the Generator's pipeline (see
+     * \ref Pipeline::apply_schedule), e.g. one saved from an earlier run of
+     * auto_schedule_outputs_serialized(). */
+    EXPORT void apply_schedule(const std::string &serialized);
+
 protected:
     EXPORT GeneratorBase(size_t size, const void *introspection_helper);
     EXPORT void set_generator_names(const std::string &registered_name, const std::string &stub_name);
@@ -581,6 +581,25 @@ Expr Variable::make(Type type, const std::string &name, Buffer<> image, Paramete
     return node;
 }
 
+Expr VectorReduce::make(VectorReduce::Operator op,
+                         Expr vec,
+                         int lanes) {
+    internal_assert(vec.defined()) << "VectorReduce of undefined\n";
+    internal_assert(lanes > 0) << "VectorReduce to zero lanes\n";
+    internal_assert(vec.type().lanes() % lanes == 0)
+        << "VectorReduce of " << vec.type().lanes()
+        << " lanes to " << lanes << " lanes\n";
+    if (op == VectorReduce::And || op == VectorReduce::Or) {
+        internal_assert(vec.type().is_bool()) << "Logical VectorReduce of non-bool\n";
+    }
+
+    VectorReduce *node = new VectorReduce;
+    node->type = vec.type().with_lanes(lanes);
+    node->op = op;
+    node->value = std::move(vec);
+    return node;
+}
+
 Expr Shuffle::make(const std::vector<Expr> &vectors,
                    const std::vector<int> &indices) {
     internal_assert(!vectors.empty()) << "Shuffle of zero vectors.\n";
@@ -775,6 +794,7 @@ template<> EXPORT void StmtNode<Block>::accept(IRVisitor *v) const { v->visit((c
 template<> EXPORT void StmtNode<IfThenElse>::accept(IRVisitor *v) const { v->visit((const IfThenElse *)this); }
 template<> EXPORT void StmtNode<Evaluate>::accept(IRVisitor *v) const { v->visit((const Evaluate *)this); }
 template<> EXPORT void StmtNode<Prefetch>::accept(IRVisitor *v) const { v->visit((const Prefetch *)this); }
+template<> EXPORT void ExprNode<VectorReduce>::accept(IRVisitor *v) const { v->visit((const VectorReduce *)this); }
 
 Call::ConstString Call::debug_to_file = "debug_to_file";
 Call::ConstString Call::reinterpret = "reinterpret";
@@ -810,6 +830,7 @@ Call::ConstString Call::div_round_to_zero = "div_round_to_zero";
 Call::ConstString Call::mod_round_to_zero = "mod_round_to_zero";
 Call::ConstString Call::call_cached_indirect_function = "call_cached_indirect_function";
 Call::ConstString Call::prefetch = "prefetch";
+Call::ConstString Call::nontemporal = "nontemporal";
 Call::ConstString Call::signed_integer_overflow = "signed_integer_overflow";
 Call::ConstString Call::indeterminate_expression = "indeterminate_expression";
 Call::ConstString Call::bool_to_mask = "bool_to_mask";
@@ -505,6 +505,7 @@ struct Call : public ExprNode<Call> {
         mod_round_to_zero,
         call_cached_indirect_function,
         prefetch,
+        nontemporal,
         signed_integer_overflow,
         indeterminate_expression,
         bool_to_mask,
@@ -740,6 +741,32 @@ struct Prefetch : public StmtNode<Prefetch> {
     static const IRNodeType _node_type = IRNodeType::Prefetch;
 };
 
+/** Horizontally reduce a vector to a scalar or narrower vector using
+ * the given commutative and associative binary operator. The
+ * reduction factor is given by the ratio of the number of lanes of
+ * the value to the number of lanes of the result. Groups of adjacent
+ * lanes are combined, so lane i of the result is the reduction of
+ * lanes [i * factor, (i + 1) * factor) of the value. Any widening of
+ * the accumulation happens in the value, e.g. a horizontal sum of
+ * 8-bit values into a 32-bit result is a VectorReduce of a Cast. */
+struct VectorReduce : public ExprNode<VectorReduce> {
+    enum Operator {
+        Add,
+        Mul,
+        Min,
+        Max,
+        And,
+        Or,
+    };
+
+    Expr value;
+    Operator op;
+
+    EXPORT static Expr make(Operator op, Expr vec, int lanes);
+
+    static const IRNodeType _node_type = IRNodeType::VectorReduce;
+};
+
 }
 }
 
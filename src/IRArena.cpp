@@ -0,0 +1,206 @@
+#include <atomic>
+#include <new>
+#include <iostream>
+
+#include "IRArena.h"
+#include "IR.h"
+#include "IROperator.h"
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+// Chunk sizes are a trade-off between the number of heap
+// allocations and the amount of memory pinned by long-lived nodes.
+constexpr size_t chunk_size = 64 * 1024;
+
+// Each allocation is preceded by a pointer back to its chunk, which
+// is null for nodes that have their own heap allocation.
+constexpr size_t header_size = sizeof(void *);
+
+// IR nodes contain nothing with stricter alignment requirements than
+// pointers, int64_t or double.
+constexpr size_t node_alignment = 8;
+
+// Nodes larger than this go to the heap to avoid wasting chunk space.
+constexpr size_t max_arena_allocation = chunk_size / 16;
+
+std::atomic<int> live_chunks(0);
+
+struct Chunk;
+void recycle_chunk(Chunk *c);
+Chunk *reuse_chunk();
+
+struct Chunk {
+    // The number of live nodes in the chunk, plus one while the chunk
+    // is the current chunk of some thread's arena.
+    std::atomic<int> refs;
+    size_t used;
+
+    static Chunk *make() {
+        void *mem = reuse_chunk();
+        if (!mem) {
+            mem = ::operator new(chunk_size);
+            live_chunks++;
+        }
+        return new (mem) Chunk;
+    }
+
+    Chunk() : refs(1), used(align(sizeof(Chunk))) {}
+
+    static size_t align(size_t s) {
+        return (s + node_alignment - 1) & ~(node_alignment - 1);
+    }
+
+    void release() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            this->~Chunk();
+            recycle_chunk(this);
+        }
+    }
+
+    // Returns nullptr if the chunk is full.
+    void *allocate(size_t size) {
+        size_t start = used + header_size;
+        size_t end = align(start + size);
+        if (end > chunk_size) {
+            return nullptr;
+        }
+        char *base = (char *)this;
+        *(Chunk **)(base + used) = this;
+        used = end;
+        refs.fetch_add(1, std::memory_order_relaxed);
+        return base + start;
+    }
+};
+
+// Recently emptied chunks are kept around for reuse, because
+// touching fresh memory for every chunk is much slower than
+// recycling memory that is still in cache.
+constexpr int max_free_chunks = 4;
+
+struct ArenaState {
+    int depth = 0;
+    Chunk *current = nullptr;
+    void *free_chunks[max_free_chunks];
+    int num_free_chunks = 0;
+
+    ~ArenaState() {
+        for (int i = 0; i < num_free_chunks; i++) {
+            ::operator delete(free_chunks[i]);
+            live_chunks--;
+        }
+    }
+};
+
+ArenaState &arena_state() {
+    static thread_local ArenaState state;
+    return state;
+}
+
+void recycle_chunk(Chunk *c) {
+    ArenaState &state = arena_state();
+    if (state.depth > 0 && state.num_free_chunks < max_free_chunks) {
+        state.free_chunks[state.num_free_chunks++] = c;
+    } else {
+        ::operator delete((void *)c);
+        live_chunks--;
+    }
+}
+
+Chunk *reuse_chunk() {
+    ArenaState &state = arena_state();
+    if (state.num_free_chunks > 0) {
+        return (Chunk *)state.free_chunks[--state.num_free_chunks];
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+IRArenaScope::IRArenaScope() {
+    arena_state().depth++;
+}
+
+IRArenaScope::~IRArenaScope() {
+    ArenaState &state = arena_state();
+    internal_assert(state.depth > 0);
+    if (--state.depth == 0) {
+        if (state.current) {
+            state.current->release();
+            state.current = nullptr;
+        }
+        // Return any cached chunks to the heap.
+        while (state.num_free_chunks > 0) {
+            ::operator delete(state.free_chunks[--state.num_free_chunks]);
+            live_chunks--;
+        }
+    }
+}
+
+void *ir_node_allocate(size_t size) {
+    ArenaState &state = arena_state();
+    if (state.depth == 0 || size > max_arena_allocation) {
+        char *base = (char *)::operator new(header_size + size);
+        *(Chunk **)base = nullptr;
+        return base + header_size;
+    }
+    void *result = state.current ? state.current->allocate(size) : nullptr;
+    if (!result) {
+        if (state.current) {
+            state.current->release();
+        }
+        state.current = Chunk::make();
+        result = state.current->allocate(size);
+        internal_assert(result);
+    }
+    return result;
+}
+
+void ir_node_deallocate(void *p) {
+    char *base = (char *)p - header_size;
+    Chunk *chunk = *(Chunk **)base;
+    if (chunk) {
+        chunk->release();
+    } else {
+        ::operator delete(base);
+    }
+}
+
+int ir_arena_live_chunks() {
+    return live_chunks;
+}
+
+void ir_arena_test() {
+    int chunks_before = ir_arena_live_chunks();
+    Expr escaped;
+    {
+        IRArenaScope arena;
+        {
+            // Nested scopes share the outer arena.
+            IRArenaScope inner;
+            escaped = Variable::make(Int(32), "x") + 1;
+        }
+        Expr e = escaped;
+        for (int i = 0; i < 10000; i++) {
+            e = e * 2 + i;
+        }
+        internal_assert(ir_arena_live_chunks() > chunks_before + 1);
+    }
+    // Only the chunk holding the escaped expression should remain.
+    internal_assert(ir_arena_live_chunks() == chunks_before + 1);
+    internal_assert(escaped.as<Add>() && escaped.as<Add>()->a.as<Variable>());
+
+    escaped = Expr();
+    internal_assert(ir_arena_live_chunks() == chunks_before);
+
+    // Nodes made outside of any scope are not arena-allocated.
+    Expr heap = Variable::make(Int(32), "y");
+    internal_assert(ir_arena_live_chunks() == chunks_before);
+
+    std::cout << "IR arena test passed" << std::endl;
+}
+
+}
+}
@@ -0,0 +1,52 @@
+#ifndef HALIDE_IR_ARENA_H
+#define HALIDE_IR_ARENA_H
+
+/** \file
+ * Defines an optional arena allocator for IR nodes.
+ */
+
+#include <stddef.h>
+
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+/** While an IRArenaScope is alive, IR nodes created on the current
+ * thread are bump-allocated out of large chunks instead of being
+ * individually heap-allocated. This is much cheaper for the millions
+ * of short-lived nodes made and discarded by lowering passes.
+ *
+ * Nodes may safely outlive the scope that allocated them, and may be
+ * destroyed on any thread. Each chunk counts its live nodes, and is
+ * returned to the heap once the scope has moved on from it and all of
+ * its nodes are gone. The cost is that memory within a chunk is not
+ * reused, so a single long-lived node keeps its whole chunk alive.
+ *
+ * Scopes nest; only the outermost one on each thread has any effect. */
+class IRArenaScope {
+public:
+    EXPORT IRArenaScope();
+    EXPORT ~IRArenaScope();
+
+    IRArenaScope(const IRArenaScope &) = delete;
+    IRArenaScope &operator=(const IRArenaScope &) = delete;
+};
+
+/** Allocate the storage for an IR node. Called by IRNode's operator new. */
+EXPORT void *ir_node_allocate(size_t size);
+
+/** Release storage returned by ir_node_allocate, whether or not it
+ * came from an arena. Called by IRNode's operator delete. */
+EXPORT void ir_node_deallocate(void *p);
+
+/** The number of arena chunks currently allocated, across all
+ * threads. Intended for testing. */
+EXPORT int ir_arena_live_chunks();
+
+EXPORT void ir_arena_test();
+
+}
+}
+
+#endif
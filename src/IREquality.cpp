@@ -90,6 +90,7 @@ private:
     void visit(const Evaluate *);
     void visit(const Shuffle *);
     void visit(const Prefetch *);
+    void visit(const VectorReduce *);
 };
 
 template<typename T>
@@ -451,6 +452,13 @@ void IRComparer::visit(const Shuffle *op) {
     }
 }
 
+void IRComparer::visit(const VectorReduce *op) {
+    const VectorReduce *e = expr.as<VectorReduce>();
+
+    compare_scalar(e->op, op->op);
+    compare_expr(e->value, op->value);
+}
+
 void IRComparer::visit(const Prefetch *op) {
     const Prefetch *s = expr.as<Prefetch>();
 
@@ -46,6 +46,33 @@ void expr_match_test() {
 
     internal_assert(expr_match(vec_wild * 3, Ramp::make(x, y, 4) * 3, matches));
 
+    {
+        using namespace IRMatcher;
+        Wild<0> a;
+        Wild<1> b;
+        WildConst<0> c0;
+        WildConst<1> c1;
+
+        Expr max_x_y = max(x, y);
+        auto rewrite = rewriter<Min>(max_x_y, x, Int(32));
+        internal_assert(!rewrite(min(max(a, b), b), b));
+        internal_assert(rewrite(min(max(a, b), a), a) &&
+                        equal(rewrite.result, x));
+
+        Expr x_plus_3 = x + 3, four = 4;
+        auto rewrite_const = rewriter<Add>(x_plus_3, four, Int(32));
+        internal_assert(!rewrite_const((a + c0) + c1, a + c0, c1 < 0));
+        internal_assert(rewrite_const((a + c0) + c1, a + (c0 + c1), c0 + c1 != 0) &&
+                        equal(rewrite_const.result, x + (Expr(3) + 4)));
+
+        // Repeated wildcards must bind equal subexpressions
+        Expr x_times_2 = x * 2, y_times_2 = y * 2;
+        auto rewrite_repeat = rewriter<Sub>(x_times_2, y_times_2, Int(32));
+        internal_assert(!rewrite_repeat(a * c0 - a * c0, 0));
+        internal_assert(rewrite_repeat(a * c0 - b * c0, (a - b) * c0) &&
+                        equal(rewrite_repeat.result, (x - y) * 2));
+    }
+
     std::cout << "expr_match test passed" << std::endl;
 }
 
@@ -221,6 +248,16 @@ public:
         }
     }
 
+    void visit(const VectorReduce *op) {
+        const VectorReduce *e = expr.as<VectorReduce>();
+        if (result && e && op->op == e->op && types_match(op->type, e->type)) {
+            expr = e->value;
+            op->value.accept(this);
+        } else {
+            result = false;
+        }
+    }
+
     void visit(const Call *op) {
         const Call *e = expr.as<Call>();
         if (result && e &&
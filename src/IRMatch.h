@@ -5,7 +5,13 @@
  * Defines a method to match a fragment of IR against a pattern containing wildcards
  */
 
+#include <limits>
+#include <type_traits>
+
 #include "IR.h"
+#include "IREquality.h"
+#include "IROperator.h"
+#include "Simplify.h"
 
 namespace Halide {
 namespace Internal {
@@ -43,6 +49,336 @@ EXPORT bool expr_match(Expr pattern, Expr expr, std::vector<Expr> &result);
  */
 EXPORT bool expr_match(Expr pattern, Expr expr, std::map<std::string, Expr> &result);
 
+/** A compile-time pattern matching and rewriting engine, used by the
+ * simplifier to express rewrite rules declaratively. A rule is a pair
+ * of pattern expressions built from wildcards, constants, and the
+ * usual operators. The patterns are ordinary C++ templates, so the
+ * structure of each rule is known at compile time and matching
+ * compiles down to a chain of node type checks with no intermediate
+ * allocations. For example:
+ \code
+ using namespace IRMatcher;
+ Wild<0> x;
+ Wild<1> y;
+ WildConst<0> c0;
+ WildConst<1> c1;
+ auto rewrite = rewriter<Min>(a, b, op->type);
+ if (rewrite(min(max(x, y), x), x) ||
+     rewrite(min(x + c0, x + c1), x + c0, c0 <= c1)) {
+     return rewrite.result;
+ }
+ \endcode
+ */
+namespace IRMatcher {
+
+/** The maximum number of distinct wildcards of each kind in one rule. */
+constexpr int max_wild = 6;
+
+/** The bindings made while matching a pattern against an Expr. */
+struct MatcherState {
+    const BaseExprNode *bindings[max_wild];
+    const BaseExprNode *const_bindings[max_wild];
+    uint32_t bound = 0, const_bound = 0;
+
+    void reset() {
+        bound = const_bound = 0;
+    }
+};
+
+/** Tag type used to identify pattern types for the operator overloads below. */
+struct PatternTag {};
+
+template<typename T>
+struct is_pattern {
+    template<typename U>
+    static char test(typename U::pattern_tag *);
+    template<typename U>
+    static long test(...);
+    static constexpr bool value = sizeof(test<T>(nullptr)) == sizeof(char);
+};
+
+/** Matches any Expr. Repeated uses of the same wildcard within a
+ * pattern must match equal Exprs. */
+template<int i>
+struct Wild {
+    typedef PatternTag pattern_tag;
+    static_assert(i >= 0 && i < max_wild, "Wildcard index out of range");
+
+    bool match(const BaseExprNode &e, MatcherState &state) const {
+        if (state.bound & (1 << i)) {
+            return (state.bindings[i] == &e ||
+                    equal(Expr(state.bindings[i]), Expr(&e)));
+        }
+        state.bound |= (1 << i);
+        state.bindings[i] = &e;
+        return true;
+    }
+
+    Expr make(const MatcherState &state, Type) const {
+        internal_assert(state.bound & (1 << i)) << "Unbound wildcard in rewrite rule\n";
+        return Expr(state.bindings[i]);
+    }
+
+    bool fold(const MatcherState &, int64_t *) const {
+        return false;
+    }
+};
+
+/** Matches a scalar constant. Unlike Wild, the bound value can be
+ * folded into the predicate of a rewrite rule. */
+template<int i>
+struct WildConst {
+    typedef PatternTag pattern_tag;
+    static_assert(i >= 0 && i < max_wild, "Wildcard index out of range");
+
+    bool match(const BaseExprNode &e, MatcherState &state) const {
+        if (e.node_type != IRNodeType::IntImm &&
+            e.node_type != IRNodeType::UIntImm &&
+            e.node_type != IRNodeType::FloatImm) {
+            return false;
+        }
+        if (state.const_bound & (1 << i)) {
+            return equal(Expr(state.const_bindings[i]), Expr(&e));
+        }
+        state.const_bound |= (1 << i);
+        state.const_bindings[i] = &e;
+        return true;
+    }
+
+    Expr make(const MatcherState &state, Type) const {
+        internal_assert(state.const_bound & (1 << i)) << "Unbound constant wildcard in rewrite rule\n";
+        return Expr(state.const_bindings[i]);
+    }
+
+    bool fold(const MatcherState &state, int64_t *result) const {
+        if (!(state.const_bound & (1 << i))) return false;
+        const BaseExprNode *e = state.const_bindings[i];
+        if (e->node_type == IRNodeType::IntImm) {
+            *result = ((const IntImm *)e)->value;
+            return true;
+        } else if (e->node_type == IRNodeType::UIntImm) {
+            uint64_t u = ((const UIntImm *)e)->value;
+            *result = (int64_t)u;
+            return u <= (uint64_t)std::numeric_limits<int64_t>::max();
+        }
+        return false;
+    }
+};
+
+/** Matches a specific integer constant. Created implicitly when an
+ * integer is used as an operand in a pattern. */
+struct IntLiteral {
+    typedef PatternTag pattern_tag;
+    int64_t v;
+
+    IntLiteral(int64_t v) : v(v) {}
+
+    bool match(const BaseExprNode &e, MatcherState &) const {
+        switch (e.node_type) {
+        case IRNodeType::IntImm:
+            return ((const IntImm &)e).value == v;
+        case IRNodeType::UIntImm:
+            return v >= 0 && ((const UIntImm &)e).value == (uint64_t)v;
+        case IRNodeType::FloatImm:
+            return ((const FloatImm &)e).value == (double)v;
+        default:
+            return false;
+        }
+    }
+
+    Expr make(const MatcherState &, Type type_hint) const {
+        return make_const(type_hint, v);
+    }
+
+    bool fold(const MatcherState &, int64_t *result) const {
+        *result = v;
+        return true;
+    }
+};
+
+/** Wraps an existing Expr so that it can be returned as the result
+ * of a rewrite without reconstructing it. */
+struct SpecificExpr {
+    typedef PatternTag pattern_tag;
+    const Expr &expr;
+
+    bool match(const BaseExprNode &e, MatcherState &) const {
+        return expr.get() == &e || equal(expr, Expr(&e));
+    }
+
+    Expr make(const MatcherState &, Type) const {
+        return expr;
+    }
+
+    bool fold(const MatcherState &, int64_t *) const {
+        return false;
+    }
+};
+
+template<typename T,
+         typename = typename std::enable_if<is_pattern<T>::value>::type>
+inline T pattern_arg(T t) {
+    return t;
+}
+
+inline IntLiteral pattern_arg(int64_t v) {
+    return IntLiteral(v);
+}
+
+inline SpecificExpr pattern_arg(const Expr &e) {
+    return SpecificExpr{e};
+}
+
+/** Constant folding of the operators for rule predicates. Returns
+ * false if the result isn't known (e.g. division by zero). */
+// @{
+template<typename Op>
+bool fold_op(int64_t a, int64_t b, int64_t *result);
+
+template<> inline bool fold_op<Add>(int64_t a, int64_t b, int64_t *r) {*r = a + b; return true;}
+template<> inline bool fold_op<Sub>(int64_t a, int64_t b, int64_t *r) {*r = a - b; return true;}
+template<> inline bool fold_op<Mul>(int64_t a, int64_t b, int64_t *r) {*r = a * b; return true;}
+template<> inline bool fold_op<Div>(int64_t a, int64_t b, int64_t *r) {*r = b ? div_imp(a, b) : 0; return b != 0;}
+template<> inline bool fold_op<Mod>(int64_t a, int64_t b, int64_t *r) {*r = b ? mod_imp(a, b) : 0; return b != 0;}
+template<> inline bool fold_op<Min>(int64_t a, int64_t b, int64_t *r) {*r = std::min(a, b); return true;}
+template<> inline bool fold_op<Max>(int64_t a, int64_t b, int64_t *r) {*r = std::max(a, b); return true;}
+template<> inline bool fold_op<EQ>(int64_t a, int64_t b, int64_t *r) {*r = a == b; return true;}
+template<> inline bool fold_op<NE>(int64_t a, int64_t b, int64_t *r) {*r = a != b; return true;}
+template<> inline bool fold_op<LT>(int64_t a, int64_t b, int64_t *r) {*r = a < b; return true;}
+template<> inline bool fold_op<LE>(int64_t a, int64_t b, int64_t *r) {*r = a <= b; return true;}
+template<> inline bool fold_op<GT>(int64_t a, int64_t b, int64_t *r) {*r = a > b; return true;}
+template<> inline bool fold_op<GE>(int64_t a, int64_t b, int64_t *r) {*r = a >= b; return true;}
+template<> inline bool fold_op<And>(int64_t a, int64_t b, int64_t *r) {*r = a && b; return true;}
+template<> inline bool fold_op<Or>(int64_t a, int64_t b, int64_t *r) {*r = a || b; return true;}
+// @}
+
+/** Matches a binary IR node of type Op whose operands match A and B. */
+template<typename Op, typename A, typename B>
+struct BinOp {
+    typedef PatternTag pattern_tag;
+    typedef Op op_type;
+    A a;
+    B b;
+
+    bool match(const BaseExprNode &e, MatcherState &state) const {
+        if (e.node_type != Op::_node_type) {
+            return false;
+        }
+        const Op &op = (const Op &)e;
+        return match_operands(op.a, op.b, state);
+    }
+
+    bool match_operands(const Expr &ea, const Expr &eb, MatcherState &state) const {
+        return (a.match(*(const BaseExprNode *)ea.get(), state) &&
+                b.match(*(const BaseExprNode *)eb.get(), state));
+    }
+
+    Expr make(const MatcherState &state, Type type_hint) const {
+        // Comparisons and boolean ops produce a bool, so the operand
+        // type can't be inferred from the hint. Prefer the type of
+        // whichever operand isn't a literal.
+        Expr ea, eb;
+        if (std::is_same<A, IntLiteral>::value) {
+            eb = b.make(state, type_hint);
+            ea = a.make(state, eb.type());
+        } else {
+            ea = a.make(state, type_hint);
+            eb = b.make(state, ea.type());
+        }
+        return Op::make(ea, eb);
+    }
+
+    bool fold(const MatcherState &state, int64_t *result) const {
+        int64_t fa, fb;
+        return (a.fold(state, &fa) &&
+                b.fold(state, &fb) &&
+                fold_op<Op>(fa, fb, result));
+    }
+};
+
+#define HALIDE_PATTERN_BINOP(Op, name)                                  \
+    template<typename A, typename B,                                    \
+             typename = typename std::enable_if<is_pattern<A>::value || \
+                                                is_pattern<B>::value>::type> \
+    auto name(A a, B b) -> BinOp<Op, decltype(pattern_arg(a)), decltype(pattern_arg(b))> { \
+        return {pattern_arg(a), pattern_arg(b)};                        \
+    }
+
+HALIDE_PATTERN_BINOP(Add, operator+)
+HALIDE_PATTERN_BINOP(Sub, operator-)
+HALIDE_PATTERN_BINOP(Mul, operator*)
+HALIDE_PATTERN_BINOP(Div, operator/)
+HALIDE_PATTERN_BINOP(Mod, operator%)
+HALIDE_PATTERN_BINOP(Min, min)
+HALIDE_PATTERN_BINOP(Max, max)
+HALIDE_PATTERN_BINOP(EQ, operator==)
+HALIDE_PATTERN_BINOP(NE, operator!=)
+HALIDE_PATTERN_BINOP(LT, operator<)
+HALIDE_PATTERN_BINOP(LE, operator<=)
+HALIDE_PATTERN_BINOP(GT, operator>)
+HALIDE_PATTERN_BINOP(GE, operator>=)
+HALIDE_PATTERN_BINOP(And, operator&&)
+HALIDE_PATTERN_BINOP(Or, operator||)
+
+#undef HALIDE_PATTERN_BINOP
+
+/** Applies rewrite rules to a binary op of type Op with the given
+ * (already simplified) operands. Each call tries one rule. If the
+ * "before" pattern matches, and the predicate (if any) constant-folds
+ * to true, the "after" pattern is instantiated into result and the
+ * call returns true. The root of each "before" pattern must be of
+ * type Op, which is checked at compile time. */
+template<typename Op>
+struct Rewriter {
+    const Expr &a, &b;
+    Type type;
+    Expr result;
+    MatcherState state;
+
+    Rewriter(const Expr &a, const Expr &b, Type t) : a(a), b(b), type(t) {}
+
+    template<typename Before>
+    bool match(const Before &before) {
+        static_assert(std::is_same<typename Before::op_type, Op>::value,
+                      "Root of rewrite rule does not match the rewriter's node type");
+        state.reset();
+        return before.match_operands(a, b, state);
+    }
+
+    template<typename Before, typename After>
+    bool operator()(const Before &before, const After &after) {
+        if (match(before)) {
+            result = pattern_arg(after).make(state, type);
+            return true;
+        }
+        return false;
+    }
+
+    template<typename Before, typename After, typename Predicate>
+    bool operator()(const Before &before, const After &after, const Predicate &pred) {
+        int64_t p = 0;
+        if (match(before) && pred.fold(state, &p) && p) {
+            result = pattern_arg(after).make(state, type);
+            return true;
+        }
+        return false;
+    }
+};
+
+/** Make a Rewriter for a binary op. The rewriter refers to the
+ * operands rather than copying them, so they must outlive it. */
+template<typename Op>
+Rewriter<Op> rewriter(const Expr &a, const Expr &b, Type t) {
+    return Rewriter<Op>(a, b, t);
+}
+
+template<typename Op>
+void rewriter(Expr &&a, const Expr &b, Type t) = delete;
+template<typename Op>
+void rewriter(const Expr &a, Expr &&b, Type t) = delete;
+
+}
+
 EXPORT void expr_match_test();
 
 }
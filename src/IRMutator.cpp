@@ -375,6 +375,15 @@ void IRMutator::visit(const Shuffle *op) {
     }
 }
 
+void IRMutator::visit(const VectorReduce *op) {
+    Expr value = mutate(op->value);
+    if (value.same_as(op->value)) {
+        expr = op;
+    } else {
+        expr = VectorReduce::make(op->op, std::move(value), op->type.lanes());
+    }
+}
+
 
 Stmt IRGraphMutator::mutate(const Stmt &s) {
     auto iter = stmt_replacements.find(s);
@@ -84,6 +84,7 @@ protected:
     EXPORT virtual void visit(const Evaluate *);
     EXPORT virtual void visit(const Shuffle *);
     EXPORT virtual void visit(const Prefetch *);
+    EXPORT virtual void visit(const VectorReduce *);
 };
 
 
@@ -289,7 +289,7 @@ Expr make_const_helper(Type t, T val) {
         return IntImm::make(t, (int64_t)val);
     } else if (t.is_uint()) {
         return UIntImm::make(t, (uint64_t)val);
-    } else if (t.is_float()) {
+    } else if (t.is_float() || t.is_bfloat()) {
         return FloatImm::make(t, (double)val);
     } else {
         internal_error << "Can't make a constant of type " << t << "\n";
@@ -427,21 +427,31 @@ void match_types(Expr &a, Expr &b) {
     // If type widening has made the types match no additional casts are needed
     if (ta == tb) return;
 
-    if (!ta.is_float() && tb.is_float()) {
+    // bfloat16 follows the same rules as the other floats.
+    bool a_float = ta.is_float() || ta.is_bfloat();
+    bool b_float = tb.is_float() || tb.is_bfloat();
+
+    if (!a_float && b_float) {
         // int(a) * float(b) -> float(b)
         // uint(a) * float(b) -> float(b)
         a = cast(tb, std::move(a));
-    } else if (ta.is_float() && !tb.is_float()) {
+    } else if (a_float && !b_float) {
         b = cast(ta, std::move(b));
-    } else if (ta.is_float() && tb.is_float()) {
+    } else if (a_float && b_float) {
         // float(a) * float(b) -> float(max(a, b))
         if (ta.bits() > tb.bits()) b = cast(ta, std::move(b));
-        else a = cast(tb, std::move(a));
+        else if (ta.bits() < tb.bits()) a = cast(tb, std::move(a));
+        else {
+            // float16 * bfloat16 -> float32, which represents both exactly
+            Type t = Float(32, ta.lanes());
+            a = cast(t, std::move(a));
+            b = cast(t, std::move(b));
+        }
     } else if (ta.is_uint() && tb.is_uint()) {
         // uint(a) * uint(b) -> uint(max(a, b))
         if (ta.bits() > tb.bits()) b = cast(ta, std::move(b));
         else a = cast(tb, std::move(a));
-    } else if (!ta.is_float() && !tb.is_float()) {
+    } else if (!a_float && !b_float) {
         // int(a) * (u)int(b) -> int(max(a, b))
         int bits = std::max(ta.bits(), tb.bits());
         int lanes = a.type().lanes();
@@ -888,7 +898,9 @@ Expr memoize_tag_helper(Expr result, const std::vector<Expr> &cache_key_values)
 
 Expr saturating_cast(Type t, Expr e) {
     // For float to float, guarantee infinities are always pinned to range.
-    if (t.is_float() && e.type().is_float()) {
+    bool t_float = t.is_float() || t.is_bfloat();
+    bool e_float = e.type().is_float() || e.type().is_bfloat();
+    if (t_float && e_float) {
         if (t.bits() < e.type().bits()) {
             e = cast(t, clamp(std::move(e), t.min(), t.max()));
         } else {
@@ -896,7 +908,7 @@ Expr saturating_cast(Type t, Expr e) {
         }
     } else if (e.type() != t) {
         // Limits for Int(2^n) or UInt(2^n) are not exactly representable in Float(2^n)
-        if (e.type().is_float() && !t.is_float() && t.bits() >= e.type().bits()) {
+        if (e_float && !t_float && t.bits() >= e.type().bits()) {
             e = max(std::move(e), t.min()); // min values turn out to be always representable
 
             // This line depends on t.max() rounding upward, which should always
@@ -96,6 +96,7 @@ inline Expr make_const(Type t, uint8_t val)   {return make_const(t, (uint64_t)va
 inline Expr make_const(Type t, bool val)      {return make_const(t, (uint64_t)val);}
 inline Expr make_const(Type t, float val)     {return make_const(t, (double)val);}
 inline Expr make_const(Type t, float16_t val) {return make_const(t, (double)val);}
+inline Expr make_const(Type t, bfloat16_t val) {return make_const(t, (double)val);}
 // @}
 
 /** Check if a constant value can be correctly represented as the given type. */
@@ -854,7 +855,7 @@ inline Expr absd(Expr a, Expr b) {
     Internal::match_types(a, b);
     Type t = a.type();
 
-    if (t.is_float()) {
+    if (t.is_float() || t.is_bfloat()) {
         // Floats can just use abs.
         return abs(std::move(a) - std::move(b));
     }
@@ -1242,6 +1243,9 @@ inline Expr floor(Expr x) {
         return Internal::Call::make(t, "floor_f64", {std::move(x)}, Internal::Call::PureExtern);
     } else if (t.element_of() == Float(16)) {
         return Internal::Call::make(t, "floor_f16", {std::move(x)}, Internal::Call::PureExtern);
+    } else if (t.is_bfloat()) {
+        // Whole numbers in range of a bfloat are exact, so do it in float.
+        return cast(t, floor(cast(Float(32, t.lanes()), std::move(x))));
     } else {
         t = t.with_code(Type::Float);
         return Internal::Call::make(t, "floor_f32", {cast(t, std::move(x))}, Internal::Call::PureExtern);
@@ -1259,6 +1263,9 @@ inline Expr ceil(Expr x) {
         return Internal::Call::make(t, "ceil_f64", {std::move(x)}, Internal::Call::PureExtern);
     } else if (x.type().element_of() == Float(16)) {
         return Internal::Call::make(t, "ceil_f16", {std::move(x)}, Internal::Call::PureExtern);
+    } else if (t.is_bfloat()) {
+        // Whole numbers in range of a bfloat are exact, so do it in float.
+        return cast(t, ceil(cast(Float(32, t.lanes()), std::move(x))));
     } else {
         t = t.with_code(Type::Float);
         return Internal::Call::make(t, "ceil_f32", {cast(t, std::move(x))}, Internal::Call::PureExtern);
@@ -1277,6 +1284,9 @@ inline Expr round(Expr x) {
         return Internal::Call::make(t, "round_f64", {std::move(x)}, Internal::Call::PureExtern);
     } else if (t.element_of() == Float(16)) {
         return Internal::Call::make(t, "round_f16", {std::move(x)}, Internal::Call::PureExtern);
+    } else if (t.is_bfloat()) {
+        // Whole numbers in range of a bfloat are exact, so do it in float.
+        return cast(t, round(cast(Float(32, t.lanes()), std::move(x))));
     } else {
         t = t.with_code(Type::Float);
         return Internal::Call::make(t, "round_f32", {cast(t, std::move(x))}, Internal::Call::PureExtern);
@@ -1293,6 +1303,9 @@ inline Expr trunc(Expr x) {
         return Internal::Call::make(t, "trunc_f64", {std::move(x)}, Internal::Call::PureExtern);
     } else if (t.element_of() == Float(16)) {
         return Internal::Call::make(t, "trunc_f16", {std::move(x)}, Internal::Call::PureExtern);
+    } else if (t.is_bfloat()) {
+        // Whole numbers in range of a bfloat are exact, so do it in float.
+        return cast(t, trunc(cast(Float(32, t.lanes()), std::move(x))));
     } else {
         t = t.with_code(Type::Float);
         return Internal::Call::make(t, "trunc_f32", {cast(t, std::move(x))}, Internal::Call::PureExtern);
@@ -1303,12 +1316,14 @@ inline Expr trunc(Expr x) {
   * floating point argument.  Vectorizes cleanly. */
 inline Expr is_nan(Expr x) {
     user_assert(x.defined()) << "is_nan of undefined Expr\n";
-    user_assert(x.type().is_float()) << "is_nan only works for float";
+    user_assert(x.type().is_float() || x.type().is_bfloat()) << "is_nan only works for float";
     Type t = Bool(x.type().lanes());
     if (x.type().element_of() == Float(64)) {
         return Internal::Call::make(t, "is_nan_f64", {std::move(x)}, Internal::Call::PureExtern);
     } else if (x.type().element_of() == Float(64)) {
         return Internal::Call::make(t, "is_nan_f16", {std::move(x)}, Internal::Call::PureExtern);
+    } else if (x.type().is_bfloat()) {
+        return is_nan(cast(Float(32, x.type().lanes()), std::move(x)));
     } else {
         Type ft = x.type().with_code(Type::Float);
         return Internal::Call::make(t, "is_nan_f32", {cast(ft, std::move(x))}, Internal::Call::PureExtern);
@@ -1420,8 +1435,8 @@ inline Expr operator~(Expr x) {
 // @{
 inline Expr operator<<(Expr x, Expr y) {
     user_assert(x.defined() && y.defined()) << "shift left of undefined Expr\n";
-    user_assert(!x.type().is_float()) << "First argument to shift left is a float: " << x << "\n";
-    user_assert(!y.type().is_float()) << "Second argument to shift left is a float: " << y << "\n";
+    user_assert(!x.type().is_float() && !x.type().is_bfloat()) << "First argument to shift left is a float: " << x << "\n";
+    user_assert(!y.type().is_float() && !y.type().is_bfloat()) << "Second argument to shift left is a float: " << y << "\n";
     Internal::match_types(x, y);
     Type t = x.type();
     return Internal::Call::make(t, Internal::Call::shift_left, {std::move(x), std::move(y)}, Internal::Call::PureIntrinsic);
@@ -1449,8 +1464,8 @@ inline Expr operator<<(int x, Expr y) {
 // @{
 inline Expr operator>>(Expr x, Expr y) {
     user_assert(x.defined() && y.defined()) << "shift right of undefined Expr\n";
-    user_assert(!x.type().is_float()) << "First argument to shift right is a float: " << x << "\n";
-    user_assert(!y.type().is_float()) << "Second argument to shift right is a float: " << y << "\n";
+    user_assert(!x.type().is_float() && !x.type().is_bfloat()) << "First argument to shift right is a float: " << x << "\n";
+    user_assert(!y.type().is_float() && !y.type().is_bfloat()) << "Second argument to shift right is a float: " << y << "\n";
     Internal::match_types(x, y);
     Type t = x.type();
     return Internal::Call::make(t, Internal::Call::shift_right, {std::move(x), std::move(y)}, Internal::Call::PureIntrinsic);
@@ -1554,14 +1569,15 @@ inline Expr lerp(Expr zero_val, Expr one_val, Expr weight) {
     user_assert(zero_val.type() == one_val.type())
         << "Can't lerp between " << zero_val << " of type " << zero_val.type()
         << " and " << one_val << " of different type " << one_val.type() << "\n";
-    user_assert((weight.type().is_uint() || weight.type().is_float()))
+    user_assert((weight.type().is_uint() || weight.type().is_float() || weight.type().is_bfloat()))
         << "A lerp weight must be an unsigned integer or a float, but "
         << "lerp weight " << weight << " has type " << weight.type() << ".\n";
-    user_assert((zero_val.type().is_float() || zero_val.type().lanes() <= 32))
+    user_assert((zero_val.type().is_float() || zero_val.type().is_bfloat() ||
+                 zero_val.type().lanes() <= 32))
         << "Lerping between 64-bit integers is not supported\n";
     // Compilation error for constant weight that is out of range for integer use
     // as this seems like an easy to catch gotcha.
-    if (!zero_val.type().is_float()) {
+    if (!zero_val.type().is_float() && !zero_val.type().is_bfloat()) {
         const double *const_weight = as_const_float(weight);
         if (const_weight) {
             user_assert(*const_weight >= 0.0 && *const_weight <= 1.0)
@@ -25,6 +25,9 @@ ostream &operator<<(ostream &out, const Type &type) {
     case Type::Float:
         out << "float";
         break;
+    case Type::BFloat:
+        out << "bfloat";
+        break;
     case Type::Handle:
         if (type.handle_type) {
             out << "(" << type.handle_type->inner_name.name << " *)";
@@ -215,6 +218,30 @@ ostream &operator<<(ostream &out, const NameMangling &m) {
     return out;
 }
 
+ostream &operator<<(ostream &out, const VectorReduce::Operator &op) {
+    switch (op) {
+    case VectorReduce::Add:
+        out << "Add";
+        break;
+    case VectorReduce::Mul:
+        out << "Mul";
+        break;
+    case VectorReduce::Min:
+        out << "Min";
+        break;
+    case VectorReduce::Max:
+        out << "Max";
+        break;
+    case VectorReduce::And:
+        out << "And";
+        break;
+    case VectorReduce::Or:
+        out << "Or";
+        break;
+    }
+    return out;
+}
+
 ostream &operator<<(ostream &stream, const Stmt &ir) {
     if (!ir.defined()) {
         stream << "(undefined)\n";
@@ -302,7 +329,11 @@ void IRPrinter::visit(const FloatImm *op) {
         stream << op->value << 'f';
         break;
     case 16:
-        stream << op->value << 'h';
+        if (op->type.is_bfloat()) {
+            stream << op->value << "bf";
+        } else {
+            stream << op->value << 'h';
+        }
         break;
     default:
         internal_error << "Bad bit-width for float: " << op->type << "\n";
@@ -756,4 +787,14 @@ void IRPrinter::visit(const Shuffle *op) {
     }
 }
 
+void IRPrinter::visit(const VectorReduce *op) {
+    stream << "("
+           << op->type
+           << ")vector_reduce("
+           << op->op
+           << ", ";
+    print(op->value);
+    stream << ")";
+}
+
 }}
@@ -63,6 +63,10 @@ EXPORT std::ostream &operator<<(std::ostream &stream, const ForType &);
 /** Emit a halide name mangling value in a human readable format */
 EXPORT std::ostream &operator<<(std::ostream &stream, const NameMangling &);
 
+/** Emit a horizontal vector reduction operator in a human readable
+ * form */
+EXPORT std::ostream &operator<<(std::ostream &stream, const VectorReduce::Operator &);
+
 /** An IRVisitor that emits IR to the given output stream in a human
  * readable form. Can be subclassed if you want to modify the way in
  * which it prints.
@@ -140,6 +144,7 @@ protected:
     void visit(const Evaluate *);
     void visit(const Shuffle *);
     void visit(const Prefetch *);
+    void visit(const VectorReduce *);
 };
 }
 }
@@ -0,0 +1,73 @@
+#include <set>
+
+#include "InjectNontemporalStores.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::set;
+using std::string;
+
+namespace {
+
+class InjectNontemporalStores : public IRMutator {
+    using IRMutator::visit;
+
+    const set<string> &names;
+
+    void visit(const For *op) {
+        if (op->device_api == DeviceAPI::None ||
+            op->device_api == DeviceAPI::Host ||
+            op->device_api == DeviceAPI::Hexagon) {
+            IRMutator::visit(op);
+        } else {
+            // Leave GPU kernels alone.
+            stmt = op;
+        }
+    }
+
+    void visit(const Store *op) {
+        const Ramp *ramp = op->index.as<Ramp>();
+        if (!names.count(op->name) ||
+            !ramp || !is_one(ramp->stride) ||
+            !is_one(op->predicate)) {
+            IRMutator::visit(op);
+            return;
+        }
+        Expr value = Call::make(op->value.type(), Call::nontemporal,
+                                {op->value}, Call::PureIntrinsic);
+        stmt = Store::make(op->name, value, op->index, op->param, op->predicate);
+    }
+
+public:
+    InjectNontemporalStores(const set<string> &n) : names(n) {}
+};
+
+}
+
+Stmt inject_nontemporal_stores(Stmt s, const map<string, Function> &env) {
+    set<string> names;
+    for (const auto &p : env) {
+        const Function &f = p.second;
+        if (!f.schedule().store_nontemporal()) {
+            continue;
+        }
+        if (f.outputs() == 1) {
+            names.insert(f.name());
+        } else {
+            for (int i = 0; i < f.outputs(); i++) {
+                names.insert(f.name() + "." + std::to_string(i));
+            }
+        }
+    }
+    if (names.empty()) {
+        return s;
+    }
+    return InjectNontemporalStores(names).mutate(s);
+}
+
+}
+}
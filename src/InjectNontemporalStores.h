@@ -0,0 +1,26 @@
+#ifndef HALIDE_INJECT_NONTEMPORAL_STORES_H
+#define HALIDE_INJECT_NONTEMPORAL_STORES_H
+
+/** \file
+ * Defines the lowering pass that marks the stores of functions
+ * scheduled with store_nontemporal.
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Wrap the values of the dense vector stores to functions scheduled
+ * with Func::store_nontemporal in the nontemporal intrinsic, which
+ * tells the backend to bypass the caches. Stores in device loops other
+ * than Hexagon are left alone. This should be run at the end of
+ * lowering, so that no later pass moves or drops the intrinsic. */
+Stmt inject_nontemporal_stores(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
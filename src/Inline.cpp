@@ -36,6 +36,16 @@ void validate_schedule_inlined_function(Function f) {
                    << f.name() << " because the function is scheduled inline.\n";
     }
 
+    if (func_s.store_in_registers()) {
+        user_error << "Cannot store function " << f.name()
+                   << " in registers because the function is scheduled inline.\n";
+    }
+
+    if (func_s.store_nontemporal()) {
+        user_error << "Cannot use non-temporal stores for function " << f.name()
+                   << " because the function is scheduled inline.\n";
+    }
+
     for (size_t i = 0; i < stage_s.dims().size(); i++) {
         Dim d = stage_s.dims()[i];
         if (d.is_parallel()) {
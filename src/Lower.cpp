@@ -1,4 +1,5 @@
 #include <iostream>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <algorithm>
@@ -17,6 +18,7 @@
 #include "DebugToFile.h"
 #include "Deinterleave.h"
 #include "EarlyFree.h"
+#include "EmulateFloat16Math.h"
 #include "FindCalls.h"
 #include "Func.h"
 #include "Function.h"
@@ -25,8 +27,10 @@
 #include "HexagonOffload.h"
 #include "InferArguments.h"
 #include "InjectHostDevBufferCopies.h"
+#include "InjectNontemporalStores.h"
 #include "InjectOpenGLIntrinsics.h"
 #include "Inline.h"
+#include "IRArena.h"
 #include "IRMutator.h"
 #include "IROperator.h"
 #include "IRPrinter.h"
@@ -36,6 +40,7 @@
 #include "PartitionLoops.h"
 #include "Prefetch.h"
 #include "Profiling.h"
+#include "PromoteRegisterStorage.h"
 #include "Qualify.h"
 #include "RealizationOrder.h"
 #include "RemoveDeadAllocations.h"
@@ -71,9 +76,26 @@ using std::string;
 using std::vector;
 using std::map;
 
+namespace {
+bool use_ir_arena() {
+    static bool cached = ([]() -> bool {
+        std::string value = get_env_variable("HL_IR_ARENA");
+        return !value.empty() && atoi(value.c_str()) != 0;
+    })();
+    return cached;
+}
+}
+
 Module lower(const vector<Function> &output_funcs, const string &pipeline_name, const Target &t,
              const vector<Argument> &args, const Internal::LoweredFunc::LinkageType linkage_type,
              const vector<IRMutator *> &custom_passes) {
+    // Lowering makes and discards a huge number of IR nodes. Optionally
+    // allocate them from an arena.
+    std::unique_ptr<IRArenaScope> arena;
+    if (use_ir_arena()) {
+        arena.reset(new IRArenaScope);
+    }
+
     std::vector<std::string> namespaces;
     std::string simple_pipeline_name = extract_namespaces(pipeline_name, namespaces);
 
@@ -184,7 +206,7 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
     debug(2) << "Lowering after first simplification:\n" << s << "\n\n";
 
     debug(1) << "Injecting prefetches...\n";
-    s = inject_prefetch(s, env);
+    s = inject_prefetch(s, env, t);
     debug(2) << "Lowering after injecting prefetches:\n" << s << "\n\n";
 
     debug(1) << "Dynamically skipping stages...\n";
@@ -252,7 +274,7 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
     debug(2) << "Lowering after reduce prefetch dimension:\n" << s << "\n";
 
     debug(1) << "Unrolling...\n";
-    s = unroll_loops(s);
+    s = unroll_loops(s, t);
     s = simplify(s);
     debug(2) << "Lowering after unrolling:\n" << s << "\n\n";
 
@@ -275,6 +297,10 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
     s = trim_no_ops(s);
     debug(2) << "Lowering after loop trimming:\n" << s << "\n\n";
 
+    debug(1) << "Promoting storage to registers...\n";
+    s = promote_register_storage(s, env);
+    debug(2) << "Lowering after promoting storage to registers:\n" << s << "\n\n";
+
     debug(1) << "Injecting early frees...\n";
     s = inject_early_frees(s);
     debug(2) << "Lowering after injecting early frees:\n" << s << "\n\n";
@@ -291,6 +317,10 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
         debug(2) << "Lowering after fuzzing floating point stores:\n" << s << "\n\n";
     }
 
+    debug(1) << "Emulating 16-bit float math...\n";
+    s = emulate_float16_math(s, t);
+    debug(2) << "Lowering after emulating 16-bit float math:\n" << s << "\n\n";
+
     debug(1) << "Simplifying...\n";
     s = common_subexpression_elimination(s);
     s = loop_invariant_code_motion(s);
@@ -310,6 +340,10 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
     s = simplify(s);
     debug(1) << "Lowering after final simplification:\n" << s << "\n\n";
 
+    debug(1) << "Injecting non-temporal stores...\n";
+    s = inject_nontemporal_stores(s, env);
+    debug(2) << "Lowering after injecting non-temporal stores:\n" << s << "\n\n";
+
     debug(1) << "Splitting off Hexagon offload...\n";
     s = inject_hexagon_rpc(s, t, result_module);
     debug(2) << "Lowering after splitting off Hexagon offload:\n" << s << '\n';
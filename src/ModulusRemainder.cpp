@@ -61,6 +61,7 @@ public:
     void visit(const Evaluate *);
     void visit(const Shuffle *);
     void visit(const Prefetch *);
+    void visit(const VectorReduce *);
 };
 
 ModulusRemainder modulus_remainder(Expr e) {
@@ -397,6 +398,12 @@ void ComputeModulusRemainder::visit(const Shuffle *op) {
     remainder = 0;
 }
 
+void ComputeModulusRemainder::visit(const VectorReduce *op) {
+    internal_assert(op->type.is_scalar()) << "modulus_remainder of vector\n";
+    modulus = 1;
+    remainder = 0;
+}
+
 void ComputeModulusRemainder::visit(const LetStmt *) {
     internal_assert(false) << "modulus_remainder of statement\n";
 }
@@ -157,7 +157,11 @@ bool Parameter::is_bound_before_lowering() const {
 Expr Parameter::get_scalar_expr() const {
     check_is_scalar();
     const Type t = type();
-    if (t.is_float()) {
+    if (t.is_bfloat()) {
+        switch (t.bits()) {
+        case 16: return Expr(get_scalar<bfloat16_t>());
+        }
+    } else if (t.is_float()) {
         switch (t.bits()) {
         case 32: return Expr(get_scalar<float>());
         case 64: return Expr(get_scalar<double>());
@@ -422,7 +426,8 @@ void check_call_arg_types(const std::string &name, std::vector<Expr> *args, int
         user_assert((*args)[i].defined())
             << "Argument " << i << " to call to \"" << name << "\" is an undefined Expr\n";
         Type t = (*args)[i].type();
-        if (t.is_float() || (t.is_uint() && t.bits() >= 32) || (t.is_int() && t.bits() > 32)) {
+        if (t.is_float() || t.is_bfloat() ||
+            (t.is_uint() && t.bits() >= 32) || (t.is_int() && t.bits() > 32)) {
             user_error << "Implicit cast from " << t << " to int in argument " << (i+1)
                        << " in call to \"" << name << "\" is not allowed. Use an explicit cast.\n";
         }
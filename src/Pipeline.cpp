@@ -161,9 +161,24 @@ string Pipeline::auto_schedule(const Target &target) {
     user_assert(target.arch == Target::X86 || target.arch == Target::ARM ||
                 target.arch == Target::POWERPC || target.arch == Target::MIPS)
         << "Automatic scheduling is currently supported only on these architectures.";
-    // Default machine parameters for generic CPU architecture.
-    MachineParams arch_params(16, 16 * 1024 * 1024, 40);
-    return generate_schedules(contents->outputs, target, arch_params);
+    return generate_schedules(contents->outputs, target, MachineParams::generic());
+}
+
+string Pipeline::auto_schedule_serialized(const Target &target, const MachineParams &arch_params) {
+    user_assert(target.arch == Target::X86 || target.arch == Target::ARM ||
+                target.arch == Target::POWERPC || target.arch == Target::MIPS)
+        << "Automatic scheduling is currently supported only on these architectures.";
+    string serialized;
+    generate_schedules(contents->outputs, target, arch_params, &serialized);
+    return serialized;
+}
+
+string Pipeline::auto_schedule_serialized(const Target &target) {
+    return auto_schedule_serialized(target, MachineParams::generic());
+}
+
+void Pipeline::apply_schedule(const string &serialized) {
+    apply_schedules(contents->outputs, serialized);
 }
 
 Func Pipeline::get_func(size_t index) {
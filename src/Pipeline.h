@@ -86,6 +86,23 @@ public:
     EXPORT std::string auto_schedule(const Target &target);
     //@}
 
+    /** Generate a schedule for the pipeline, like auto_schedule(), but
+     * return it in a machine-readable form with one scheduling directive
+     * per line. This can be saved (e.g. in version control, next to the
+     * generator it belongs to) and applied to the pipeline later with
+     * apply_schedule(), without running the auto-scheduler again. */
+    //@{
+    EXPORT std::string auto_schedule_serialized(const Target &target,
+                                                const MachineParams &arch_params);
+    EXPORT std::string auto_schedule_serialized(const Target &target);
+    //@}
+
+    /** Apply a schedule returned by auto_schedule_serialized(). The Funcs
+     * in the pipeline must not be scheduled already. Funcs and Vars are
+     * referred to by name, so the pipeline must be defined in the same
+     * way as the one the schedule was generated for. */
+    EXPORT void apply_schedule(const std::string &serialized);
+
     /** Return handle to the index-th Func within the pipeline based on the
      * realization order. */
     EXPORT Func get_func(size_t index);
@@ -1,10 +1,12 @@
 #include <algorithm>
+#include <cmath>
 #include <map>
 #include <string>
 
 #include "Prefetch.h"
 #include "Bounds.h"
 #include "ExprUsesVar.h"
+#include "IREquality.h"
 #include "IRMutator.h"
 #include "Scope.h"
 #include "Simplify.h"
@@ -27,6 +29,24 @@ const Definition &get_stage_definition(const Function &f, int stage_num) {
     return f.update(stage_num - 1);
 }
 
+// Get the cache line size to use for prefetches, and the number of cache
+// lines that automatic prefetches should keep in flight to hide the
+// memory latency.
+void get_prefetch_target_info(const Target &t, int &line_bytes, int &lines_in_flight) {
+    if (t.features_any_of({Target::HVX_64, Target::HVX_128})) {
+        line_bytes = 128;
+        lines_in_flight = 8;
+    } else if (t.arch == Target::ARM) {
+        // ARM's cache line size can be 32 or 64 bytes and it can switch the
+        // size at runtime. To be safe, we just use 32 bytes.
+        line_bytes = 32;
+        lines_in_flight = 16;
+    } else {
+        line_bytes = 64;
+        lines_in_flight = 16;
+    }
+}
+
 // Collect the bounds of all the externally referenced buffers in a stmt.
 class CollectExternalBufferBounds : public IRVisitor {
 public:
@@ -62,16 +82,20 @@ public:
 
 class InjectPrefetch : public IRMutator {
 public:
-    InjectPrefetch(const map<string, Function> &e, const map<string, Box> &buffers)
-        : env(e), external_buffers(buffers), current_func(nullptr), stage(-1) { }
+    InjectPrefetch(const map<string, Function> &e, const map<string, Box> &buffers, const Target &t)
+        : env(e), external_buffers(buffers), target(t), current_func(nullptr), stage(-1) { }
 
 private:
     const map<string, Function> &env;
     const map<string, Box> &external_buffers;
+    const Target &target;
     const Function *current_func;
     int stage;
     Scope<Interval> scope;
     Scope<Box> buffer_bounds;
+    // The automatic prefetches that have been inserted in the body of
+    // the current loop, as stage prefix + buffer name.
+    set<string> auto_prefetched;
 
 private:
     using IRMutator::visit;
@@ -145,6 +169,10 @@ private:
         bool fixed = value_bounds.is_single_point();
         value_bounds.min = simplify(value_bounds.min);
         value_bounds.max = fixed ? value_bounds.min : simplify(value_bounds.max);
+        if (!fixed && equal(value_bounds.min, value_bounds.max)) {
+            fixed = true;
+            value_bounds.max = value_bounds.min;
+        }
 
         if (should_substitute_let(value_bounds.min) &&
             (fixed || should_substitute_let(value_bounds.max))) {
@@ -155,8 +183,12 @@ private:
             string max_name = unique_name('t');
             string min_name = unique_name('t');
 
-            scope.push(op->name, Interval(Variable::make(op->value.type(), min_name),
-                                          Variable::make(op->value.type(), max_name)));
+            // If the value is a single point, use the same name for
+            // both bounds, so that the boxes of the prefetches have
+            // the size that they should.
+            Expr min_var = Variable::make(op->value.type(), min_name);
+            Expr max_var = fixed ? min_var : Variable::make(op->value.type(), max_name);
+            scope.push(op->name, Interval(min_var, max_var));
             IRMutator::visit(op);
             scope.pop(op->name);
 
@@ -215,14 +247,117 @@ private:
         return Block::make({prefetch, body});
     }
 
+    // Get the box of a buffer touched by an iteration of a loop.
+    bool box_at_iteration(const string &name, const string &loop_name, Expr at, Stmt body, Box &box) {
+        scope.push(loop_name, Interval(at, at));
+        map<string, Box> boxes_rw = boxes_touched(body, scope);
+        scope.pop(loop_name);
+        const auto &b = boxes_rw.find(name);
+        if (b == boxes_rw.end()) {
+            return false;
+        }
+        box = b->second;
+        return true;
+    }
+
+    int element_bytes(const PrefetchDirective &p) {
+        if (p.param.defined()) {
+            return p.param.type().bytes();
+        }
+        const auto &it = env.find(p.name);
+        internal_assert(it != env.end());
+        int bytes = 0;
+        for (const Type &t : it->second.output_types()) {
+            bytes = std::max(bytes, t.bytes());
+        }
+        return bytes;
+    }
+
+    // Pick the offset for an automatic prefetch in a loop. Returns an
+    // undefined Expr if the prefetch shouldn't go in this loop.
+    Expr auto_prefetch_offset(const PrefetchDirective &p, const For *op, Stmt body) {
+        if ((op->for_type != ForType::Serial && op->for_type != ForType::Parallel) ||
+            (op->device_api != DeviceAPI::None && op->device_api != DeviceAPI::Host &&
+             op->device_api != DeviceAPI::Hexagon)) {
+            return Expr();
+        }
+
+        // Compare the boxes touched by two consecutive iterations.
+        Expr loop_var = Variable::make(Int(32), op->name);
+        Box box, next_box;
+        if (!box_at_iteration(p.name, op->name, loop_var, body, box) ||
+            !box_at_iteration(p.name, op->name, loop_var + 1, body, next_box) ||
+            box.size() != next_box.size() || box.empty()) {
+            return Expr();
+        }
+        vector<int64_t> extents, deltas;
+        bool moves = false;
+        for (size_t i = 0; i < box.size(); i++) {
+            if (!box[i].is_bounded() || !next_box[i].is_bounded()) {
+                return Expr();
+            }
+            // The extents and the distance the box moves can vary, e.g. at
+            // the end of a loop split with ShiftInwards. Use the largest
+            // values they can have, which they have in the steady state.
+            Expr extent = simplify(box[i].max - box[i].min + 1);
+            Expr delta = simplify(next_box[i].min - box[i].min);
+            Expr max_extent = find_constant_bound(extent, Direction::Upper);
+            Expr max_delta = find_constant_bound(delta, Direction::Upper);
+            Expr min_delta = find_constant_bound(delta, Direction::Lower);
+            const int64_t *e = as_const_int(max_extent);
+            const int64_t *d_max = as_const_int(max_delta);
+            const int64_t *d_min = as_const_int(min_delta);
+            if (!e || !d_max || !d_min) {
+                return Expr();
+            }
+            extents.push_back(*e);
+            deltas.push_back(std::max(std::abs(*d_max), std::abs(*d_min)));
+            moves = moves || (deltas.back() != 0);
+        }
+        if (!moves) {
+            // Nothing new is touched on each iteration, so an outer
+            // loop is a better place for the prefetch.
+            return Expr();
+        }
+
+        // Estimate the number of new cache lines touched by each
+        // iteration. This assumes the first dimension is dense, and the
+        // others are not.
+        int line_bytes, lines_in_flight;
+        get_prefetch_target_info(target, line_bytes, lines_in_flight);
+        int bytes = element_bytes(p);
+        double row_bytes = (double)extents[0] * bytes;
+        double lines_per_row = std::max(1.0, row_bytes / line_bytes);
+        double rows = 1, old_rows = 1;
+        for (size_t i = 1; i < extents.size(); i++) {
+            rows *= extents[i];
+            old_rows *= std::max(extents[i] - deltas[i], (int64_t)0);
+        }
+        double new_bytes_per_old_row = (double)std::min(deltas[0], extents[0]) * bytes;
+        double new_lines = ((rows - old_rows) * lines_per_row +
+                            old_rows * new_bytes_per_old_row / line_bytes);
+        internal_assert(new_lines > 0);
+
+        // Prefetch far enough ahead to have lines_in_flight cache lines
+        // requested at any time.
+        int offset = (int)std::ceil(lines_in_flight / new_lines);
+        debug(3) << "Automatic prefetch of " << p.name << " in " << op->name
+                 << " touches " << new_lines << " new cache lines per iteration."
+                 << " Using an offset of " << offset << "\n";
+        return offset;
+    }
+
     void visit(const For *op) {
         const Function *old_func = current_func;
         int old_stage = stage;
 
         const vector<PrefetchDirective> &prefetch_list = get_prefetch_list(op->name);
+        string stage_prefix = current_func->name() + ".s" + std::to_string(stage) + ".";
 
         // Add loop variable to interval scope for any inner loop prefetch
         Expr loop_var = Variable::make(Int(32), op->name);
+        set<string> outer_auto_prefetched;
+        outer_auto_prefetched.swap(auto_prefetched);
         scope.push(op->name, Interval(loop_var, loop_var));
         Stmt body = mutate(op->body);
         scope.pop(op->name);
@@ -233,29 +368,42 @@ private:
             set<string> seen;
             for (int i = prefetch_list.size() - 1; i >= 0; --i) {
                 const PrefetchDirective &p = prefetch_list[i];
-                if (!ends_with(op->name, "." + p.var) || (seen.find(p.name) != seen.end())) {
+                if (seen.find(p.name) != seen.end()) {
+                    continue;
+                }
+
+                Expr offset;
+                if (p.var.empty()) {
+                    // Automatic prefetches go in the innermost loop that
+                    // they can.
+                    if (auto_prefetched.count(stage_prefix + p.name)) {
+                        continue;
+                    }
+                    offset = auto_prefetch_offset(p, op, body);
+                    if (!offset.defined()) {
+                        continue;
+                    }
+                    auto_prefetched.insert(stage_prefix + p.name);
+                } else if (ends_with(op->name, "." + p.var)) {
+                    offset = p.offset;
+                } else {
                     continue;
                 }
                 seen.insert(p.name);
 
                 // Add loop variable + prefetch offset to interval scope for box computation
-                Expr fetch_at = loop_var + p.offset;
-                scope.push(op->name, Interval(fetch_at, fetch_at));
-                map<string, Box> boxes_rw = boxes_touched(body, scope);
-                scope.pop(op->name);
-
-                // TODO(psuriana): Only prefetch the newly accessed data. We
-                // should subtract the box accessed during previous iteration
-                // from the one accessed during this iteration.
-
-                // TODO(psuriana): Add a new PrefetchBoundStrategy::ShiftInwards
-                // that shifts the base address of the prefetched box so that
-                // the box is completely within the bounds.
-                const auto &b = boxes_rw.find(p.name);
-                if (b != boxes_rw.end()) {
-                    Box prefetch_box = b->second;
+                Box prefetch_box;
+                if (box_at_iteration(p.name, op->name, loop_var + offset, body, prefetch_box)) {
+                    // TODO(psuriana): Only prefetch the newly accessed data. We
+                    // should subtract the box accessed during previous iteration
+                    // from the one accessed during this iteration.
+
+                    // TODO(psuriana): Add a new PrefetchBoundStrategy::ShiftInwards
+                    // that shifts the base address of the prefetched box so that
+                    // the box is completely within the bounds.
+
                     // Only prefetch the region that is in bounds.
-                    Box bounds = get_buffer_bounds(b->first, b->second.size());
+                    Box bounds = get_buffer_bounds(p.name, prefetch_box.size());
                     internal_assert(prefetch_box.size() == bounds.size());
 
                     if (p.strategy == PrefetchBoundStrategy::Clamp) {
@@ -272,11 +420,15 @@ private:
                         // Assume the prefetch won't fault when accessing region
                         // outside the bounds.
                     }
-                    body = add_prefetch(b->first, p.param, prefetch_box, body);
+                    body = add_prefetch(p.name, p.param, prefetch_box, body);
                 }
             }
         }
 
+        // Let the outer loops know about the automatic prefetches in
+        // this one.
+        auto_prefetched.insert(outer_auto_prefetched.begin(), outer_auto_prefetched.end());
+
         if (!body.same_as(op->body)) {
             stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
         } else {
@@ -404,10 +556,10 @@ public:
 
 } // anonymous namespace
 
-Stmt inject_prefetch(Stmt s, const map<string, Function> &env) {
+Stmt inject_prefetch(Stmt s, const map<string, Function> &env, const Target &t) {
     CollectExternalBufferBounds finder;
     s.accept(&finder);
-    return InjectPrefetch(env, finder.buffers).mutate(s);
+    return InjectPrefetch(env, finder.buffers, t).mutate(s);
 }
 
 Stmt reduce_prefetch_dimension(Stmt stmt, const Target &t) {
@@ -418,14 +570,11 @@ Stmt reduce_prefetch_dimension(Stmt stmt, const Target &t) {
     // two dimension. Other architectures generate one prefetch per cache line.
     if (t.features_any_of({Target::HVX_64, Target::HVX_128})) {
         max_dim = 2;
-    } else if (t.arch == Target::ARM) {
-        // ARM's cache line size can be 32 or 64 bytes and it can switch the
-        // size at runtime. To be safe, we just use 32 bytes.
-        max_dim = 1;
-        max_byte_size = 32;
     } else {
+        int line_bytes, lines_in_flight;
+        get_prefetch_target_info(t, line_bytes, lines_in_flight);
         max_dim = 1;
-        max_byte_size = 64;
+        max_byte_size = line_bytes;
     }
     internal_assert(max_dim > 0);
 
@@ -14,7 +14,10 @@
 namespace Halide {
 namespace Internal {
 
-Stmt inject_prefetch(Stmt s, const std::map<std::string, Function> &env);
+/** Inject the prefetches in the schedules of the functions in the
+ * environment. Prefetches without a loop level are placed automatically,
+ * with an offset that depends on the target's cache line size. */
+Stmt inject_prefetch(Stmt s, const std::map<std::string, Function> &env, const Target &t);
 
 /** Reduce a multi-dimensional prefetch into a prefetch of lower dimension
  * (max dimension of the prefetch is specified by target architecture).
@@ -0,0 +1,254 @@
+#include <set>
+
+#include "PromoteRegisterStorage.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Simplify.h"
+#include "Substitute.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::pair;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+// A mutator that keeps track of the lets that are in scope.
+class TrackLets : public IRMutator {
+protected:
+    using IRMutator::visit;
+
+    vector<pair<string, Expr>> lets;
+
+    void visit(const Let *op) {
+        Expr value = mutate(op->value);
+        lets.push_back({op->name, value});
+        Expr body = mutate(op->body);
+        lets.pop_back();
+        if (value.same_as(op->value) && body.same_as(op->body)) {
+            expr = op;
+        } else {
+            expr = Let::make(op->name, value, body);
+        }
+    }
+
+    void visit(const LetStmt *op) {
+        Expr value = mutate(op->value);
+        lets.push_back({op->name, value});
+        Stmt body = mutate(op->body);
+        lets.pop_back();
+        if (value.same_as(op->value) && body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = LetStmt::make(op->name, value, body);
+        }
+    }
+};
+
+// Replace the loads and stores to one allocation with loads and stores
+// to a separate allocation per slot, where a slot is a scalar or
+// vector at a constant index. The first pass over the body finds the
+// slots, and the second one does the replacement.
+class PromoteAllocation : public TrackLets {
+    using TrackLets::visit;
+
+    const string &name;
+
+    // Get the constant index and width of an access.
+    pair<int, int> get_slot(Expr index) {
+        for (auto it = lets.rbegin(); it != lets.rend(); it++) {
+            index = Let::make(it->first, it->second, index);
+        }
+        index = simplify(substitute_in_all_lets(index));
+
+        if (const int64_t *i = as_const_int(index)) {
+            return {(int)*i, 1};
+        } else if (const Ramp *r = index.as<Ramp>()) {
+            const int64_t *base = as_const_int(r->base);
+            if (base && is_one(r->stride)) {
+                return {(int)*base, r->lanes};
+            }
+        }
+        user_error
+            << "The storage for " << name << " can't be promoted to registers, "
+            << "because it is accessed at the non-constant index " << index << ". "
+            << "All loops over its storage must be unrolled or vectorized.\n";
+        return {0, 0};
+    }
+
+    void add_slot(pair<int, int> pos) {
+        auto it = slots.find(pos.first);
+        user_assert(it == slots.end() || it->second == pos.second)
+            << "The storage for " << name << " can't be promoted to registers, "
+            << "because it is accessed at index " << pos.first
+            << " with both " << it->second << " and " << pos.second << " lanes.\n";
+        slots[pos.first] = pos.second;
+    }
+
+    Expr slot_index(int lanes) {
+        if (lanes == 1) {
+            return 0;
+        } else {
+            return Ramp::make(0, 1, lanes);
+        }
+    }
+
+    void visit(const Load *op) {
+        if (op->name != name) {
+            TrackLets::visit(op);
+            return;
+        }
+        pair<int, int> pos = get_slot(op->index);
+        if (replace) {
+            // The whole slot is always allocated, so it's safe to
+            // ignore the predicate.
+            expr = Load::make(op->type, slot_name(pos.first), slot_index(pos.second),
+                              Buffer<>(), Parameter(), const_true(pos.second));
+        } else {
+            add_slot(pos);
+            expr = op;
+        }
+    }
+
+    void visit(const Store *op) {
+        if (op->name != name) {
+            TrackLets::visit(op);
+            return;
+        }
+        pair<int, int> pos = get_slot(op->index);
+        Expr value = mutate(op->value);
+        if (replace) {
+            string slot = slot_name(pos.first);
+            Expr index = slot_index(pos.second);
+            if (!is_one(op->predicate)) {
+                // Keep the old value in the lanes that are masked off.
+                Expr old_value = Load::make(value.type(), slot, index, Buffer<>(),
+                                            Parameter(), const_true(pos.second));
+                value = select(mutate(op->predicate), value, old_value);
+            }
+            stmt = Store::make(slot, value, index, Parameter(), const_true(pos.second));
+        } else {
+            add_slot(pos);
+            stmt = op;
+        }
+    }
+
+    void visit(const Variable *op) {
+        user_assert(op->name != name)
+            << "The storage for " << name << " can't be promoted to registers, "
+            << "because its address is used.\n";
+        expr = op;
+    }
+
+    void visit(const Free *op) {
+        internal_assert(op->name != name)
+            << "promote_register_storage must be called before injecting frees\n";
+        stmt = op;
+    }
+
+public:
+    // The slots that are accessed, from index to number of lanes.
+    map<int, int> slots;
+    bool replace = false;
+
+    string slot_name(int index) const {
+        return name + ".reg" + std::to_string(index);
+    }
+
+    PromoteAllocation(const string &n, const vector<pair<string, Expr>> &outer_lets) : name(n) {
+        lets = outer_lets;
+    }
+};
+
+class PromoteRegisterStorage : public TrackLets {
+    using TrackLets::visit;
+
+    const set<string> &names;
+
+    void visit(const Allocate *op) {
+        if (!names.count(op->name)) {
+            TrackLets::visit(op);
+            return;
+        }
+
+        user_assert(!op->new_expr.defined() &&
+                    op->constant_allocation_size() > 0)
+            << "The storage for " << op->name << " can't be promoted to registers, "
+            << "because its size is not a compile-time constant. "
+            << "Use bound or bound_extent to give it a constant size.\n";
+
+        Stmt body = mutate(op->body);
+
+        PromoteAllocation promote(op->name, lets);
+        promote.mutate(body);
+        promote.replace = true;
+        body = promote.mutate(body);
+
+        int size = op->constant_allocation_size();
+        int end = 0;
+        for (const auto &slot : promote.slots) {
+            int index = slot.first, lanes = slot.second;
+            user_assert(index >= 0 && index + lanes <= size)
+                << "The storage for " << op->name << " can't be promoted to registers, "
+                << "because it is accessed at index " << index
+                << ", which is outside of its allocation.\n";
+            user_assert(index >= end)
+                << "The storage for " << op->name << " can't be promoted to registers, "
+                << "because it is accessed with overlapping vectors at index " << index << ".\n";
+            end = index + lanes;
+        }
+
+        for (const auto &slot : promote.slots) {
+            vector<Expr> extents;
+            if (slot.second > 1) {
+                extents.push_back(slot.second);
+            }
+            body = Allocate::make(promote.slot_name(slot.first), op->type, extents,
+                                  op->condition, body);
+        }
+        promoted.insert(op->name);
+        stmt = body;
+    }
+
+public:
+    set<string> promoted;
+    PromoteRegisterStorage(const set<string> &n) : names(n) {}
+};
+
+}
+
+Stmt promote_register_storage(Stmt s, const map<string, Function> &env) {
+    set<string> names;
+    for (const auto &p : env) {
+        const Function &f = p.second;
+        if (!f.schedule().store_in_registers()) {
+            continue;
+        }
+        if (f.outputs() == 1) {
+            names.insert(f.name());
+        } else {
+            for (int i = 0; i < f.outputs(); i++) {
+                names.insert(f.name() + "." + std::to_string(i));
+            }
+        }
+    }
+    if (names.empty()) {
+        return s;
+    }
+    PromoteRegisterStorage promote(names);
+    s = promote.mutate(s);
+    for (const string &n : names) {
+        user_assert(promote.promoted.count(n))
+            << "The storage for " << n << " can't be promoted to registers, "
+            << "because it isn't allocated inside the pipeline. "
+            << "Outputs and inputs can't be stored in registers.\n";
+    }
+    return s;
+}
+
+}
+}
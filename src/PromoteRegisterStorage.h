@@ -0,0 +1,26 @@
+#ifndef HALIDE_PROMOTE_REGISTER_STORAGE_H
+#define HALIDE_PROMOTE_REGISTER_STORAGE_H
+
+/** \file
+ * Defines the lowering pass that promotes the storage of functions
+ * scheduled with store_in_registers to registers.
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Replace the allocations of functions scheduled with
+ * Func::store_in_registers with one allocation per scalar or vector
+ * that is accessed. Every load and store to such an allocation must be
+ * at a constant index, so this must be called after loops have been
+ * unrolled and vectorized. */
+Stmt promote_register_storage(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
@@ -212,6 +212,11 @@ class ExprCost : public IRVisitor {
         cost.arith += 1;
     }
 
+    void visit(const VectorReduce *op) {
+        op->value.accept(this);
+        cost.arith += op->value.type().lanes() / op->type.lanes() - 1;
+    }
+
     void visit(const Let *let) {
         let->value.accept(this);
         let->body.accept(this);
@@ -256,6 +261,51 @@ Expr get_func_value_size(const Function &f) {
     return simplify(size);
 }
 
+// There is no visibility into an extern stage, so assume that it loads one
+// value of each of its function and buffer inputs per value it computes (as
+// the dependence analysis does for inputs without declared footprints).
+// Return the number of bytes loaded from each input, and stored to the
+// stage itself, per value computed.
+map<string, int64_t> extern_stage_byte_loads(const Function &f) {
+    internal_assert(f.has_extern_definition());
+    map<string, int64_t> loads;
+    for (const ExternFuncArgument &arg : f.extern_arguments()) {
+        if (arg.is_func()) {
+            Function prod(arg.func);
+            for (const Type &t : prod.output_types()) {
+                loads[prod.name()] += t.bytes();
+            }
+        } else if (arg.is_buffer()) {
+            loads[arg.buffer.name()] += arg.buffer.type().bytes();
+        } else if (arg.is_image_param()) {
+            loads[arg.image_param.name()] += arg.image_param.type().bytes();
+        }
+    }
+    for (const Type &t : f.output_types()) {
+        loads[f.name()] += t.bytes();
+    }
+    return loads;
+}
+
+// Return the region iterated over by a stage of 'f', given the bounds of
+// its dimensions. Extern stages have no loop dimensions; they compute the
+// region of their pure args.
+Box get_stage_region(const Function &f, int stage, const DimBounds &bounds) {
+    Box stage_region;
+    if (f.has_extern_definition()) {
+        for (const string &arg : f.args()) {
+            stage_region.push_back(get_element(bounds, arg));
+        }
+        return stage_region;
+    }
+    Definition def = get_stage_definition(f, stage);
+    const vector<Dim> &dims = def.schedule().dims();
+    for (int d = 0; d < (int)dims.size() - 1; d++) {
+        stage_region.push_back(get_element(bounds, dims[d].var));
+    }
+    return stage_region;
+}
+
 // Helper class that only accounts for the likely portion of the expression in
 // the case of max, min, and select. This will help costing functions with
 // boundary conditions better. The likely intrinsic triggers loop partitioning
@@ -338,20 +388,22 @@ RegionCosts::RegionCosts(const map<string, Function> &_env) : env(_env) {
         for (const auto &iter : find.input_estimates) {
             input_estimates.push(iter.first, iter.second);
         }
+
+        // Buffers may also be passed directly to extern stages.
+        for (const ExternFuncArgument &arg : kv.second.extern_arguments()) {
+            if (arg.is_buffer()) {
+                inputs[arg.buffer.name()] = arg.buffer.type();
+            } else if (arg.is_image_param()) {
+                inputs[arg.image_param.name()] = arg.image_param.type();
+            }
+        }
     }
 }
 
 Cost RegionCosts::stage_region_cost(string func, int stage, const DimBounds &bounds,
                                     const set<string> &inlines) {
     Function curr_f = get_element(env, func);
-    Definition def = get_stage_definition(curr_f, stage);
-
-    Box stage_region;
-
-    const vector<Dim> &dims = def.schedule().dims();
-    for (int d = 0; d < (int)dims.size() - 1; d++) {
-        stage_region.push_back(get_element(bounds, dims[d].var));
-    }
+    Box stage_region = get_stage_region(curr_f, stage, bounds);
 
     Expr size = box_size(stage_region);
     if (!size.defined()) {
@@ -433,6 +485,13 @@ RegionCosts::stage_detailed_load_costs(string func, int stage,
                                        const set<string> &inlines) {
     map<string, Expr> load_costs;
     Function curr_f = get_element(env, func);
+    if (curr_f.has_extern_definition()) {
+        for (const auto &iter : extern_stage_byte_loads(curr_f)) {
+            load_costs.emplace(iter.first, make_const(Int(64), iter.second));
+        }
+        return load_costs;
+    }
+
     Definition def = get_stage_definition(curr_f, stage);
 
     for (const auto &e : def.values()) {
@@ -459,14 +518,7 @@ RegionCosts::stage_detailed_load_costs(string func, int stage,
                                        DimBounds &bounds,
                                        const set<string> &inlines) {
     Function curr_f = get_element(env, func);
-    Definition def = get_stage_definition(curr_f, stage);
-
-    Box stage_region;
-
-    const vector<Dim> &dims = def.schedule().dims();
-    for (int d = 0; d < (int)dims.size() - 1; d++) {
-        stage_region.push_back(get_element(bounds, dims[d].var));
-    }
+    Box stage_region = get_stage_region(curr_f, stage, bounds);
 
     map<string, Expr> load_costs = stage_detailed_load_costs(func, stage, inlines);
 
@@ -504,14 +556,7 @@ RegionCosts::detailed_load_costs(string func, const Box &region,
     for (int s = 0; s < num_stages; s++) {
         map<string, Expr> stage_load_costs = stage_detailed_load_costs(func, s, inlines);
 
-        Definition def = get_stage_definition(curr_f, s);
-
-        Box stage_region;
-
-        const vector<Dim> &dims = def.schedule().dims();
-        for (int d = 0; d < (int)dims.size() - 1; d++) {
-            stage_region.push_back(get_element(stage_bounds[s], dims[d].var));
-        }
+        Box stage_region = get_stage_region(curr_f, s, stage_bounds[s]);
 
         Expr size = box_size(stage_region);
         for (auto &kv : stage_load_costs) {
@@ -551,7 +596,13 @@ RegionCosts::detailed_load_costs(const map<string, Box> &regions,
 
 Cost RegionCosts::get_func_stage_cost(const Function &f, int stage, const set<string> &inlines) {
     if (f.has_extern_definition()) {
-        return Cost();
+        // Count a single operation per value computed by the extern stage,
+        // and the bytes it is assumed to load and store.
+        int64_t bytes = 0;
+        for (const auto &iter : extern_stage_byte_loads(f)) {
+            bytes += iter.second;
+        }
+        return Cost(1, bytes);
     }
 
     Definition def = get_stage_definition(f, stage);
@@ -589,10 +640,6 @@ Cost RegionCosts::get_func_stage_cost(const Function &f, int stage, const set<st
 }
 
 vector<Cost> RegionCosts::get_func_cost(const Function &f, const set<string> &inlines) {
-    if (f.has_extern_definition()) {
-        return { Cost() };
-    }
-
     vector<Cost> func_costs;
     size_t num_stages = f.updates().size() + 1;
     for (size_t s = 0; s < num_stages; s++) {
@@ -75,7 +75,9 @@ struct RegionCosts {
                      const std::set<std::string> &inlines = std::set<std::string>());
 
     /** Compute the cost of producing a single value by one stage of 'f'.
-     * 'inlines' specifies names of all the inlined functions. */
+     * 'inlines' specifies names of all the inlined functions. An extern
+     * stage is assumed to do one operation and to load one value of each
+     * of its inputs per value it produces. */
     Cost get_func_stage_cost(const Function &f, int stage,
                              const std::set<std::string> &inlines = std::set<std::string>());
 
@@ -126,10 +126,12 @@ struct FuncScheduleContents {
     std::vector<Bound> estimates;
     std::map<std::string, Internal::FunctionPtr> wrappers;
     bool memoized;
+    bool store_in_registers;
+    bool store_nontemporal;
 
     FuncScheduleContents() :
         store_level(LoopLevel::inlined()), compute_level(LoopLevel::inlined()),
-        memoized(false) {};
+        memoized(false), store_in_registers(false), store_nontemporal(false) {};
 
     // Pass an IRMutator through to all Exprs referenced in the FuncScheduleContents
     void mutate(IRMutator *mutator) {
@@ -236,6 +238,8 @@ FuncSchedule FuncSchedule::deep_copy(
     copy.contents->bounds = contents->bounds;
     copy.contents->estimates = contents->estimates;
     copy.contents->memoized = contents->memoized;
+    copy.contents->store_in_registers = contents->store_in_registers;
+    copy.contents->store_nontemporal = contents->store_nontemporal;
 
     // Deep-copy wrapper functions.
     for (const auto &iter : contents->wrappers) {
@@ -255,6 +259,22 @@ bool FuncSchedule::memoized() const {
     return contents->memoized;
 }
 
+bool &FuncSchedule::store_in_registers() {
+    return contents->store_in_registers;
+}
+
+bool FuncSchedule::store_in_registers() const {
+    return contents->store_in_registers;
+}
+
+bool &FuncSchedule::store_nontemporal() {
+    return contents->store_nontemporal;
+}
+
+bool FuncSchedule::store_nontemporal() const {
+    return contents->store_nontemporal;
+}
+
 std::vector<StorageDim> &FuncSchedule::storage_dims() {
     return contents->storage_dims;
 }
@@ -227,6 +227,8 @@ struct StorageDim {
 
 struct PrefetchDirective {
     std::string name;
+    // If var is empty, the loop and the offset are picked
+    // automatically, and the offset is undefined.
     std::string var;
     Expr offset;
     PrefetchBoundStrategy strategy;
@@ -267,6 +269,20 @@ public:
     bool memoized() const;
     // @}
 
+    /** This flag is set to true if the function's storage should be
+     * promoted to registers. See \ref Func::store_in_registers */
+    // @{
+    bool &store_in_registers();
+    bool store_in_registers() const;
+    // @}
+
+    /** This flag is set to true if the function's dense vector stores
+     * should be non-temporal. See \ref Func::store_nontemporal */
+    // @{
+    bool &store_nontemporal();
+    bool store_nontemporal() const;
+    // @}
+
     /** The list and order of dimensions used to store this
      * function. The first dimension in the vector corresponds to the
      * innermost dimension for storage (i.e. which dimension is
@@ -9,6 +9,7 @@
 #include "IREquality.h"
 #include "IRPrinter.h"
 #include "IRMutator.h"
+#include "IRMatch.h"
 #include "Scope.h"
 #include "Var.h"
 #include "Debug.h"
@@ -86,7 +87,7 @@ bool no_overflow_scalar_int(Type t) {
 
 // Returns true iff t does not have a well defined overflow behavior.
 bool no_overflow(Type t) {
-    return t.is_float() || no_overflow_scalar_int(t.element_of());
+    return t.is_float() || t.is_bfloat() || no_overflow_scalar_int(t.element_of());
 }
 
 // Make a poison value used when overflow is detected during constant
@@ -454,7 +455,7 @@ private:
                    const_float(value, &f)) {
             // float -> uint
             expr = UIntImm::make(op->type, (uint64_t)f);
-        } else if (op->type.is_float() &&
+        } else if ((op->type.is_float() || op->type.is_bfloat()) &&
                    const_float(value, &f)) {
             // float -> float
             expr = FloatImm::make(op->type, f);
@@ -466,7 +467,7 @@ private:
                    const_int(value, &i)) {
             // int -> uint
             expr = UIntImm::make(op->type, (uint64_t)i);
-        } else if (op->type.is_float() &&
+        } else if ((op->type.is_float() || op->type.is_bfloat()) &&
                    const_int(value, &i)) {
             // int -> float
             expr = FloatImm::make(op->type, (double)i);
@@ -478,7 +479,7 @@ private:
                    const_uint(value, &u)) {
             // uint -> uint
             expr = UIntImm::make(op->type, u);
-        } else if (op->type.is_float() &&
+        } else if ((op->type.is_float() || op->type.is_bfloat()) &&
                    const_uint(value, &u)) {
             // uint -> float
             expr = FloatImm::make(op->type, (double)u);
@@ -1820,7 +1821,7 @@ private:
             mod_rem = modulus_remainder(ramp_a->base, alignment_info);
         }
 
-        if (is_zero(b) && !op->type.is_float()) {
+        if (is_zero(b) && !op->type.is_float() && !op->type.is_bfloat()) {
             expr = indeterminate_expression_error(op->type);
         } else if (is_zero(a)) {
             expr = a;
@@ -2203,7 +2204,7 @@ private:
             mod_rem = modulus_remainder(ramp_a->base, alignment_info);
         }
 
-        if (is_zero(b) && !op->type.is_float()) {
+        if (is_zero(b) && !op->type.is_float() && !op->type.is_bfloat()) {
             expr = indeterminate_expression_error(op->type);
         } else if (is_zero(a)) {
             expr = a;
@@ -2330,10 +2331,6 @@ private:
         const Sub *sub_a = a.as<Sub>();
         const Sub *sub_b = b.as<Sub>();
         const Min *min_a = a.as<Min>();
-        const Min *min_b = b.as<Min>();
-        const Min *min_a_a = min_a ? min_a->a.as<Min>() : nullptr;
-        const Min *min_a_a_a = min_a_a ? min_a_a->a.as<Min>() : nullptr;
-        const Min *min_a_a_a_a = min_a_a_a ? min_a_a_a->a.as<Min>() : nullptr;
         const Max *max_a = a.as<Max>();
         const Max *max_b = b.as<Max>();
         const Call *call_a = a.as<Call>();
@@ -2344,13 +2341,20 @@ private:
         const Select *select_b = b.as<Select>();
         const Broadcast *broadcast_a_b = min_a ? min_a->b.as<Broadcast>() : nullptr;
 
-        min_a_a = max_a ? max_a->a.as<Min>() : min_a_a;
-
         // Detect if the lhs or rhs is a rounding-up operation
         int64_t a_round_up_factor = 0, b_round_up_factor = 0;
         Expr a_round_up = is_round_up(a, &a_round_up_factor);
         Expr b_round_up = is_round_up(b, &b_round_up_factor);
 
+        // Rules that can be expressed as pure pattern rewrites.
+        using namespace IRMatcher;
+        Wild<0> x;
+        Wild<1> y;
+        Wild<2> z;
+        Wild<3> w;
+        Wild<4> u;
+        auto rewrite = rewriter<Min>(a, b, op->type);
+
         int64_t ramp_min, ramp_max;
 
         if (equal(a, b)) {
@@ -2482,102 +2486,37 @@ private:
                    is_const(max_a->b, b_round_up_factor)) {
             // min(max(a, 4), ((a + 3)/4)*4) -> max(a, 4)
             expr = a;
-        } else if (max_a &&
-                   min_b &&
-                   equal(max_a->a, min_b->a) &&
-                   equal(max_a->b, min_b->b)) {
-            // min(max(x, y), min(x, y)) -> min(x, y)
-            expr = mutate(min(max_a->a, max_a->b));
-        } else if (max_a &&
-                   min_b &&
-                   equal(max_a->a, min_b->b) &&
-                   equal(max_a->b, min_b->a)) {
-            // min(max(x, y), min(y, x)) -> min(x, y)
-            expr = mutate(min(max_a->a, max_a->b));
-        } else if (max_a &&
-                   (equal(max_a->a, b) || equal(max_a->b, b))) {
-            // min(max(x, y), x) -> x
-            // min(max(x, y), y) -> y
-            expr = b;
-        } else if (min_a &&
-                   (equal(min_a->b, b) || equal(min_a->a, b))) {
-            // min(min(x, y), y) -> min(x, y)
-            expr = a;
-        } else if (min_b &&
-                   (equal(min_b->b, a) || equal(min_b->a, a))) {
-            // min(y, min(x, y)) -> min(x, y)
-            expr = b;
+        } else if (rewrite(min(max(x, y), min(x, y)), min(x, y)) ||
+                   rewrite(min(max(x, y), min(y, x)), min(x, y))) {
+            expr = mutate(rewrite.result);
+        } else if (rewrite(min(max(x, y), x), b) ||
+                   rewrite(min(max(x, y), y), b) ||
+                   rewrite(min(min(x, y), y), a) ||
+                   rewrite(min(min(x, y), x), a) ||
+                   rewrite(min(y, min(x, y)), b) ||
+                   rewrite(min(x, min(x, y)), b)) {
+            expr = rewrite.result;
         } else if (min_a &&
                    broadcast_a_b &&
                    broadcast_b ) {
             // min(min(x, broadcast(y, n)), broadcast(z, n))) -> min(x, broadcast(min(y, z), n))
             expr = mutate(Min::make(min_a->a, Broadcast::make(Min::make(broadcast_a_b->value, broadcast_b->value), broadcast_b->lanes)));
-        } else if (min_a &&
-                   min_a_a &&
-                   equal(min_a_a->b, b)) {
-            // min(min(min(x, y), z), y) -> min(min(x, y), z)
-            expr = a;
-        } else if (min_a &&
-                   min_a_a_a &&
-                   equal(min_a_a_a->b, b)) {
-            // min(min(min(min(x, y), z), w), y) -> min(min(min(x, y), z), w)
-            expr = a;
-        } else if (min_a &&
-                   min_a_a_a_a &&
-                   equal(min_a_a_a_a->b, b)) {
-            // min(min(min(min(min(x, y), z), w), l), y) -> min(min(min(min(x, y), z), w), l)
-            expr = a;
-        } else if (max_a &&
-                   max_b &&
-                   equal(max_a->a, max_b->a)) {
-            // Distributive law for min/max
-            // min(max(x, y), max(x, z)) -> max(min(y, z), x)
-            expr = mutate(Max::make(Min::make(max_a->b, max_b->b), max_a->a));
-        } else if (max_a &&
-                   max_b &&
-                   equal(max_a->a, max_b->b)) {
-            // min(max(x, y), max(z, x)) -> max(min(y, z), x)
-            expr = mutate(Max::make(Min::make(max_a->b, max_b->a), max_a->a));
-        } else if (max_a &&
-                   max_b &&
-                   equal(max_a->b, max_b->a)) {
-            // min(max(y, x), max(x, z)) -> max(min(y, z), x)
-            expr = mutate(Max::make(Min::make(max_a->a, max_b->b), max_a->b));
-        } else if (max_a &&
-                   max_b &&
-                   equal(max_a->b, max_b->b)) {
-            // min(max(y, x), max(z, x)) -> max(min(y, z), x)
-            expr = mutate(Max::make(Min::make(max_a->a, max_b->a), max_a->b));
-        } else if (min_a &&
-                   min_b &&
-                   equal(min_a->a, min_b->a)) {
-            // min(min(x, y), min(x, z)) -> min(min(y, z), x)
-            expr = mutate(Min::make(Min::make(min_a->b, min_b->b), min_a->a));
-        } else if (min_a &&
-                   min_b &&
-                   equal(min_a->a, min_b->b)) {
-            // min(min(x, y), min(z, x)) -> min(min(y, z), x)
-            expr = mutate(Min::make(Min::make(min_a->b, min_b->a), min_a->a));
-        } else if (min_a &&
-                   min_b &&
-                   equal(min_a->b, min_b->a)) {
-            // min(min(y, x), min(x, z)) -> min(min(y, z), x)
-            expr = mutate(Min::make(Min::make(min_a->a, min_b->b), min_a->b));
-        } else if (min_a &&
-                   min_b &&
-                   equal(min_a->b, min_b->b)) {
-            // min(min(y, x), min(z, x)) -> min(min(y, z), x)
-            expr = mutate(Min::make(Min::make(min_a->a, min_b->a), min_a->b));
-        } else if (max_a &&
-                   min_a_a &&
-                   equal(min_a_a->b, b)) {
-            // min(max(min(x, y), z), y) -> min(max(x, z), y)
-            expr = mutate(min(max(min_a_a->a, max_a->b), b));
-        } else if (max_a &&
-                   min_a_a &&
-                   equal(min_a_a->a, b)) {
-            // min(max(min(y, x), z), y) -> min(max(x, z), y)
-            expr = mutate(min(max(min_a_a->b, max_a->b), b));
+        } else if (rewrite(min(min(min(x, y), z), y), a) ||
+                   rewrite(min(min(min(min(x, y), z), w), y), a) ||
+                   rewrite(min(min(min(min(min(x, y), z), w), u), y), a)) {
+            expr = rewrite.result;
+        } else if (// Distributive law for min/max
+                   rewrite(min(max(x, y), max(x, z)), max(min(y, z), x)) ||
+                   rewrite(min(max(x, y), max(z, x)), max(min(y, z), x)) ||
+                   rewrite(min(max(y, x), max(x, z)), max(min(y, z), x)) ||
+                   rewrite(min(max(y, x), max(z, x)), max(min(y, z), x)) ||
+                   rewrite(min(min(x, y), min(x, z)), min(min(y, z), x)) ||
+                   rewrite(min(min(x, y), min(z, x)), min(min(y, z), x)) ||
+                   rewrite(min(min(y, x), min(x, z)), min(min(y, z), x)) ||
+                   rewrite(min(min(y, x), min(z, x)), min(min(y, z), x)) ||
+                   rewrite(min(max(min(x, y), z), y), min(max(x, z), y)) ||
+                   rewrite(min(max(min(y, x), z), y), min(max(x, z), y))) {
+            expr = mutate(rewrite.result);
         } else if (no_overflow(op->type) &&
                    add_a &&
                    add_b &&
@@ -2772,12 +2711,6 @@ private:
         const Sub *sub_a = a.as<Sub>();
         const Sub *sub_b = b.as<Sub>();
         const Max *max_a = a.as<Max>();
-        const Max *max_b = b.as<Max>();
-        const Max *max_a_a = max_a ? max_a->a.as<Max>() : nullptr;
-        const Max *max_a_a_a = max_a_a ? max_a_a->a.as<Max>() : nullptr;
-        const Max *max_a_a_a_a = max_a_a_a ? max_a_a_a->a.as<Max>() : nullptr;
-        const Min *min_a = a.as<Min>();
-        const Min *min_b = b.as<Min>();
         const Call *call_a = a.as<Call>();
         const Call *call_b = b.as<Call>();
         const Shuffle *shuffle_a = a.as<Shuffle>();
@@ -2786,7 +2719,14 @@ private:
         const Select *select_b = b.as<Select>();
         const Broadcast *broadcast_a_b = max_a ? max_a->b.as<Broadcast>() : nullptr;
 
-        max_a_a = min_a ? min_a->a.as<Max>() : max_a_a;
+        // Rules that can be expressed as pure pattern rewrites.
+        using namespace IRMatcher;
+        Wild<0> x;
+        Wild<1> y;
+        Wild<2> z;
+        Wild<3> w;
+        Wild<4> u;
+        auto rewrite = rewriter<Max>(a, b, op->type);
 
         int64_t ramp_min, ramp_max;
 
@@ -2899,100 +2839,37 @@ private:
             } else {
                 expr = b;
             }
-        } else if (min_a &&
-                   max_b &&
-                   equal(min_a->a, max_b->a) &&
-                   equal(min_a->b, max_b->b)) {
-            // max(min(x, y), max(x, y)) -> max(x, y)
-            expr = mutate(max(min_a->a, min_a->b));
-        } else if (min_a &&
-                   max_b &&
-                   equal(min_a->a, max_b->b) &&
-                   equal(min_a->b, max_b->a)) {
-            // max(min(x, y), max(y, x)) -> max(x, y)
-            expr = mutate(max(min_a->a, min_a->b));
-        } else if (min_a &&
-                   (equal(min_a->a, b) || equal(min_a->b, b))) {
-            // max(min(x, y), x) -> x
-            // max(min(x, y), y) -> y
-            expr = b;
-        } else if (max_a &&
-                   (equal(max_a->b, b) || equal(max_a->a, b))) {
-            // max(max(x, y), y) -> max(x, y)
-            expr = a;
-        } else if (max_b &&
-                   (equal(max_b->b, a) || equal(max_b->a, a))) {
-            // max(y, max(x, y)) -> max(x, y)
-            expr = b;
+        } else if (rewrite(max(min(x, y), max(x, y)), max(x, y)) ||
+                   rewrite(max(min(x, y), max(y, x)), max(x, y))) {
+            expr = mutate(rewrite.result);
+        } else if (rewrite(max(min(x, y), x), b) ||
+                   rewrite(max(min(x, y), y), b) ||
+                   rewrite(max(max(x, y), y), a) ||
+                   rewrite(max(max(x, y), x), a) ||
+                   rewrite(max(y, max(x, y)), b) ||
+                   rewrite(max(x, max(x, y)), b)) {
+            expr = rewrite.result;
         } else if (max_a &&
                    broadcast_a_b &&
                    broadcast_b ) {
             // max(max(x, broadcast(y, n)), broadcast(z, n))) -> max(x, broadcast(max(y, z), n))
             expr = mutate(Max::make(max_a->a, Broadcast::make(Max::make(broadcast_a_b->value, broadcast_b->value), broadcast_b->lanes)));
-        } else if (max_a &&
-                   max_a_a &&
-                   equal(max_a_a->b, b)) {
-            // max(max(max(x, y), z), y) -> max(max(x, y), z)
-            expr = a;
-        } else if (max_a_a_a &&
-                   equal(max_a_a_a->b, b)) {
-            // max(max(max(max(x, y), z), w), y) -> max(max(max(x, y), z), w)
-            expr = a;
-        } else if (max_a_a_a_a &&
-                   equal(max_a_a_a_a->b, b)) {
-            // max(max(max(max(max(x, y), z), w), l), y) -> max(max(max(max(x, y), z), w), l)
-            expr = a;
-        } else if (max_a &&
-                   max_b &&
-                   equal(max_a->a, max_b->a)) {
-            // Distributive law for min/max
-            // max(max(x, y), max(x, z)) -> max(max(y, z), x)
-            expr = mutate(Max::make(Max::make(max_a->b, max_b->b), max_a->a));
-        } else if (max_a &&
-                   max_b &&
-                   equal(max_a->a, max_b->b)) {
-            // max(max(x, y), max(z, x)) -> max(max(y, z), x)
-            expr = mutate(Max::make(Max::make(max_a->b, max_b->a), max_a->a));
-        } else if (max_a &&
-                   max_b &&
-                   equal(max_a->b, max_b->a)) {
-            // max(max(y, x), max(x, z)) -> max(max(y, z), x)
-            expr = mutate(Max::make(Max::make(max_a->a, max_b->b), max_a->b));
-        } else if (max_a &&
-                   max_b &&
-                   equal(max_a->b, max_b->b)) {
-            // max(max(y, x), max(z, x)) -> max(max(y, z), x)
-            expr = mutate(Max::make(Max::make(max_a->a, max_b->a), max_a->b));
-        } else if (min_a &&
-                   min_b &&
-                   equal(min_a->a, min_b->a)) {
-            // max(min(x, y), min(x, z)) -> min(max(y, z), x)
-            expr = mutate(Min::make(Max::make(min_a->b, min_b->b), min_a->a));
-        } else if (min_a &&
-                   min_b &&
-                   equal(min_a->a, min_b->b)) {
-            // max(min(x, y), min(z, x)) -> min(max(y, z), x)
-            expr = mutate(Min::make(Max::make(min_a->b, min_b->a), min_a->a));
-        } else if (min_a &&
-                   min_b &&
-                   equal(min_a->b, min_b->a)) {
-            // max(min(y, x), min(x, z)) -> min(max(y, z), x)
-            expr = mutate(Min::make(Max::make(min_a->a, min_b->b), min_a->b));
-        } else if (min_a &&
-                   min_b &&
-                   equal(min_a->b, min_b->b)) {
-            // max(min(y, x), min(z, x)) -> min(max(y, z), x)
-            expr = mutate(Min::make(Max::make(min_a->a, min_b->a), min_a->b));
-        } else if (min_a &&
-                   max_a_a &&
-                   equal(max_a_a->b, b)) {
-            // max(min(max(x, y), z), y) -> max(min(x, z), y)
-            expr = mutate(max(min(max_a_a->a, min_a->b), b));
-        } else if (min_a &&
-                   max_a_a &&
-                   equal(max_a_a->a, b)) {
-            // max(min(max(y, x), z), y) -> max(min(x, z), y)
-            expr = mutate(max(min(max_a_a->b, min_a->b), b));
+        } else if (rewrite(max(max(max(x, y), z), y), a) ||
+                   rewrite(max(max(max(max(x, y), z), w), y), a) ||
+                   rewrite(max(max(max(max(max(x, y), z), w), u), y), a)) {
+            expr = rewrite.result;
+        } else if (// Distributive law for min/max
+                   rewrite(max(max(x, y), max(x, z)), max(max(y, z), x)) ||
+                   rewrite(max(max(x, y), max(z, x)), max(max(y, z), x)) ||
+                   rewrite(max(max(y, x), max(x, z)), max(max(y, z), x)) ||
+                   rewrite(max(max(y, x), max(z, x)), max(max(y, z), x)) ||
+                   rewrite(max(min(x, y), min(x, z)), min(max(y, z), x)) ||
+                   rewrite(max(min(x, y), min(z, x)), min(max(y, z), x)) ||
+                   rewrite(max(min(y, x), min(x, z)), min(max(y, z), x)) ||
+                   rewrite(max(min(y, x), min(z, x)), min(max(y, z), x)) ||
+                   rewrite(max(min(max(x, y), z), y), max(min(x, z), y)) ||
+                   rewrite(max(min(max(y, x), z), y), max(min(x, z), y))) {
+            expr = mutate(rewrite.result);
         } else if (no_overflow(op->type) &&
                    add_a &&
                    add_b &&
@@ -4830,6 +4707,29 @@ private:
         }
     }
 
+    void visit(const VectorReduce *op) {
+        Expr value = mutate(op->value);
+        const int lanes = op->type.lanes();
+        const int factor = value.type().lanes() / lanes;
+
+        if (factor == 1) {
+            expr = value;
+        } else if (const Broadcast *b = value.as<Broadcast>()) {
+            // Reducing a broadcast of a scalar
+            Expr v = b->value;
+            if (op->op == VectorReduce::Add) {
+                v = mutate(v * make_const(v.type(), factor));
+            } else if (op->op == VectorReduce::Mul) {
+                v = VectorReduce::make(op->op, Broadcast::make(v, factor), 1);
+            }
+            expr = lanes == 1 ? v : Broadcast::make(v, lanes);
+        } else if (value.same_as(op->value)) {
+            expr = op;
+        } else {
+            expr = VectorReduce::make(op->op, value, lanes);
+        }
+    }
+
     template <typename T>
     Expr hoist_slice_vector(Expr e) {
         const T *op = e.as<T>();
@@ -584,7 +584,7 @@ private:
                 // f(x) - b < c -> f(x) < c + b
                 expr = mutate(Cmp::make(sub_a->a, (b + sub_a->b)));
             } else if (mul_a) {
-                if (a.type().is_float()) {
+                if (a.type().is_float() || a.type().is_bfloat()) {
                     // f(x) * b == c -> f(x) == c / b
                     if (is_eq || is_ne || is_positive_const(mul_a->b)) {
                         expr = mutate(Cmp::make(mul_a->a, (b / mul_a->b)));
@@ -624,7 +624,7 @@ private:
                     }
                 }
             } else if (div_a) {
-                if (a.type().is_float()) {
+                if (a.type().is_float() || a.type().is_bfloat()) {
                     if (is_positive_const(div_a->b)) {
                         expr = mutate(Cmp::make(div_a->a, b * div_a->b));
                     } else if (is_negative_const(div_a->b)) {
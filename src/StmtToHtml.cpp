@@ -589,6 +589,15 @@ private:
         stream << close_span();
     }
 
+    void visit(const VectorReduce *op) {
+        stream << open_span("VectorReduce");
+        stream << open_span("Type") << op->type << close_span();
+        std::ostringstream op_name;
+        op_name << op->op;
+        print_list(symbol("vector_reduce(") + op_name.str() + ", ", {op->value}, ")");
+        stream << close_span();
+    }
+
 public:
     void print(Expr ir) {
         ir.accept(this);
@@ -9,7 +9,7 @@
 #include "LLVM_Headers.h"
 #include "Util.h"
 
-#if defined(__powerpc__) && defined(__linux__)
+#if (defined(__powerpc__) || defined(__aarch64__)) && defined(__linux__)
 // This uses elf.h and must be included after "LLVM_Headers.h", which
 // uses llvm/support/Elf.h.
 #include <sys/auxv.h>
@@ -74,7 +74,17 @@ Target calculate_host_target() {
 #else
 #if defined(__arm__) || defined(__aarch64__)
     Target::Arch arch = Target::ARM;
-    return Target(os, arch, bits);
+
+    std::vector<Target::Feature> initial_features;
+#if defined(__aarch64__) && defined(__linux__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    const unsigned long hwcap_asimdhp = 1UL << 10;
+    const unsigned long hwcap_asimddp = 1UL << 20;
+    if (hwcap & hwcap_asimddp) initial_features.push_back(Target::ARMDotProd);
+    if (hwcap & hwcap_asimdhp) initial_features.push_back(Target::ARMFp16);
+#endif
+
+    return Target(os, arch, bits, initial_features);
 #else
 #if defined(__powerpc__) && defined(__linux__)
     Target::Arch arch = Target::POWERPC;
@@ -138,6 +148,7 @@ Target calculate_host_target() {
         const uint32_t avx512_knl = avx512 | avx512pf | avx512er;
         const uint32_t avx512_skylake = avx512 | avx512vl | avx512bw | avx512dq;
         const uint32_t avx512_cannonlake = avx512_skylake | avx512ifma; // Assume ifma => vbmi
+        const uint32_t avx512vnni = 1U << 11; // Reported in ecx
         if ((info2[1] & avx2) == avx2) {
             initial_features.push_back(Target::AVX2);
         }
@@ -152,6 +163,10 @@ Target calculate_host_target() {
             if ((info2[1] & avx512_cannonlake) == avx512_cannonlake) {
                 initial_features.push_back(Target::AVX512_Cannonlake);
             }
+            if ((info2[1] & avx512_skylake) == avx512_skylake &&
+                (info2[2] & avx512vnni) == avx512vnni) {
+                initial_features.push_back(Target::AVX512_VNNI);
+            }
         }
     }
 #ifdef _WIN32
@@ -263,6 +278,9 @@ const std::map<std::string, Target::Feature> feature_name_map = {
     {"avx512_knl", Target::AVX512_KNL},
     {"avx512_skylake", Target::AVX512_Skylake},
     {"avx512_cannonlake", Target::AVX512_Cannonlake},
+    {"avx512_vnni", Target::AVX512_VNNI},
+    {"arm_dot_prod", Target::ARMDotProd},
+    {"arm_fp16", Target::ARMFp16},
     {"trace_loads", Target::TraceLoads},
     {"trace_stores", Target::TraceStores},
     {"trace_realizations", Target::TraceRealizations},
@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include "UnrollLoops.h"
+#include "IREquality.h"
 #include "IRMutator.h"
 #include "IROperator.h"
 #include "Simplify.h"
@@ -9,10 +12,129 @@ using std::vector;
 namespace Halide {
 namespace Internal {
 
+namespace {
+
+// Roughly how many vector registers the target has.
+int vector_register_count(const Target &t) {
+    switch (t.arch) {
+    case Target::X86:
+        // The same AVX512 flavors as CodeGen_X86::native_vector_bits.
+        if (t.has_feature(Target::AVX512) ||
+            t.has_feature(Target::AVX512_Skylake) ||
+            t.has_feature(Target::AVX512_KNL) ||
+            t.has_feature(Target::AVX512_Cannonlake) ||
+            t.has_feature(Target::AVX512_VNNI)) {
+            return 32;
+        }
+        return t.bits == 64 ? 16 : 8;
+    case Target::ARM:
+        return t.bits == 64 ? 32 : 16;
+    case Target::POWERPC:
+        return t.has_feature(Target::VSX) ? 64 : 32;
+    default:
+        return 32;
+    }
+}
+
+// Does an expression load from the given buffer at the given index?
+class LoadsFrom : public IRVisitor {
+    using IRVisitor::visit;
+
+    const std::string &name;
+    const Expr &index;
+
+    void visit(const Load *op) {
+        if (op->name == name && equal(op->index, index)) {
+            result = true;
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+public:
+    bool result = false;
+    LoadsFrom(const std::string &n, const Expr &i) : name(n), index(i) {}
+};
+
+// Estimate the number of vector registers needed to hold the values
+// that a statement updates in place, e.g. the accumulators of a
+// matrix multiply. These stay live across the iterations of an
+// enclosing loop, so all the unrolled copies of them need registers
+// at the same time. Values updated inside an inner serial loop are
+// only live during that loop, so they aren't counted.
+class CountAccumulatorRegisters : public IRVisitor {
+    using IRVisitor::visit;
+
+    const Target &target;
+    int lanes = 1;
+
+    void visit(const For *op) {
+        const IntImm *extent = simplify(op->extent).as<IntImm>();
+        if (!extent) {
+            return;
+        }
+        if (op->for_type == ForType::Unrolled) {
+            int old_count = count;
+            count = 0;
+            op->body.accept(this);
+            count = old_count + count * extent->value;
+        } else if (op->for_type == ForType::Vectorized) {
+            int old_lanes = lanes;
+            lanes *= extent->value;
+            op->body.accept(this);
+            lanes = old_lanes;
+        }
+    }
+
+    void visit(const Store *op) {
+        LoadsFrom loads(op->name, op->index);
+        substitute_in_all_lets(op->value).accept(&loads);
+        if (loads.result) {
+            int natural_lanes = std::max(1, target.natural_vector_size(op->value.type()));
+            count += (lanes + natural_lanes - 1) / natural_lanes;
+        }
+    }
+
+public:
+    int count = 0;
+    CountAccumulatorRegisters(const Target &t) : target(t) {}
+};
+
+}
+
 class UnrollLoops : public IRMutator {
     using IRMutator::visit;
 
+    const Target &target;
+    bool in_unrolled_loop = false;
+    bool on_device = false;
+
+    // Warn if the unrolled copies of a loop are likely to spill.
+    void check_register_pressure(const For *for_loop) {
+        if (in_unrolled_loop || on_device ||
+            target.os == Target::OSUnknown ||
+            target.arch == Target::ArchUnknown) {
+            return;
+        }
+        CountAccumulatorRegisters counter(target);
+        for_loop->accept(&counter);
+        int available = vector_register_count(target);
+        if (counter.count > available) {
+            user_warning << "Warning: The unrolled loop " << for_loop->name
+                         << " updates values that need about " << counter.count
+                         << " vector registers, but the target only has " << available
+                         << ". Some of them will be spilled to the stack. "
+                         << "Consider unrolling by a smaller factor.\n";
+        }
+    }
+
     void visit(const For *for_loop) {
+        bool old_on_device = on_device;
+        if (for_loop->device_api != DeviceAPI::None &&
+            for_loop->device_api != DeviceAPI::Host) {
+            on_device = true;
+        }
+
         if (for_loop->for_type == ForType::Unrolled) {
             // Give it one last chance to simplify to an int
             Expr extent = simplify(for_loop->extent);
@@ -20,7 +142,11 @@ class UnrollLoops : public IRMutator {
             user_assert(e)
                 << "Can only unroll for loops over a constant extent.\n"
                 << "Loop over " << for_loop->name << " has extent " << extent << ".\n";
+            check_register_pressure(for_loop);
+            bool old_in_unrolled_loop = in_unrolled_loop;
+            in_unrolled_loop = true;
             Stmt body = mutate(for_loop->body);
+            in_unrolled_loop = old_in_unrolled_loop;
 
             if (e->value == 1) {
                 user_warning << "Warning: Unrolling a for loop of extent 1: " << for_loop->name << "\n";
@@ -36,11 +162,16 @@ class UnrollLoops : public IRMutator {
         } else {
             IRMutator::visit(for_loop);
         }
+
+        on_device = old_on_device;
     }
+
+public:
+    UnrollLoops(const Target &t) : target(t) {}
 };
 
-Stmt unroll_loops(Stmt s) {
-    return UnrollLoops().mutate(s);
+Stmt unroll_loops(Stmt s, const Target &t) {
+    return UnrollLoops(t).mutate(s);
 }
 
 }
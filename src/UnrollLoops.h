@@ -6,14 +6,17 @@
  */
 
 #include "IR.h"
+#include "Target.h"
 
 namespace Halide {
 namespace Internal {
 
 /** Take a statement with for loops marked for unrolling, and convert
  * each into several copies of the innermost statement. I.e. unroll
- * the loop. */
-Stmt unroll_loops(Stmt);
+ * the loop. Warns if the values that the unrolled copies update in
+ * place (e.g. the accumulators of a reduction) are unlikely to fit in
+ * the target's vector registers. */
+Stmt unroll_loops(Stmt, const Target &t);
 
 }
 }
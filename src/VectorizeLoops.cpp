@@ -231,6 +231,27 @@ bool uses_gpu_vars(Expr s) {
     return uses.uses_gpu;
 }
 
+class LoadsFrom : public IRVisitor {
+private:
+    const string &buffer;
+    using IRVisitor::visit;
+    void visit(const Load *op) {
+        if (op->name == buffer) {
+            result = true;
+        }
+        IRVisitor::visit(op);
+    }
+public:
+    bool result = false;
+    LoadsFrom(const string &b) : buffer(b) {}
+};
+
+bool loads_from(Expr e, const string &buffer) {
+    LoadsFrom loads(buffer);
+    e.accept(&loads);
+    return loads.result;
+}
+
 // Wrap a vectorized predicate around a Load/Store node.
 class PredicateLoadStore : public IRMutator {
     string var;
@@ -337,6 +358,14 @@ class PredicateLoadStore : public IRMutator {
         IRMutator::visit(op);
     }
 
+    void visit(const VectorReduce *op) {
+        // A horizontal reduction would combine the masked-off lanes
+        // of its predicated loads too, so the statement must be
+        // scalarized instead.
+        valid = false;
+        expr = op;
+    }
+
 public:
     PredicateLoadStore(string v, Expr vpred, bool in_hexagon, const Target &t) :
             var(v), vector_predicate(vpred), in_hexagon(in_hexagon), target(t),
@@ -651,6 +680,133 @@ class VectorSubs : public IRMutator {
         }
     }
 
+    // Flatten a tree of Adds and Subs into a list of summands, each
+    // flagged with whether it is negated.
+    void collect_summands(Expr e, bool negate, vector<pair<Expr, bool>> &terms) {
+        if (const Add *add = e.as<Add>()) {
+            collect_summands(add->a, negate, terms);
+            collect_summands(add->b, negate, terms);
+        } else if (const Sub *sub = e.as<Sub>()) {
+            collect_summands(sub->a, negate, terms);
+            collect_summands(sub->b, !negate, terms);
+        } else {
+            terms.push_back({e, negate});
+        }
+    }
+
+    // A store of a vector of values to a single site is a reduction
+    // across the vector lanes. If the value stored combines the value
+    // already at that site with some other term using a commutative
+    // and associative operator, e.g. f[i] = f[i] + g[r], we can
+    // reduce the vector of other terms horizontally and combine the
+    // scalar result with the old value instead. value, index and
+    // predicate are the already vectorized parts of the store, so the
+    // old value appears as a broadcast of a scalar load. Returns an
+    // undefined Stmt if the store isn't of this form.
+    Stmt vectorize_reduction(const Store *op, Expr value, Expr index, Expr predicate) {
+        auto is_self_load = [&](Expr e) {
+            if (const Broadcast *broadcast = e.as<Broadcast>()) {
+                e = broadcast->value;
+            }
+            if (const Cast *cast = e.as<Cast>()) {
+                // Bools are stored as uint8.
+                if (cast->type.is_bool()) {
+                    e = cast->value;
+                }
+            }
+            const Load *load = e.as<Load>();
+            return (load && load->name == op->name && is_one(load->predicate) &&
+                    equal(load->index, index));
+        };
+
+        Expr stored = value;
+        const Cast *cast = stored.as<Cast>();
+        if (cast && cast->value.type().is_bool()) {
+            stored = cast->value;
+        }
+
+        Expr self, rest;
+        VectorReduce::Operator reduce_op = VectorReduce::Add;
+        if (stored.as<Add>() || stored.as<Sub>()) {
+            vector<pair<Expr, bool>> terms;
+            collect_summands(stored, false, terms);
+            for (const auto &term : terms) {
+                if (!self.defined() && !term.second && is_self_load(term.first)) {
+                    self = term.first;
+                } else if (!rest.defined()) {
+                    rest = term.second ? make_zero(term.first.type()) - term.first : term.first;
+                } else {
+                    rest = term.second ? rest - term.first : rest + term.first;
+                }
+            }
+        } else {
+            Expr a, b;
+            if (const Mul *mul = stored.as<Mul>()) {
+                reduce_op = VectorReduce::Mul;
+                a = mul->a;
+                b = mul->b;
+            } else if (const Min *min = stored.as<Min>()) {
+                reduce_op = VectorReduce::Min;
+                a = min->a;
+                b = min->b;
+            } else if (const Max *max = stored.as<Max>()) {
+                reduce_op = VectorReduce::Max;
+                a = max->a;
+                b = max->b;
+            } else if (const And *and_op = stored.as<And>()) {
+                reduce_op = VectorReduce::And;
+                a = and_op->a;
+                b = and_op->b;
+            } else if (const Or *or_op = stored.as<Or>()) {
+                reduce_op = VectorReduce::Or;
+                a = or_op->a;
+                b = or_op->b;
+            }
+            if (a.defined() && is_self_load(a)) {
+                self = a;
+                rest = b;
+            } else if (b.defined() && is_self_load(b)) {
+                self = b;
+                rest = a;
+            }
+        }
+
+        if (!self.defined() || !rest.defined() || rest.type().is_scalar() ||
+            loads_from(rest, op->name)) {
+            return Stmt();
+        }
+        if (const Broadcast *broadcast = self.as<Broadcast>()) {
+            self = broadcast->value;
+        }
+
+        Expr reduced = VectorReduce::make(reduce_op, rest, 1);
+        Expr result;
+        switch (reduce_op) {
+        case VectorReduce::Add:
+            result = self + reduced;
+            break;
+        case VectorReduce::Mul:
+            result = self * reduced;
+            break;
+        case VectorReduce::Min:
+            result = Min::make(self, reduced);
+            break;
+        case VectorReduce::Max:
+            result = Max::make(self, reduced);
+            break;
+        case VectorReduce::And:
+            result = self && reduced;
+            break;
+        case VectorReduce::Or:
+            result = self || reduced;
+            break;
+        }
+        if (!stored.same_as(value)) {
+            result = Cast::make(op->value.type(), result);
+        }
+        return Store::make(op->name, result, index, op->param, predicate);
+    }
+
     void visit(const Store *op) {
         Expr predicate = mutate(op->predicate);
         Expr value = mutate(op->value);
@@ -659,6 +815,12 @@ class VectorSubs : public IRMutator {
         if (predicate.same_as(op->predicate) && value.same_as(op->value) && index.same_as(op->index)) {
             stmt = op;
         } else {
+            if (value.type().is_vector() && index.type().is_scalar() && predicate.type().is_scalar()) {
+                stmt = vectorize_reduction(op, value, index, predicate);
+                if (stmt.defined()) {
+                    return;
+                }
+            }
             int lanes = std::max(predicate.type().lanes(), std::max(value.type().lanes(), index.type().lanes()));
             stmt = Store::make(op->name, widen(value, lanes), widen(index, lanes),
                                op->param, widen(predicate, lanes));
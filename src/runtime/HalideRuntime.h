@@ -243,7 +243,8 @@ extern int32_t halide_debug_to_file(void *user_context, const char *filename,
                                     struct halide_buffer_t *buf);
 
 /** Types in the halide type system. They can be ints, unsigned ints,
- * or floats (of various bit-widths), or a handle (which is always 64-bits).
+ * or floats (of various bit-widths), bfloats (the upper half of an IEEE
+ * float), or a handle (which is always 64-bits).
  * Note that the int/uint/float values do not imply a specific bit width
  * (the bit width is expected to be encoded in a separate value).
  */
@@ -255,7 +256,8 @@ typedef enum halide_type_code_t
     halide_type_int = 0,   //!< signed integers
     halide_type_uint = 1,  //!< unsigned integers
     halide_type_float = 2, //!< floating point numbers
-    halide_type_handle = 3 //!< opaque pointer type (void *)
+    halide_type_handle = 3, //!< opaque pointer type (void *)
+    halide_type_bfloat = 4  //!< brain floating point numbers
 } halide_type_code_t;
 
 // Note that while __attribute__ can go before or after the declaration,
@@ -1059,7 +1061,10 @@ typedef enum halide_target_feature_t {
     halide_target_feature_cuda_capability61 = 46,  ///< Enable CUDA compute capability 6.1 (Pascal)
     halide_target_feature_hvx_v65 = 47, ///< Enable Hexagon v65 architecture.
     halide_target_feature_hvx_v66 = 48, ///< Enable Hexagon v66 architecture.
-    halide_target_feature_end = 49, ///< A sentinel. Every target is considered to have this feature, and setting this feature does nothing.
+    halide_target_feature_avx512_vnni = 49, ///< Enable the AVX512 features supported by processors with the Vector Neural Network Instructions, such as Cascade Lake. This includes all of the Skylake features, plus AVX512-VNNI.
+    halide_target_feature_arm_dot_prod = 50, ///< Enable the ARMv8.2 8-bit dot product instructions (sdot/udot).
+    halide_target_feature_arm_fp16 = 51, ///< Enable the ARMv8.2 half-precision floating point arithmetic instructions.
+    halide_target_feature_end = 52, ///< A sentinel. Every target is considered to have this feature, and setting this feature does nothing.
 } halide_target_feature_t;
 
 /** This function is called internally by Halide in some situations to determine
@@ -147,6 +147,14 @@ WEAK int32_t halide_default_trace(void *user_context, const halide_trace_event_t
                     }
                 } else if (e->type.code == 3) {
                     ss << ((void **)(e->value))[i];
+                } else if (e->type.code == 4) {
+                    // A bfloat16 is the top half of a float.
+                    union {
+                        uint32_t as_uint;
+                        float as_float;
+                    } u;
+                    u.as_uint = ((uint32_t)((uint16_t *)(e->value))[i]) << 16;
+                    ss << u.as_float;
                 }
             }
             if (e->type.lanes > 1) {
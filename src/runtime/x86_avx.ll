@@ -83,3 +83,21 @@ define weak_odr <8 x float> @fast_inverse_sqrt_f32x8(<8 x float> %x) nounwind uw
   %approx = tail call <8 x float> @llvm.x86.avx.rsqrt.ps.256(<8 x float> %x);
   ret <8 x float> %approx
 }
+
+; F16C conversions between float16 and float32. These are only called
+; when the target has F16C.
+declare <8 x float> @llvm.x86.vcvtph2ps.256(<8 x i16>) nounwind readnone
+declare <8 x i16> @llvm.x86.vcvtps2ph.256(<8 x float>, i32) nounwind readnone
+
+define weak_odr <8 x float> @vcvtph2psx8(<8 x half> %x) nounwind uwtable readnone alwaysinline {
+  %bits = bitcast <8 x half> %x to <8 x i16>
+  %result = tail call <8 x float> @llvm.x86.vcvtph2ps.256(<8 x i16> %bits)
+  ret <8 x float> %result
+}
+
+define weak_odr <8 x half> @vcvtps2phx8(<8 x float> %x) nounwind uwtable readnone alwaysinline {
+  ; Round to nearest even.
+  %bits = tail call <8 x i16> @llvm.x86.vcvtps2ph.256(<8 x float> %x, i32 0)
+  %result = bitcast <8 x i16> %bits to <8 x half>
+  ret <8 x half> %result
+}
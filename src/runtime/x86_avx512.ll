@@ -0,0 +1,95 @@
+; Wrappers for the AVX-512BW intrinsics used by CodeGen_X86. The masked
+; forms of these intrinsics are the ones available in every LLVM version
+; we support; we always use them with an all-ones mask.
+
+declare <64 x i8> @llvm.x86.avx512.mask.padds.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+
+define weak_odr <64 x i8> @paddsbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.padds.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+declare <64 x i8> @llvm.x86.avx512.mask.psubs.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+
+define weak_odr <64 x i8> @psubsbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.psubs.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+declare <64 x i8> @llvm.x86.avx512.mask.paddus.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+
+define weak_odr <64 x i8> @paddusbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.paddus.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+declare <64 x i8> @llvm.x86.avx512.mask.psubus.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+
+define weak_odr <64 x i8> @psubusbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.psubus.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+declare <32 x i16> @llvm.x86.avx512.mask.padds.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+
+define weak_odr <32 x i16> @paddswx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.padds.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+declare <32 x i16> @llvm.x86.avx512.mask.psubs.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+
+define weak_odr <32 x i16> @psubswx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.psubs.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+declare <32 x i16> @llvm.x86.avx512.mask.paddus.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+
+define weak_odr <32 x i16> @padduswx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.paddus.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+declare <32 x i16> @llvm.x86.avx512.mask.psubus.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+
+define weak_odr <32 x i16> @psubuswx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.psubus.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+declare <32 x i16> @llvm.x86.avx512.mask.pmulh.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+
+define weak_odr <32 x i16> @pmulhwx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.pmulh.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+declare <32 x i16> @llvm.x86.avx512.mask.pmulhu.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+
+define weak_odr <32 x i16> @pmulhuwx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.pmulhu.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+; The averaging instructions are matched from generic IR.
+define weak_odr <64 x i8> @pavgbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = zext <64 x i8> %a to <64 x i16>
+  %2 = zext <64 x i8> %b to <64 x i16>
+  %3 = add nuw nsw <64 x i16> %1, <i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1>
+  %4 = add nuw nsw <64 x i16> %3, %2
+  %5 = lshr <64 x i16> %4, <i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1, i16 1>
+  %6 = trunc <64 x i16> %5 to <64 x i8>
+  ret <64 x i8> %6
+}
+
+; The averaging instructions are matched from generic IR.
+define weak_odr <32 x i16> @pavgwx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = zext <32 x i16> %a to <32 x i32>
+  %2 = zext <32 x i16> %b to <32 x i32>
+  %3 = add nuw nsw <32 x i32> %1, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+  %4 = add nuw nsw <32 x i32> %3, %2
+  %5 = lshr <32 x i32> %4, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+  %6 = trunc <32 x i32> %5 to <32 x i16>
+  ret <32 x i16> %6
+}
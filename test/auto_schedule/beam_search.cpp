@@ -0,0 +1,77 @@
+#include "Halide.h"
+
+#include <stdlib.h>
+
+using namespace Halide;
+
+// Auto-schedule a pipeline with diamond-shaped dependencies using the beam
+// search over groupings, and check that it computes the right thing.
+int main(int argc, char **argv) {
+#ifdef _WIN32
+    _putenv_s("HL_AUTO_SCHEDULE_BEAM_WIDTH", "4");
+#else
+    setenv("HL_AUTO_SCHEDULE_BEAM_WIDTH", "4", 1);
+#endif
+
+    int W = 1024;
+    int H = 1024;
+
+    Buffer<float> input(W + 4, H + 4);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (float)(rand() & 0xff);
+        }
+    }
+
+    Var x("x"), y("y");
+
+    Func a("a");
+    a(x, y) = input(x, y) * 2 + input(x + 1, y + 1);
+
+    // Two branches which both consume 'a' and are combined again.
+    Func b("b"), c("c");
+    b(x, y) = a(x, y) + a(x + 1, y) + a(x + 2, y);
+    c(x, y) = a(x, y) + a(x, y + 1) + a(x, y + 2);
+
+    Func d("d");
+    d(x, y) = b(x, y) * c(x, y);
+
+    Func e("e"), f("f");
+    e(x, y) = d(x, y) + d(x, y + 1);
+    f(x, y) = d(x, y) - d(x + 1, y);
+
+    Func out("out");
+    out(x, y) = e(x, y) + f(x, y);
+
+    out.estimate(x, 0, W).estimate(y, 0, H);
+
+    Target target = get_jit_target_from_environment();
+    Pipeline p(out);
+    p.auto_schedule(target);
+
+    // Inspect the schedule
+    out.print_loop_nest();
+
+    Buffer<float> result = p.realize(W, H);
+
+    auto ref_a = [&](int x, int y) {
+        return input(x, y) * 2 + input(x + 1, y + 1);
+    };
+    auto ref_d = [&](int x, int y) {
+        float b = ref_a(x, y) + ref_a(x + 1, y) + ref_a(x + 2, y);
+        float c = ref_a(x, y) + ref_a(x, y + 1) + ref_a(x, y + 2);
+        return b * c;
+    };
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            float correct = (ref_d(x, y) + ref_d(x, y + 1)) + (ref_d(x, y) - ref_d(x + 1, y));
+            if (std::abs(result(x, y) - correct) > 0.001f * std::abs(correct) + 0.01f) {
+                printf("result(%d, %d) = %f instead of %f\n", x, y, result(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
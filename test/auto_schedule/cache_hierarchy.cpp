@@ -0,0 +1,93 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+// A chain of stencils, with estimates for a W x H output.
+Func blur(Buffer<float> input, int W, int H) {
+    Var x("x"), y("y");
+
+    Func blur_x("blur_x");
+    blur_x(x, y) = (input(x, y) + input(x + 1, y) + input(x + 2, y) +
+                    input(x + 3, y) + input(x + 4, y)) / 5;
+
+    Func blur_y("blur_y");
+    blur_y(x, y) = (blur_x(x, y) + blur_x(x, y + 1) + blur_x(x, y + 2) +
+                    blur_x(x, y + 3) + blur_x(x, y + 4)) / 5;
+
+    Func out("out");
+    out(x, y) = blur_y(x, y) * blur_y(x, y) - input(x + 2, y + 2);
+
+    out.estimate(x, 0, W).estimate(y, 0, H);
+    return out;
+}
+
+// Auto-schedule a chain of stencils for a machine described with separate L1,
+// L2 and last level caches, and check that the tiles are split into L1-sized
+// sub-tiles and that it computes the right thing.
+int main(int argc, char **argv) {
+    int W = 1536;
+    int H = 1024;
+
+    Buffer<float> input(W + 4, H + 4);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (float)(rand() & 0xff);
+        }
+    }
+
+    Target target = get_jit_target_from_environment();
+
+    // The same machine described by its last level cache alone.
+    Pipeline single_cache(blur(input, W, H));
+    std::string single_cache_schedule =
+        single_cache.auto_schedule(target, MachineParams(16, 8 * 1024 * 1024, 40));
+
+    Func out = blur(input, W, H);
+    Pipeline p(out);
+
+    // 32KB L1, 256KB L2 and 8MB last level cache. A load which hits in L2
+    // costs 8 arithmetic operations; one that goes to memory 40.
+    MachineParams params(16, 32 * 1024, 256 * 1024, 8 * 1024 * 1024, 8, 40);
+    std::string schedule = p.auto_schedule(target, params);
+
+    // Inspect the schedule
+    out.print_loop_nest();
+
+    if (!target.has_gpu_feature()) {
+        // The L1 sub-tiles of a tile var v_i are split into v_i_o and
+        // v_i_i. Only the cache hierarchy should produce them.
+        if (schedule.find("_i_i(\"") == std::string::npos) {
+            printf("The schedule has no L1 sub-tiles:\n%s\n", schedule.c_str());
+            return -1;
+        }
+        if (single_cache_schedule.find("_i_i(\"") != std::string::npos) {
+            printf("The single cache schedule has L1 sub-tiles:\n%s\n",
+                   single_cache_schedule.c_str());
+            return -1;
+        }
+    }
+
+    Buffer<float> result = p.realize(W, H);
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            float by = 0;
+            for (int j = 0; j < 5; j++) {
+                float bx = 0;
+                for (int i = 0; i < 5; i++) {
+                    bx += input(x + i, y + j);
+                }
+                by += bx / 5;
+            }
+            by /= 5;
+            float correct = by * by - input(x + 2, y + 2);
+            if (std::abs(result(x, y) - correct) > 0.01f * std::abs(correct) + 0.01f) {
+                printf("result(%d, %d) = %f instead of %f\n", x, y, result(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "Halide.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Halide;
+
+// Build a pipeline with many stages: 'layers' layers of 'width' stencils,
+// each of which reads from two stencils of the previous layer.
+Pipeline make_pipeline(ImageParam input, int layers, int width) {
+    Var x("x"), y("y");
+
+    std::vector<Func> prev;
+    for (int i = 0; i < width; i++) {
+        Func f("f_0_" + std::to_string(i));
+        f(x, y) = input(x, y) * (i + 1);
+        prev.push_back(f);
+    }
+    for (int l = 1; l < layers; l++) {
+        std::vector<Func> next;
+        for (int i = 0; i < width; i++) {
+            const Func &a = prev[i];
+            const Func &b = prev[(i + 1) % width];
+            Func f("f_" + std::to_string(l) + "_" + std::to_string(i));
+            if (l % 2) {
+                f(x, y) = a(x - 1, y) + a(x + 1, y) + b(x, y) / 2;
+            } else {
+                f(x, y) = a(x, y - 1) + a(x, y + 1) - b(x, y) / 2;
+            }
+            next.push_back(f);
+        }
+        prev = next;
+    }
+
+    Func out("out");
+    Expr e = 0.0f;
+    for (const Func &f : prev) {
+        e += f(x, y);
+    }
+    out(x, y) = e;
+
+    out.estimate(x, 0, 1536).estimate(y, 0, 2560);
+    return Pipeline(out);
+}
+
+// Measure how long it takes to auto-schedule a pipeline with 100+ stages.
+int main(int argc, char **argv) {
+    const int layers = 32, width = 4;
+
+    ImageParam input(Float(32), 2, "input");
+    input.dim(0).set_bounds_estimate(0, 1536 + 2 * layers);
+    input.dim(1).set_bounds_estimate(0, 2560 + 2 * layers);
+
+    Target target = get_jit_target_from_environment();
+    Pipeline p = make_pipeline(input, layers, width);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    p.auto_schedule(target);
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("Auto-scheduling %d stages took %f seconds\n", layers * width + 1, seconds);
+
+    // Check that the schedule is valid.
+    p.compile_jit(target);
+
+    printf("Success!\n");
+    return 0;
+}
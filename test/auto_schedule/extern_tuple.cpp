@@ -0,0 +1,106 @@
+#include "Halide.h"
+#include <stdio.h>
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+// An extern stage that computes the square of each value of its input.
+extern "C" DLLEXPORT int square(halide_buffer_t *in, halide_buffer_t *out) {
+    if (in->is_bounds_query()) {
+        for (int d = 0; d < 2; d++) {
+            in->dim[d].min = out->dim[d].min;
+            in->dim[d].extent = out->dim[d].extent;
+        }
+    } else {
+        assert(in->type == halide_type_of<int>());
+        assert(out->type == halide_type_of<int>());
+        for (int y = out->dim[1].min; y < out->dim[1].min + out->dim[1].extent; y++) {
+            for (int x = out->dim[0].min; x < out->dim[0].min + out->dim[0].extent; x++) {
+                const int *in_ptr = (const int *)in->host +
+                    (x - in->dim[0].min) * in->dim[0].stride + (y - in->dim[1].min) * in->dim[1].stride;
+                int *out_ptr = (int *)out->host +
+                    (x - out->dim[0].min) * out->dim[0].stride + (y - out->dim[1].min) * out->dim[1].stride;
+                *out_ptr = (*in_ptr) * (*in_ptr);
+            }
+        }
+    }
+    return 0;
+}
+
+using namespace Halide;
+
+bool is_scheduled(Func f) {
+    for (const Internal::Dim &d : f.function().definition().schedule().dims()) {
+        if (d.for_type == Internal::ForType::Parallel || d.for_type == Internal::ForType::Vectorized) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Auto-schedule a pipeline with Tuple-valued stages on either side of an
+// extern stage. The Funcs around the extern stage should still be tiled,
+// vectorized and parallelized, and the pipeline should compute the right
+// thing.
+int main(int argc, char **argv) {
+    const int W = 1024, H = 1024;
+
+    Buffer<int> input(W + 2, H + 2);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (rand() & 0xff) - 128;
+        }
+    }
+
+    Var x("x"), y("y");
+
+    Func tup("tup");
+    tup(x, y) = Tuple(input(x, y) * 3, input(x, y) - 7);
+
+    Func pre("pre");
+    pre(x, y) = tup(x, y)[0] + tup(x + 1, y)[1] + tup(x + 2, y)[0];
+
+    Func sq("sq");
+    sq.define_extern("square", {pre}, Int(32), 2);
+
+    Func post("post");
+    post(x, y) = Tuple(sq(x, y) + sq(x, y + 2), sq(x, y + 1));
+
+    Func out("out");
+    out(x, y) = post(x, y)[0] - post(x, y)[1];
+
+    // Declare the region of 'pre' read by the extern stage.
+    pre.estimate(x, 0, W).estimate(y, 0, H + 2);
+    out.estimate(x, 0, W).estimate(y, 0, H);
+
+    Target target = get_jit_target_from_environment();
+    Pipeline p(out);
+    p.auto_schedule(target);
+
+    if (!is_scheduled(pre) || !is_scheduled(out)) {
+        printf("Expected the Funcs around the extern stage to be scheduled\n");
+        return -1;
+    }
+
+    Buffer<int> result = p.realize(W, H);
+
+    auto ref_sq = [&](int x, int y) {
+        int v = input(x, y) * 3 + (input(x + 1, y) - 7) + input(x + 2, y) * 3;
+        return v * v;
+    };
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int correct = ref_sq(x, y) + ref_sq(x, y + 2) - ref_sq(x, y + 1);
+            if (result(x, y) != correct) {
+                printf("result(%d, %d) = %d instead of %d\n", x, y, result(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+// Auto-schedule a small pipeline for a GPU target and check that the schedule
+// maps it onto blocks and threads. This only lowers the pipeline, so it does
+// not need a GPU to be present.
+bool test_gpu_target(const Target &target) {
+    ImageParam input(Float(32), 2, "input");
+    Var x("x"), y("y");
+
+    Func in_b = BoundaryConditions::repeat_edge(input);
+
+    Func blur_x("blur_x");
+    blur_x(x, y) = (in_b(x - 1, y) + in_b(x, y) + in_b(x + 1, y)) / 3;
+
+    Func blur_y("blur_y");
+    blur_y(x, y) = (blur_x(x, y - 1) + blur_x(x, y) + blur_x(x, y + 1)) / 3;
+
+    RDom r(0, 64, 0, 64);
+    Func hist("hist");
+    hist(x) = 0;
+    hist(clamp(cast<int>(blur_y(r.x, r.y)), 0, 255)) += 1;
+
+    Func out("out");
+    out(x, y) = blur_y(x, y) + hist(x % 256);
+
+    out.estimate(x, 0, 1536).estimate(y, 0, 2560);
+    input.dim(0).set_bounds_estimate(0, 1536);
+    input.dim(1).set_bounds_estimate(0, 2560);
+
+    Pipeline p(out);
+    std::string schedule = p.auto_schedule(target);
+
+    if (schedule.find("gpu_blocks") == std::string::npos ||
+        schedule.find("gpu_threads") == std::string::npos) {
+        printf("Expected a GPU schedule for %s, got:\n%s\n",
+               target.to_string().c_str(), schedule.c_str());
+        return false;
+    }
+
+    // Check that the schedule is legal by lowering the pipeline.
+    p.compile_to_module(p.infer_arguments(), "gpu_schedule", target);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Target host = get_host_target();
+    for (auto feature : {Target::CUDA, Target::OpenCL}) {
+        if (!test_gpu_target(host.with_feature(feature))) {
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
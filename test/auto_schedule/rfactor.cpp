@@ -0,0 +1,87 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+// Auto-schedule reductions which have little or no parallelism along their
+// pure dimensions, and check that they are rfactored and still compute the
+// right thing.
+int main(int argc, char **argv) {
+    const int W = 4096, H = 4096;
+
+    Buffer<uint8_t> input(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            input(x, y) = (uint8_t)((x * 17 + y * 31 + (x * y) % 7) & 0xff);
+        }
+    }
+
+    Var x("x");
+    RDom r(0, W, 0, H, "r");
+
+    // A sum over the whole image.
+    Func sum("sum");
+    sum() = cast<uint32_t>(0);
+    sum() += cast<uint32_t>(input(r.x, r.y));
+
+    // A histogram.
+    Func hist("hist");
+    hist(x) = 0;
+    hist(input(r.x, r.y)) += 1;
+
+    // The maximum and the (last) index at which it occurs.
+    Func arg_max("arg_max");
+    arg_max() = Tuple(cast<uint8_t>(0), 0);
+    arg_max() = Tuple(max(arg_max()[0], input(r.x, r.y)),
+                      select(input(r.x, r.y) < arg_max()[0], arg_max()[1], r.x + r.y * W));
+
+    hist.estimate(x, 0, 256);
+
+    Target target = get_jit_target_from_environment();
+    Pipeline p({sum, hist, arg_max});
+    std::string schedule = p.auto_schedule(target);
+
+    if (schedule.find("rfactor") == std::string::npos) {
+        printf("Expected the reductions to be rfactored:\n%s\n", schedule.c_str());
+        return -1;
+    }
+
+    Buffer<uint32_t> sum_result = Buffer<uint32_t>::make_scalar();
+    Buffer<int> hist_result(256);
+    Buffer<uint8_t> max_result = Buffer<uint8_t>::make_scalar();
+    Buffer<int> max_index = Buffer<int>::make_scalar();
+    p.realize({sum_result, hist_result, max_result, max_index});
+
+    uint32_t correct_sum = 0;
+    int correct_hist[256] = {0};
+    uint8_t correct_max = 0;
+    int correct_index = 0;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            correct_sum += input(x, y);
+            correct_hist[input(x, y)]++;
+            if (input(x, y) >= correct_max) {
+                correct_max = input(x, y);
+                correct_index = x + y * W;
+            }
+        }
+    }
+
+    if (sum_result() != correct_sum) {
+        printf("sum = %u instead of %u\n", sum_result(), correct_sum);
+        return -1;
+    }
+    for (int i = 0; i < 256; i++) {
+        if (hist_result(i) != correct_hist[i]) {
+            printf("hist(%d) = %d instead of %d\n", i, hist_result(i), correct_hist[i]);
+            return -1;
+        }
+    }
+    if ((max_result() != correct_max) || (max_index() != correct_index)) {
+        printf("arg_max = (%d, %d) instead of (%d, %d)\n",
+               max_result(), max_index(), correct_max, correct_index);
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+// Define a pipeline with a stencil chain and a large reduction. Each call
+// defines a new instance of the same pipeline.
+Pipeline make_pipeline(Buffer<uint8_t> input) {
+    Var x("x"), y("y");
+
+    Func in("in");
+    in(x, y) = cast<uint16_t>(input(clamp(x, 0, input.width() - 1),
+                                    clamp(y, 0, input.height() - 1)));
+
+    Func blur_x("blur_x");
+    blur_x(x, y) = in(x - 1, y) + in(x, y) + in(x + 1, y);
+
+    Func blur_y("blur_y");
+    blur_y(x, y) = blur_x(x, y - 1) + blur_x(x, y) + blur_x(x, y + 1);
+
+    RDom r(0, input.width(), 0, input.height(), "r");
+    Func sum("sum");
+    sum() = cast<uint32_t>(0);
+    sum() += cast<uint32_t>(in(r.x, r.y));
+
+    blur_y.estimate(x, 0, input.width()).estimate(y, 0, input.height());
+
+    return Pipeline({blur_y, sum});
+}
+
+// Auto-schedule a pipeline in serialized form, apply the schedule to another
+// instance of the pipeline, and check that both compute the same thing.
+int main(int argc, char **argv) {
+    const int W = 2048, H = 2048;
+
+    Buffer<uint8_t> input(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            input(x, y) = (uint8_t)(rand() & 0xff);
+        }
+    }
+
+    Target target = get_jit_target_from_environment();
+
+    Pipeline p1 = make_pipeline(input);
+    std::string schedule = p1.auto_schedule_serialized(target);
+    printf("%s\n", schedule.c_str());
+
+    Pipeline p2 = make_pipeline(input);
+    p2.apply_schedule(schedule);
+
+    if (p2.outputs()[0].function().definition().schedule().splits().empty()) {
+        printf("Expected the schedule to be applied to the second pipeline\n");
+        return -1;
+    }
+
+    Buffer<uint16_t> blur1(W, H), blur2(W, H);
+    Buffer<uint32_t> sum1 = Buffer<uint32_t>::make_scalar();
+    Buffer<uint32_t> sum2 = Buffer<uint32_t>::make_scalar();
+    p1.realize({blur1, sum1}, target);
+    p2.realize({blur2, sum2}, target);
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if (blur1(x, y) != blur2(x, y)) {
+                printf("blur2(%d, %d) = %d instead of %d\n", x, y, blur2(x, y), blur1(x, y));
+                return -1;
+            }
+        }
+    }
+    if (sum1() != sum2()) {
+        printf("sum2 = %u instead of %u\n", sum2(), sum1());
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
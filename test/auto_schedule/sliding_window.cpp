@@ -0,0 +1,116 @@
+#include "Halide.h"
+
+#include <cmath>
+
+using namespace Halide;
+
+// An extern function which may have side effects, so a call to it must
+// be made every time the pipeline runs. It is never called below.
+HalideExtern_1(float, dither_f32, float);
+
+// Auto-schedule a pipeline with a lookup table which only depends on a
+// parameter, followed by a chain of tall stencils. The table should be
+// memoized and the stencils should slide along the tiles of the output.
+int main(int argc, char **argv) {
+    const int W = 2048, H = 4096;
+
+    Buffer<uint16_t> input(W + 3, H + 6);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (uint16_t)(rand() & 0x3ff);
+        }
+    }
+
+    Param<float> gamma("gamma");
+    Var x("x"), y("y");
+
+    Func curve("curve");
+    curve(x) = cast<uint8_t>(clamp(pow(cast<float>(x) / 1023.0f, 1.0f / gamma) * 255.0f, 0, 255));
+
+    Func in("in");
+    in(x, y) = curve(clamp(input(x, y), 0, 1023));
+
+    Func blur_x("blur_x");
+    blur_x(x, y) = (cast<uint16_t>(in(x, y)) + in(x + 1, y) + in(x + 2, y) + in(x + 3, y));
+
+    Func blur_y("blur_y");
+    blur_y(x, y) = (blur_x(x, y) + blur_x(x, y + 1) + blur_x(x, y + 2) +
+                    blur_x(x, y + 3) + blur_x(x, y + 4));
+
+    Func out("out");
+    out(x, y) = blur_y(x, y) * 3 + blur_y(x, y + 2);
+
+    curve.estimate(x, 0, 1024);
+    out.estimate(x, 0, W).estimate(y, 0, H);
+    gamma.set_estimate(2.2f);
+
+    Target target = get_jit_target_from_environment();
+    Pipeline p(out);
+    std::string schedule = p.auto_schedule(target, MachineParams(16, 16 * 1024 * 1024, 40));
+
+    if (schedule.find("memoize()") == std::string::npos) {
+        printf("Expected the lookup table to be memoized:\n%s\n", schedule.c_str());
+        return -1;
+    }
+    if (schedule.find("store_at(") == std::string::npos) {
+        printf("Expected the stencils to use a sliding window:\n%s\n", schedule.c_str());
+        return -1;
+    }
+
+    // Run with two different values of the parameter, to check that the
+    // memoized table is recomputed when it changes.
+    for (float g : {2.2f, 1.8f, 2.2f}) {
+        gamma.set(g);
+        Buffer<uint16_t> result = p.realize(W, H);
+
+        uint8_t lut[1024];
+        for (int i = 0; i < 1024; i++) {
+            float v = std::pow(i / 1023.0f, 1.0f / g) * 255.0f;
+            lut[i] = (uint8_t)std::min(std::max(v, 0.0f), 255.0f);
+        }
+        auto ref_blur_y = [&](int x, int y) {
+            uint16_t by = 0;
+            for (int j = 0; j < 5; j++) {
+                for (int i = 0; i < 4; i++) {
+                    by += lut[input(x + i, y + j)];
+                }
+            }
+            return by;
+        };
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                uint16_t correct = (uint16_t)(ref_blur_y(x, y) * 3 + ref_blur_y(x, y + 2));
+                // The table entries may differ by one due to differences in
+                // the precision of pow.
+                if (std::abs(result(x, y) - correct) > 80) {
+                    printf("result(%d, %d) = %d instead of %d\n", x, y, result(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // The same lookup table with a call to an impure extern function
+        // in it can't be memoized.
+        Func noisy_curve("noisy_curve");
+        noisy_curve(x) = cast<uint8_t>(clamp(pow(cast<float>(x) / 1023.0f, 1.0f / gamma) * 255.0f +
+                                             dither_f32(cast<float>(x)), 0, 255));
+        Func noisy_out("noisy_out");
+        noisy_out(x, y) = cast<uint16_t>(noisy_curve(clamp(input(x, y), 0, 1023))) * 3;
+
+        noisy_curve.estimate(x, 0, 1024);
+        noisy_out.estimate(x, 0, W).estimate(y, 0, H);
+
+        Pipeline noisy_p(noisy_out);
+        std::string noisy_schedule =
+            noisy_p.auto_schedule(target, MachineParams(16, 16 * 1024 * 1024, 40));
+        if (noisy_schedule.find("memoize()") != std::string::npos) {
+            printf("The lookup table shouldn't be memoized:\n%s\n", noisy_schedule.c_str());
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
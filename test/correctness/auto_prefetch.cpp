@@ -0,0 +1,146 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+using std::string;
+using std::vector;
+
+// Find the names of the loops that directly contain prefetches.
+class FindPrefetchLoops : public IRVisitor {
+    vector<string> loops;
+
+    using IRVisitor::visit;
+
+    void visit(const For *op) {
+        loops.push_back(op->name);
+        IRVisitor::visit(op);
+        loops.pop_back();
+    }
+
+    void visit(const Call *op) {
+        IRVisitor::visit(op);
+        if (op->is_intrinsic(Call::prefetch)) {
+            // Skip the loops added to split the prefetch into cache lines.
+            for (auto it = loops.rbegin(); it != loops.rend(); it++) {
+                if (!starts_with(*it, "prefetch_")) {
+                    prefetch_loops.push_back(*it);
+                    break;
+                }
+            }
+        }
+    }
+
+public:
+    vector<string> prefetch_loops;
+};
+
+class CheckPrefetchLoop : public IRMutator {
+    string loop;
+public:
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) {
+        FindPrefetchLoops f;
+        s.accept(&f);
+        if (f.prefetch_loops.empty()) {
+            printf("There are no prefetches, but there should be some in %s\n", loop.c_str());
+            exit(-1);
+        }
+        for (const string &l : f.prefetch_loops) {
+            if (l != loop) {
+                printf("There is a prefetch in %s instead of %s\n", l.c_str(), loop.c_str());
+                exit(-1);
+            }
+        }
+        return s;
+    }
+
+    CheckPrefetchLoop(string l) : loop(l) {}
+};
+
+int check(Buffer<int> result, std::function<int(int, int)> correct) {
+    for (int y = 0; y < result.height(); y++) {
+        for (int x = 0; x < result.width(); x++) {
+            if (result(x, y) != correct(x, y)) {
+                printf("result(%d, %d) = %d instead of %d\n",
+                       x, y, result(x, y), correct(x, y));
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const int size = 256;
+    Var x("x"), y("y"), xi("xi");
+
+    {
+        // Every iteration of the loop over x reads a new row of f.
+        Func f("f"), g("g");
+        f(x, y) = x + 2 * y;
+        g(x, y) = f(y, x);
+        f.compute_root();
+        g.prefetch(f);
+
+        g.add_custom_lowering_pass(new CheckPrefetchLoop(g.name() + ".s0.x"));
+        Buffer<int> result = g.realize(size, size);
+        if (check(result, [](int x, int y) { return y + 2 * x; })) {
+            return -1;
+        }
+    }
+
+    {
+        // The vectorized loop can't have a prefetch in it, so it goes in
+        // the loop outside of it.
+        Func f("f"), g("g");
+        f(x, y) = x + 2 * y;
+        g(x, y) = f(y, x);
+        f.compute_root();
+        g.split(x, x, xi, 8).vectorize(xi).prefetch(f);
+
+        g.add_custom_lowering_pass(new CheckPrefetchLoop(g.name() + ".s0.x.x"));
+        Buffer<int> result = g.realize(size, size);
+        if (check(result, [](int x, int y) { return y + 2 * x; })) {
+            return -1;
+        }
+    }
+
+    {
+        // The region of f that is read doesn't move over x, so the
+        // prefetch goes in the loop over y.
+        Func f("f"), g("g");
+        f(x, y) = x + 2 * y;
+        g(x, y) = f(0, y) * x;
+        f.compute_root();
+        g.prefetch(f);
+
+        g.add_custom_lowering_pass(new CheckPrefetchLoop(g.name() + ".s0.y"));
+        Buffer<int> result = g.realize(size, size);
+        if (check(result, [](int x, int y) { return 2 * y * x; })) {
+            return -1;
+        }
+    }
+
+    {
+        // Automatic prefetches of an input image.
+        ImageParam input(Int(32), 2, "input");
+        Func g("g");
+        g(x, y) = input(y, x) + 1;
+        g.prefetch(input);
+
+        Buffer<int> in(size, size);
+        in.for_each_element([&](int x, int y) { in(x, y) = x - y; });
+        input.set(in);
+
+        g.add_custom_lowering_pass(new CheckPrefetchLoop(g.name() + ".s0.x"));
+        Buffer<int> result = g.realize(size, size);
+        if (check(result, [](int x, int y) { return y - x + 1; })) {
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
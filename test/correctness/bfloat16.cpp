@@ -0,0 +1,111 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <cmath>
+
+using namespace Halide;
+
+// bfloat16 values should load and store as 16 bits, and do their
+// arithmetic in float, rounding back to bfloat16 after every operation,
+// the same way bfloat16_t does it on the host.
+int main(int argc, char **argv) {
+    // Check the host-side type first.
+    if (sizeof(bfloat16_t) != 2) {
+        printf("bfloat16_t has the wrong size\n");
+        return -1;
+    }
+    if (bfloat16_t(1.0f).to_bits() != 0x3f80 ||
+        bfloat16_t(-2.5f).to_bits() != 0xc020 ||
+        (float)bfloat16_t::make_from_bits(0x4049) != 3.140625f) {
+        printf("bfloat16_t has the wrong bits\n");
+        return -1;
+    }
+    // 1 + 2^-8 is exactly halfway between two bfloats. Ties go to even.
+    if (bfloat16_t(1.0f + 1.0f / 256).to_bits() != 0x3f80 ||
+        bfloat16_t(1.0f + 3.0f / 256).to_bits() != 0x3f82) {
+        printf("bfloat16_t rounds incorrectly\n");
+        return -1;
+    }
+    if (!bfloat16_t(NAN).is_nan() || !bfloat16_t(INFINITY).is_infinity()) {
+        printf("bfloat16_t doesn't preserve NaN or infinity\n");
+        return -1;
+    }
+    if (halide_type_of<bfloat16_t>() != halide_type_t(halide_type_bfloat, 16) ||
+        type_of<bfloat16_t>() != BFloat(16)) {
+        printf("Wrong halide_type_t for bfloat16_t\n");
+        return -1;
+    }
+
+    const int W = 256;
+    Buffer<bfloat16_t> in(W);
+    Buffer<float> in_f32(W);
+    for (int x = 0; x < W; x++) {
+        in(x) = bfloat16_t((rand() % 2000 - 1000) / 37.0f);
+        in_f32(x) = (rand() % 2000 - 1000) / 37.0f;
+    }
+
+    Var x("x");
+
+    {
+        // Arithmetic, with rounding after each operation.
+        Func f("f");
+        f(x) = in(x) * bfloat16_t(3.0f) + in(W - 1 - x) - bfloat16_t(0.25f);
+        f.vectorize(x, 16);
+
+        Buffer<bfloat16_t> result = f.realize(W);
+        for (int x = 0; x < W; x++) {
+            bfloat16_t a = bfloat16_t((float)in(x) * 3.0f);
+            bfloat16_t b = bfloat16_t((float)a + (float)in(W - 1 - x));
+            bfloat16_t correct = bfloat16_t((float)b - 0.25f);
+            if (result(x).to_bits() != correct.to_bits()) {
+                printf("arithmetic: result(%d) = %f instead of %f\n",
+                       x, (float)result(x), (float)correct);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // Conversions to and from float and int, and comparisons.
+        Func f("f"), g("g");
+        f(x) = cast<bfloat16_t>(in_f32(x));
+        g(x) = select(f(x) > in(x), cast<int>(max(f(x), in(x))), cast<int>(abs(in(x))));
+        f.compute_root().vectorize(x, 8);
+        g.vectorize(x, 8);
+
+        Buffer<int> result = g.realize(W);
+        for (int x = 0; x < W; x++) {
+            bfloat16_t fx = bfloat16_t(in_f32(x));
+            float a = (float)fx, b = (float)in(x);
+            int correct = a > b ? (int)std::max(a, b) : (int)std::abs(b);
+            if (result(x) != correct) {
+                printf("conversion: result(%d) = %d instead of %d\n", x, result(x), correct);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // Math functions are computed in float.
+        Func f("f");
+        f(x) = sqrt(abs(in(x))) + floor(in(x));
+        f.vectorize(x, 8);
+
+        if (f.output_types()[0] != Float(32)) {
+            printf("sqrt of a bfloat16 should be a float\n");
+            return -1;
+        }
+
+        Buffer<float> result = f.realize(W);
+        for (int x = 0; x < W; x++) {
+            float v = (float)in(x);
+            float correct = std::sqrt(std::abs(v)) + (float)bfloat16_t(std::floor(v));
+            if (std::abs(result(x) - correct) > 1e-5f) {
+                printf("math: result(%d) = %f instead of %f\n", x, result(x), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
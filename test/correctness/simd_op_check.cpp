@@ -39,6 +39,7 @@ struct Task {
     string name;
     int vector_width;
     Expr expr;
+    bool is_reduction;
 };
 
 size_t num_threads = Halide::Internal::ThreadPool<void>::num_processors_online();
@@ -49,6 +50,7 @@ struct Test {
     bool use_avx512_cannonlake{false};
     bool use_avx512_knl{false};
     bool use_avx512_skylake{false};
+    bool use_avx512_vnni{false};
     bool use_avx{false};
     bool use_power_arch_2_07{false};
     bool use_sse41{false};
@@ -73,6 +75,9 @@ struct Test {
     ImageParam in_i64{Int(64), 1, "in_i64"};
     ImageParam in_u64{UInt(64), 1, "in_u64"};
 
+    // The reduction domain used by check_reduction.
+    const RDom r_reduce{0, 64, "r_reduce"};
+
     const vector<ImageParam> image_params{in_f32, in_f64, in_i8, in_u8, in_i16, in_u16, in_i32, in_u32, in_i64, in_u64};
     const vector<Argument> arg_types{in_f32, in_f64, in_i8, in_u8, in_i16, in_u16, in_i32, in_u32, in_i64, in_u64};
 
@@ -83,7 +88,8 @@ struct Test {
             .with_feature(Target::NoRuntime);
         use_avx512_knl = target.has_feature(Target::AVX512_KNL);
         use_avx512_cannonlake = target.has_feature(Target::AVX512_Cannonlake);
-        use_avx512_skylake = use_avx512_cannonlake || target.has_feature(Target::AVX512_Skylake);
+        use_avx512_vnni = target.has_feature(Target::AVX512_VNNI);
+        use_avx512_skylake = use_avx512_cannonlake || use_avx512_vnni || target.has_feature(Target::AVX512_Skylake);
         use_avx512 = use_avx512_knl || use_avx512_skylake || use_avx512_cannonlake || target.has_feature(Target::AVX512);
         use_avx2 = use_avx512 || target.has_feature(Target::AVX2);
         use_avx = use_avx2 || target.has_feature(Target::AVX);
@@ -137,7 +143,7 @@ struct Test {
         // A bunch of feature flags also need to match between the
         // compiled code and the host in order to run the code.
         for (Target::Feature f : {Target::SSE41, Target::AVX,
-                    Target::AVX2, Target::AVX512,
+                    Target::AVX2, Target::AVX512, Target::AVX512_VNNI,
                     Target::FMA, Target::FMA4, Target::F16C,
                     Target::VSX, Target::POWER_ARCH_2_07,
                     Target::ARMv7s, Target::NoNEON, Target::MinGW}) {
@@ -188,18 +194,29 @@ struct Test {
         return wildcard_match("*" + p + "*", str);
     }
 
-    TestResult check_one(const string &op, const string &name, int vector_width, Expr e) const {
+    TestResult check_one(const string &op, const string &name, int vector_width, Expr e, bool is_reduction) const {
         std::ostringstream error_msg;
 
         // Define a vectorized Func that uses the pattern.
         Func f(name);
-        f(x, y) = e;
-        f.bound(x, 0, W).vectorize(x, vector_width);
-        f.compute_root();
-
         // Include a scalar version
         Func f_scalar("scalar_" + name);
-        f_scalar(x, y) = e;
+        if (is_reduction) {
+            // Sum the pattern over r_reduce, vectorizing the RVar.
+            f(x, y) = cast(e.type(), 0);
+            f(x, y) += e;
+            f.bound(x, 0, W);
+            f.update().vectorize(r_reduce.x, vector_width);
+
+            f_scalar(x, y) = cast(e.type(), 0);
+            f_scalar(x, y) += e;
+        } else {
+            f(x, y) = e;
+            f.bound(x, 0, W).vectorize(x, vector_width);
+
+            f_scalar(x, y) = e;
+        }
+        f.compute_root();
         f_scalar.bound(x, 0, W);
         f_scalar.compute_root();
 
@@ -256,7 +273,7 @@ struct Test {
         return { op, error_msg.str() };
     }
 
-    void check(string op, int vector_width, Expr e) {
+    void check(string op, int vector_width, Expr e, bool is_reduction = false) {
         // Make a name for the test by uniquing then sanitizing the op name
         string name = "op_" + op;
         for (size_t i = 0; i < name.size(); i++) {
@@ -270,7 +287,13 @@ struct Test {
         // settings.
         if (!wildcard_match(filter, op)) return;
 
-        tasks.emplace_back(Task {op, name, vector_width, e});
+        tasks.emplace_back(Task {op, name, vector_width, e, is_reduction});
+    }
+
+    // Check that summing e over r_reduce, with r_reduce vectorized by
+    // the given width, generates the op.
+    void check_reduction(string op, int vector_width, Expr e) {
+        check(op, vector_width, e, true);
     }
 
     void check_sse_all() {
@@ -464,6 +487,12 @@ struct Test {
             check("pmaddwd", 8, i32(i16_1) * 3 + i32(i16_2) * 4);
         }
 
+        // Horizontal sums of vectorized reductions
+        for (int w = 1; w <= 4; w *= 2) {
+            check_reduction("psadbw", 16*w, u32(in_u8(x + r_reduce)));
+            check_reduction("pmaddwd", 8*w, i32(in_i16(x + r_reduce)) * in_i16(x + r_reduce + 64));
+        }
+
         // llvm doesn't distinguish between signed and unsigned multiplies
         //check("pmuldq", 4, i64(i32_1) * i64(i32_2));
 
@@ -557,6 +586,14 @@ struct Test {
             check("vcvtps2pd" YMM, 8, f64(f32_1));
             check("vcvtpd2psy", 8, f32(f64_1));
 
+            if (target.has_feature(Target::F16C)) {
+                // float16 is converted to and from float32 eight lanes at a time.
+                Expr f16_1 = cast(Float(16), f32_1), f16_2 = cast(Float(16), f32_2);
+                check("vcvtps2ph", 8, f16_1);
+                check("vcvtph2ps" YMM, 8, f32(f16_1) + f32_2);
+                check("vcvtph2ps" YMM, 16, f16_1 * f16_2);
+            }
+
             // Newer llvms will just vpshufd straight from memory for reversed loads
             // check("vperm", 8, in_f32(100-x));
         }
@@ -656,6 +693,30 @@ struct Test {
             check("vpminuq", 8, min(u64_1, u64_2));
             check("vpmaxsq", 8, max(i64_1, i64_2));
             check("vpminsq", 8, min(i64_1, i64_2));
+
+            // AVX512BW saturating, averaging and high-half multiply ops
+            check("vpaddsb*zmm", 64, i8_sat(i16(i8_1) + i16(i8_2)));
+            check("vpsubsb*zmm", 64, i8_sat(i16(i8_1) - i16(i8_2)));
+            check("vpaddusb*zmm", 64, u8(min(u16(u8_1) + u16(u8_2), max_u8)));
+            check("vpsubusb*zmm", 64, u8(max(i16(u8_1) - i16(u8_2), 0)));
+            check("vpaddsw*zmm", 32, i16_sat(i32(i16_1) + i32(i16_2)));
+            check("vpsubsw*zmm", 32, i16_sat(i32(i16_1) - i32(i16_2)));
+            check("vpaddusw*zmm", 32, u16(min(u32(u16_1) + u32(u16_2), max_u16)));
+            check("vpsubusw*zmm", 32, u16(max(i32(u16_1) - i32(u16_2), 0)));
+            check("vpavgb*zmm", 64, u8((u16(u8_1) + u16(u8_2) + 1)/2));
+            check("vpavgw*zmm", 32, u16((u32(u16_1) + u32(u16_2) + 1)/2));
+            check("vpmulhw*zmm", 32, i16((i32(i16_1) * i32(i16_2)) / (256*256)));
+            check("vpmulhuw*zmm", 32, u16((u32(u16_1) * u32(u16_2)) / (256*256)));
+        }
+        if (use_avx512_vnni) {
+            // Dot products of four u8 x i8 or two i16 x i16 products
+            Expr u8_4 = in_u8(x+48), i8_4 = in_i8(x+48);
+            check("vpdpbusd", 16, (i32_1 + i32(u8_1) * i32(i8_1) + i32(u8_2) * i32(i8_2) +
+                                   i32(u8_3) * i32(i8_3) + i32(u8_4) * i32(i8_4)));
+            check("vpdpbusd", 16, (i32(u8_1) * -3 + i32(u8_2) * 5 +
+                                   i32(u8_3) * 7 + i32(u8_4) * -11 + i32_1));
+            check("vpdpwssd", 16, i32_1 + i32(i16_1) * i32(i16_2) + i32(i16_3) * i32(i16_1));
+            check("vpdpwssd", 32, i32_1 + i32(i16_1) * 3 + i32(i16_2) * -4);
         }
     }
 
@@ -1427,6 +1488,42 @@ struct Test {
         // Interleave or deinterleave two vectors. Given that we use
         // interleaving loads and stores, it's hard to hit this op with
         // halide.
+
+        // VPADDL   I       -       Pairwise Add Long
+        // VPADAL   I       -       Pairwise Add and Accumulate Long
+        // These are used for horizontal sums of vectorized reductions.
+        for (int w = 1; w <= 2; w++) {
+            check_reduction(arm32 ? "vpaddl.u8" : "uaddlp", 16*w, u16(in_u8(x + r_reduce)));
+            check_reduction(arm32 ? "vpaddl.s16" : "saddlp", 8*w, i32(in_i16(x + r_reduce)));
+        }
+
+        // The ARMv8.2 dot product instructions
+        if (target.has_feature(Target::ARMDotProd)) {
+            for (int w = 1; w <= 4; w *= 2) {
+                check_reduction(arm32 ? "vudot.u8" : "udot", 16*w,
+                                u32(in_u8(x + r_reduce)) * in_u8(x + r_reduce + 64));
+                check_reduction(arm32 ? "vsdot.s8" : "sdot", 16*w,
+                                i32(in_i8(x + r_reduce)) * in_i8(x + r_reduce + 64));
+                check_reduction(arm32 ? "vudot.u8" : "udot", 16*w, u32(in_u8(x + r_reduce)));
+            }
+            check_reduction(arm32 ? "vudot.u8" : "udot", 8,
+                            i32(in_u8(x + r_reduce)) * 3);
+        }
+
+        // The ARMv8.2 half-precision arithmetic instructions
+        if (target.has_feature(Target::ARMFp16)) {
+            Expr f16_1 = cast(Float(16), f32_1), f16_2 = cast(Float(16), f32_2);
+            for (int w = 1; w <= 2; w++) {
+                check(arm32 ? "vadd.f16" : "fadd*.8h", 8*w, f16_1 + f16_2);
+                check(arm32 ? "vsub.f16" : "fsub*.8h", 8*w, f16_1 - f16_2);
+                check(arm32 ? "vmul.f16" : "fmul*.8h", 8*w, f16_1 * f16_2);
+                check(arm32 ? "vmax.f16" : "fmax*.8h", 8*w, max(f16_1, f16_2));
+                check(arm32 ? "vmin.f16" : "fmin*.8h", 8*w, min(f16_1, f16_2));
+                if (!arm32) {
+                    check("fdiv*.8h", 8*w, f16_1 / f16_2);
+                }
+            }
+        }
     }
 
     void check_hvx_all() {
@@ -2074,7 +2171,7 @@ check("v*.w += vrmpy(v*.b,v*.b)", hvx_width, i32_1 + i32(i8_1)*i8_1 + i32(i8_2)*
         std::vector<std::future<TestResult>> futures;
         for (const Task &task : tasks) {
             futures.push_back(pool.async([this, task]() {
-                return check_one(task.op, task.name, task.vector_width, task.expr);
+                return check_one(task.op, task.name, task.vector_width, task.expr, task.is_reduction);
             }));
         }
 
@@ -0,0 +1,98 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+using std::string;
+
+// Count the allocations of a func's storage, and of the registers it
+// was promoted to.
+class CountAllocations : public IRVisitor {
+    string func;
+
+    using IRVisitor::visit;
+
+    void visit(const Allocate *op) {
+        IRVisitor::visit(op);
+        if (op->name == func) {
+            memory++;
+        } else if (starts_with(op->name, func + ".reg")) {
+            registers++;
+        }
+    }
+
+public:
+    int memory, registers;
+    CountAllocations(string f) : func(f), memory(0), registers(0) {}
+};
+
+class CheckAllocations : public IRMutator {
+    string func;
+    int correct;
+public:
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) {
+        CountAllocations c(func);
+        s.accept(&c);
+        if (c.memory != 0 || c.registers != correct) {
+            printf("%s has %d allocations in memory and %d in registers, "
+                   "instead of 0 and %d\n", func.c_str(), c.memory, c.registers, correct);
+            exit(-1);
+        }
+        return s;
+    }
+
+    CheckAllocations(string f, int c) : func(f), correct(c) {}
+};
+
+int main(int argc, char **argv) {
+    const int size = 64;
+
+    Buffer<float> A(size, size), B(size, size);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            A(x, y) = (rand() % 64) / 8.0f;
+            B(x, y) = (rand() % 64) / 8.0f;
+        }
+    }
+
+    // A matrix multiply that accumulates a 4x2 tile of 8-wide vectors
+    // in registers.
+    Var x("x"), y("y"), xi("xi"), yi("yi");
+    RDom k(0, size);
+
+    Func tile("tile");
+    tile(x, y) += A(k, y) * B(x, k);
+
+    Func out("out");
+    out(x, y) = tile(x, y);
+    out.tile(x, y, xi, yi, 32, 2).vectorize(xi, 8).unroll(xi).unroll(yi);
+
+    tile.compute_at(out, x).store_in_registers()
+        .bound_extent(x, 32).bound_extent(y, 2)
+        .vectorize(x, 8).unroll(x).unroll(y)
+        .update()
+        .reorder(x, y, k).vectorize(x, 8).unroll(x).unroll(y);
+
+    out.add_custom_lowering_pass(new CheckAllocations(tile.name(), 8));
+
+    Buffer<float> result = out.realize(size, size);
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float correct = 0.0f;
+            for (int i = 0; i < size; i++) {
+                correct += A(i, y) * B(x, i);
+            }
+            if (result(x, y) != correct) {
+                printf("result(%d, %d) = %f instead of %f\n",
+                       x, y, result(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
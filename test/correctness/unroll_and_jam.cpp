@@ -0,0 +1,161 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+using std::string;
+
+// Find the smallest and largest number of stores to a func in the
+// innermost loops of its update. Only one side of an if is executed,
+// so an if counts as whichever side has more stores.
+class CountInnermostStores : public IRVisitor {
+    string func;
+    int stores;
+    bool innermost;
+
+    using IRVisitor::visit;
+
+    void visit(const For *op) {
+        int old_stores = stores;
+        stores = 0;
+        innermost = true;
+        IRVisitor::visit(op);
+        if (innermost && starts_with(op->name, func + ".s1.")) {
+            min_stores = seen ? std::min(min_stores, stores) : stores;
+            max_stores = seen ? std::max(max_stores, stores) : stores;
+            seen = true;
+        }
+        stores = old_stores;
+        innermost = false;
+    }
+
+    void visit(const IfThenElse *op) {
+        op->condition.accept(this);
+        int old_stores = stores;
+        stores = 0;
+        op->then_case.accept(this);
+        int then_stores = stores;
+        stores = 0;
+        if (op->else_case.defined()) {
+            op->else_case.accept(this);
+        }
+        stores = old_stores + std::max(then_stores, stores);
+    }
+
+    void visit(const Store *op) {
+        IRVisitor::visit(op);
+        if (op->name == func) {
+            stores++;
+        }
+    }
+
+public:
+    bool seen;
+    int min_stores, max_stores;
+    CountInnermostStores(string f) : func(f), stores(0), innermost(false),
+                                     seen(false), min_stores(0), max_stores(0) {}
+};
+
+class CheckInnermostStores : public IRMutator {
+    string func;
+    int correct;
+public:
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) {
+        CountInnermostStores c(func);
+        s.accept(&c);
+        if (!c.seen) {
+            printf("There are no loops in the update of %s\n", func.c_str());
+            exit(-1);
+        }
+        if (c.min_stores != correct || c.max_stores != correct) {
+            printf("There were between %d and %d stores to %s in the innermost loops instead of %d\n",
+                   c.min_stores, c.max_stores, func.c_str(), correct);
+            exit(-1);
+        }
+        return s;
+    }
+
+    CheckInnermostStores(string f, int c) : func(f), correct(c) {}
+};
+
+int main(int argc, char **argv) {
+    const int size = 70;
+
+    Buffer<float> A(size, size), B(size, size);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            A(x, y) = (rand() % 64) / 8.0f;
+            B(x, y) = (rand() % 64) / 8.0f;
+        }
+    }
+
+    Var x("x"), y("y");
+    RDom k(0, size);
+
+    for (int factor : {2, 3, 4}) {
+        Func prod("prod");
+        prod(x, y) = 0.0f;
+        prod(x, y) += A(k, y) * B(x, k);
+
+        // Every iteration of the loop over k updates 'factor' rows of
+        // vectors of prod, so the jammed loop over x should have that
+        // many stores in it.
+        prod.update()
+            .reorder(x, k, y)
+            .vectorize(x, 8, TailStrategy::GuardWithIf)
+            .unroll_and_jam(y, factor, TailStrategy::GuardWithIf);
+
+        prod.add_custom_lowering_pass(new CheckInnermostStores(prod.name(), factor));
+
+        Buffer<float> result = prod.realize(size, size);
+
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                float correct = 0.0f;
+                for (int i = 0; i < size; i++) {
+                    correct += A(i, y) * B(x, i);
+                }
+                if (result(x, y) != correct) {
+                    printf("result(%d, %d) = %f instead of %f (factor %d)\n",
+                           x, y, result(x, y), correct, factor);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // Unroll and jam an RVar. The order of the updates to each
+        // value of sum_cols shouldn't change.
+        Func sum_cols("sum_cols");
+        RDom r(0, size, 0, size);
+        sum_cols(x) = 0.0f;
+        sum_cols(x) += A(x, r.y) * B(r.x, r.y);
+        sum_cols.update()
+            .reorder(x, r.x, r.y)
+            .vectorize(x, 8, TailStrategy::GuardWithIf)
+            .unroll_and_jam(r.x, 2, TailStrategy::GuardWithIf);
+
+        sum_cols.add_custom_lowering_pass(new CheckInnermostStores(sum_cols.name(), 2));
+
+        Buffer<float> result = sum_cols.realize(size);
+
+        for (int x = 0; x < size; x++) {
+            float correct = 0.0f;
+            for (int j = 0; j < size; j++) {
+                for (int i = 0; i < size; i++) {
+                    correct += A(x, j) * B(i, j);
+                }
+            }
+            if (result(x) != correct) {
+                printf("sum_cols(%d) = %f instead of %f\n", x, result(x), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+// Vectorizing an RVar of an associative and commutative reduction into a
+// site that doesn't depend on the RVar reduces the vector lanes
+// horizontally. It shouldn't require allow_race_conditions(), and should
+// compute the same thing as the scalar reduction.
+int main(int argc, char **argv) {
+    const int W = 64, H = 32;
+
+    Buffer<uint8_t> in_u8(W, H);
+    Buffer<int16_t> in_i16(W, H);
+    Buffer<float> in_f32(W, H);
+    Buffer<int32_t> in_i32(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            in_u8(x, y) = (uint8_t)(rand() & 0xff);
+            in_i16(x, y) = (int16_t)((rand() & 0xffff) - 32768);
+            in_f32(x, y) = (rand() & 0xfff) / 16.0f;
+            in_i32(x, y) = rand() - RAND_MAX / 2;
+        }
+    }
+
+    Var y("y");
+    RDom r(0, W, "r");
+
+    {
+        // A widening sum of bytes.
+        Func f("f");
+        f(y) = cast<uint32_t>(0);
+        f(y) += cast<uint32_t>(in_u8(r, y));
+        f.update().vectorize(r, 32);
+
+        Buffer<uint32_t> result = f.realize(H);
+        for (int y = 0; y < H; y++) {
+            uint32_t correct = 0;
+            for (int x = 0; x < W; x++) {
+                correct += in_u8(x, y);
+            }
+            if (result(y) != correct) {
+                printf("sum of bytes: result(%d) = %u instead of %u\n", y, result(y), correct);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // A dot product of 16-bit values, with the accumulator written
+        // on the right and subtraction of the products.
+        Func f("f");
+        f(y) = 0;
+        f(y) = 7 - cast<int>(in_i16(r, y)) * in_i16(W - 1 - r, y) + f(y);
+        f.update().vectorize(r, 16);
+
+        Buffer<int> result = f.realize(H);
+        for (int y = 0; y < H; y++) {
+            int correct = 0;
+            for (int x = 0; x < W; x++) {
+                correct = 7 - (int)in_i16(x, y) * in_i16(W - 1 - x, y) + correct;
+            }
+            if (result(y) != correct) {
+                printf("dot product: result(%d) = %d instead of %d\n", y, result(y), correct);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // A maximum, as a total reduction.
+        Func f("f");
+        RDom r2(0, W, 0, H, "r2");
+        f() = in_f32(0, 0);
+        f() = max(f(), in_f32(r2.x, r2.y));
+        f.update().vectorize(r2.x, 8);
+
+        Buffer<float> result = f.realize();
+        float correct = in_f32(0, 0);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                correct = std::max(correct, in_f32(x, y));
+            }
+        }
+        if (result() != correct) {
+            printf("maximum: result() = %f instead of %f\n", result(), correct);
+            return -1;
+        }
+    }
+
+    {
+        // A boolean reduction, with a tail.
+        Func f("f");
+        RDom r3(0, W - 3, "r3");
+        f(y) = cast<bool>(1);
+        f(y) = f(y) && (in_u8(r3, y) != 0);
+        f.update().vectorize(r3, 8);
+
+        Buffer<bool> result = f.realize(H);
+        for (int y = 0; y < H; y++) {
+            bool correct = true;
+            for (int x = 0; x < W - 3; x++) {
+                correct = correct && (in_u8(x, y) != 0);
+            }
+            if (result(y) != correct) {
+                printf("all: result(%d) = %d instead of %d\n", y, result(y), correct);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // A sum of floats, with a tail. The loads of the tail are
+        // predicated, so the masked-off lanes must not be summed.
+        Func f("f");
+        RDom r4(0, W - 5, "r4");
+        f(y) = 0.0f;
+        f(y) += in_f32(r4, y);
+        f.update().vectorize(r4, 8);
+
+        Buffer<float> result = f.realize(H);
+        for (int y = 0; y < H; y++) {
+            // All partial sums are exact, so the order doesn't matter.
+            float correct = 0.0f;
+            for (int x = 0; x < W - 5; x++) {
+                correct += in_f32(x, y);
+            }
+            if (result(y) != correct) {
+                printf("sum of floats: result(%d) = %f instead of %f\n", y, result(y), correct);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // A minimum of 32-bit ints, with a tail.
+        Func f("f");
+        RDom r5(0, W - 3, "r5");
+        f(y) = in_i32(W - 1, y);
+        f(y) = min(f(y), in_i32(r5, y));
+        f.update().vectorize(r5, 8);
+
+        Buffer<int> result = f.realize(H);
+        for (int y = 0; y < H; y++) {
+            int correct = in_i32(W - 1, y);
+            for (int x = 0; x < W - 3; x++) {
+                correct = std::min(correct, in_i32(x, y));
+            }
+            if (result(y) != correct) {
+                printf("minimum: result(%d) = %d instead of %d\n", y, result(y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include <stdio.h>
+
+#include "compile_server.h"
+#include "HalideBuffer.h"
+
+using namespace Halide::Runtime;
+
+int main(int argc, char **argv) {
+    Buffer<int32_t> output(32, 32);
+
+    // Check that the compile server applied the generator args of
+    // the request.
+    compile_server(output);
+
+    for (int y = 0; y < output.height(); y++) {
+        for (int x = 0; x < output.width(); x++) {
+            if (output(x, y) != x + y + 3) {
+                printf("output(%d, %d) = %d instead of %d\n",
+                       x, y, output(x, y), x + y + 3);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
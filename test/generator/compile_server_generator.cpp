@@ -0,0 +1,29 @@
+#include "Halide.h"
+#include <stdio.h>
+
+namespace {
+
+class CompileServer : public Halide::Generator<CompileServer> {
+public:
+    GeneratorParam<int> offset{ "offset", 0 };  // deliberately wrong value, must be overridden to 3
+
+    Output<Func> output{ "output", Int(32), 2 };
+
+    void generate() {
+        // When this is compiled by a compile server, this must not be
+        // mistaken for the server's reply.
+        printf("error: this is not a reply\n");
+        fflush(stdout);
+
+        Var x, y;
+        output(x, y) = x + y + offset;
+    }
+
+    void schedule() {
+        // nothing
+    }
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(CompileServer, compile_server)
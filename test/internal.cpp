@@ -6,6 +6,7 @@
 #include "Func.h"
 #include "Simplify.h"
 #include "Bounds.h"
+#include "IRArena.h"
 #include "IRMatch.h"
 #include "Deinterleave.h"
 #include "ModulusRemainder.h"
@@ -25,6 +26,7 @@ int main(int argc, const char **argv) {
     IRPrinter::test();
     CodeGen_C::test();
     ir_equality_test();
+    ir_arena_test();
     bounds_test();
     expr_match_test();
     deinterleave_vector_test();
@@ -0,0 +1,60 @@
+#include "Halide.h"
+#include "halide_benchmark.h"
+#include "halide_calibrate.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+int main(int argc, char **argv) {
+    const int W = 1024, H = 1024;
+
+    Buffer<float> input(W + 8, H + 8);
+    input.for_each_element([&](int x, int y) {
+        input(x, y) = (float)((x * 17 + y * 31) & 0xff);
+    });
+    Buffer<float> output(W, H);
+
+    auto make_pipeline = [&]() {
+        Var x("x"), y("y");
+        Func blur_x("blur_x"), blur_y("blur_y"), out("out");
+        blur_x(x, y) = input(x, y) + input(x + 4, y) + input(x + 8, y);
+        blur_y(x, y) = blur_x(x, y) + blur_x(x, y + 4) + blur_x(x, y + 8);
+        out(x, y) = blur_y(x, y) - input(x + 4, y + 4);
+        out.estimate(x, 0, W).estimate(y, 0, H);
+        return Pipeline(out);
+    };
+    auto run = [&](Pipeline p) {
+        p.realize(output);
+    };
+
+    BenchmarkConfig config;
+    config.min_time = 0.02;
+    config.max_time = 0.1;
+
+    std::vector<CalibrationSample> samples;
+    Target target = get_jit_target_from_environment();
+    MachineParams initial = MachineParams::generic();
+    MachineParams best = calibrate_machine_params(make_pipeline, run, target, initial,
+                                                  &samples, config);
+
+    bool found = false;
+    for (const CalibrationSample &s : samples) {
+        printf("%s: %f ms\n", s.params.to_string().c_str(), s.seconds * 1e3);
+        found |= (s.params.to_string() == best.to_string());
+    }
+    if (!found) {
+        printf("Calibrated parameters %s were not one of the candidates\n",
+               best.to_string().c_str());
+        return -1;
+    }
+
+    // The result must survive the round trip through HL_MACHINE_PARAMS.
+    if (MachineParams(best.to_string()).to_string() != best.to_string()) {
+        printf("MachineParams string round trip failed for %s\n", best.to_string().c_str());
+        return -1;
+    }
+
+    printf("Calibrated machine params: %s\n", best.to_string().c_str());
+    printf("Success!\n");
+    return 0;
+}
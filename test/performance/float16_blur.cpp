@@ -0,0 +1,69 @@
+#include "Halide.h"
+#include <cstdio>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// A 3x3 box blur of float16 data. The data stays float16 in memory, and
+// the arithmetic is done in float32. With F16C the conversions should be
+// vectorized, so it should be faster than the same pipeline without.
+Func build(Buffer<float16_t> in) {
+    Var x("x"), y("y"), yo("yo");
+    Func blur_x("blur_x"), blur_y("blur_y");
+    const float16_t third(1.0f / 3);
+    blur_x(x, y) = (in(x, y) + in(x + 1, y) + in(x + 2, y)) * third;
+    blur_y(x, y) = (blur_x(x, y) + blur_x(x, y + 1) + blur_x(x, y + 2)) * third;
+
+    blur_y.split(y, yo, y, 32).parallel(yo).vectorize(x, 16);
+    blur_x.store_at(blur_y, yo).compute_at(blur_y, y).vectorize(x, 16);
+    return blur_y;
+}
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.arch != Target::X86 || !target.has_feature(Target::F16C)) {
+        printf("Not running test because the target doesn't have F16C\n");
+        return 0;
+    }
+
+    const int W = 2048, H = 2048;
+    Buffer<float16_t> in(W + 2, H + 2);
+    for (int y = 0; y < in.height(); y++) {
+        for (int x = 0; x < in.width(); x++) {
+            in(x, y) = float16_t((rand() & 0x3ff) / 64.0f);
+        }
+    }
+
+    Func with_f16c = build(in);
+    Func without_f16c = build(in);
+    with_f16c.compile_jit(target);
+    without_f16c.compile_jit(target.without_feature(Target::F16C));
+
+    Buffer<float16_t> out_with(W, H), out_without(W, H);
+
+    double with_time = benchmark([&]() { with_f16c.realize(out_with); });
+    double without_time = benchmark([&]() { without_f16c.realize(out_without); });
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if (out_with(x, y).to_bits() != out_without(x, y).to_bits()) {
+                printf("Mismatched answers at (%d, %d): %f vs %f\n",
+                       x, y, (float)out_with(x, y), (float)out_without(x, y));
+                return 1;
+            }
+        }
+    }
+
+    printf("With F16C: %f ms\n"
+           "Without F16C: %f ms\n",
+           with_time * 1e3, without_time * 1e3);
+
+    if (with_time > without_time) {
+        printf("Using F16C is slower than not using it.\n");
+        return 1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -25,7 +25,7 @@ int main(int argc, char **argv) {
     ImageParam A(type_of<float>(), 2);
     ImageParam B(type_of<float>(), 2);
 
-    Var x("x"), xi("xi"), xo("xo"), y("y"), yo("yo"), yi("yo"), yii("yii"), xii("xii");
+    Var x("x"), xi("xi"), y("y"), yi("yi");
     Func matrix_mul("matrix_mul");
 
     RDom k(0, matrix_size);
@@ -36,12 +36,16 @@ int main(int argc, char **argv) {
 
     matrix_mul.vectorize(x, 8);
 
+    // Keep a 4x4 block of vector accumulators in registers. The rows
+    // are unrolled and jammed into the vectorized loop over columns.
     matrix_mul.update(0)
-        .split(x, x, xi, block_size).split(xi, xi, xii, 8)
-        .split(y, y, yi, block_size).split(yi, yi, yii, 4)
+        .split(x, x, xi, block_size)
+        .split(y, y, yi, block_size)
         .split(k, k, ki, block_size)
-        .reorder(xii, yii, xi, ki, yi, k, x, y)
-        .parallel(y).vectorize(xii).unroll(xi).unroll(yii);
+        .reorder(xi, ki, yi, k, x, y)
+        .vectorize(xi, 8).unroll(xi)
+        .unroll_and_jam(yi, 4)
+        .parallel(y);
 
     matrix_mul
         .bound(x, 0, matrix_size)
@@ -0,0 +1,93 @@
+#include "Halide.h"
+#include "halide_benchmark.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// A copy of a buffer that is much larger than the caches, so the
+// output won't be read again before it's evicted. Non-temporal stores
+// avoid reading each cache line of the output before overwriting it,
+// and avoid evicting other data to make room for it.
+Func build(ImageParam src, bool nontemporal) {
+    Func dst("dst");
+    Var x("x"), xo("xo");
+    dst(x) = src(x);
+
+    dst.split(x, xo, x, 1 << 16, TailStrategy::GuardWithIf)
+        .parallel(xo)
+        .vectorize(x, 16, TailStrategy::GuardWithIf);
+
+    // The stores are only non-temporal if they are aligned, so tell
+    // Halide that every vector of the output is aligned.
+    dst.output_buffer().set_host_alignment(64);
+    dst.output_buffer().dim(0).set_min(0);
+
+    if (nontemporal) {
+        dst.store_nontemporal();
+    }
+    return dst;
+}
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.arch != Target::X86 && target.arch != Target::ARM) {
+        printf("Not running test because non-temporal stores are only implemented on x86 and ARM\n");
+        return 0;
+    }
+
+    ImageParam src(Float(32), 1);
+    Func with_nt = build(src, true);
+    Func without_nt = build(src, false);
+
+    // Check that the non-temporal stores made it into the assembly.
+    with_nt.compile_to_assembly("halide_nontemporal_copy.s", {src}, "halide_nontemporal_copy", target);
+    std::ifstream asm_file("halide_nontemporal_copy.s");
+    std::stringstream asm_stream;
+    asm_stream << asm_file.rdbuf();
+    const char *instruction = target.arch == Target::X86 ? "movnt" : "stnp";
+    if (asm_stream.str().find(instruction) == std::string::npos) {
+        printf("There are no %s instructions in halide_nontemporal_copy.s\n", instruction);
+        return -1;
+    }
+
+    with_nt.compile_jit(target);
+    without_nt.compile_jit(target);
+
+    const int32_t buffer_size = 1 << 25;
+
+    Buffer<float> input(buffer_size);
+    for (int i = 0; i < buffer_size; i++) {
+        input(i) = (float)i;
+    }
+    Buffer<float> out_with(buffer_size), out_without(buffer_size);
+
+    src.set(input);
+
+    double with_time = benchmark([&]() { with_nt.realize(out_with); });
+    double without_time = benchmark([&]() { without_nt.realize(out_without); });
+
+    for (int i = 0; i < buffer_size; i++) {
+        if (out_with(i) != input(i) || out_without(i) != input(i)) {
+            printf("Mismatched answers at %d: %f %f instead of %f\n",
+                   i, out_with(i), out_without(i), input(i));
+            return -1;
+        }
+    }
+
+    double bytes = 2.0 * buffer_size * sizeof(float);
+    printf("With non-temporal stores: %.3e byte/s\n"
+           "Without non-temporal stores: %.3e byte/s\n",
+           bytes / with_time, bytes / without_time);
+
+    // Leave some room for noise.
+    if (with_time > without_time * 1.2) {
+        printf("Using non-temporal stores is slower than not using them.\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -48,6 +48,9 @@ std::ostream &operator<<(std::ostream &stream, const halide_type_t &type) {
         case halide_type_handle:
             stream << "handle";
             break;
+        case halide_type_bfloat:
+            stream << "bfloat";
+            break;
         default:
             stream << "#unknown";
             break;
@@ -0,0 +1,202 @@
+#!/bin/bash
+
+# autotune_schedule_params.sh
+#
+# An offline autotuner for the ScheduleParams of a Generator. Each
+# combination of the given ScheduleParam values is compiled (in parallel)
+# into a separate filter, linked with RunGen, and benchmarked (one at a
+# time) on the given inputs with RunGen's --benchmarks=all. The timings
+# of all variants are written to stdout, fastest last, followed by the
+# fastest configuration in the form it can be passed to the Generator.
+#
+# Usage:
+#
+#   autotune_schedule_params.sh -g GENERATOR_BINARY -n GENERATOR_NAME
+#       [-t TARGET] [-j JOBS] [-o WORK_DIR] [-r RUNGEN_OBJECT]
+#       param=values [param=values...] [generator_arg=value...]
+#       -- [rungen_arg=value...]
+#
+#   -g  The Generator executable (e.g. built with GenGen.cpp).
+#   -n  The name of the Generator to tune.
+#   -t  The Halide target to compile for [default = host].
+#   -j  The number of variants to compile in parallel [default = number
+#       of cores].
+#   -o  The directory to build the variants in [default = a temporary
+#       directory, which is removed afterwards].
+#   -r  A prebuilt RunGen.o to link the variants with. Otherwise it is
+#       compiled from RunGen.cpp next to this script.
+#
+# The values to try for a ScheduleParam are given as a comma-separated
+# list, in which an item of the form LO:HI or LO:HI:STEP stands for the
+# integers from LO to HI. For example, "tile=16,32,64" tries three values
+# and "vec=4:16:4" tries 4, 8, 12 and 16. Any other argument of the form
+# name=value before the "--" (e.g. a GeneratorParam) is passed to the
+# Generator unchanged. Everything after "--" is passed to RunGen to
+# specify the inputs to benchmark on; for instance, "input=zero:[1920,1080]".
+#
+# The compiler and flags used to build RunGen and link the variants can
+# be set with the environment variables CXX [default = c++], CXXFLAGS and
+# LDFLAGS. CXXFLAGS must let the compiler find HalideRuntime.h and
+# HalideBuffer.h; if HALIDE_DISTRIB_PATH is set, its include directory is
+# added. LDFLAGS should contain the libraries required by RunGen's image
+# I/O [default = -lpng -ljpeg].
+
+set -eo pipefail
+
+usage() {
+    sed -n '3,/^$/s/^# \{0,1\}//p' "$0" >&2
+    exit 1
+}
+
+TOOLS_DIR=$(cd "$(dirname "$0")" && pwd)
+CXX=${CXX:-c++}
+CXXFLAGS="-I${TOOLS_DIR} ${CXXFLAGS}"
+if [[ -n "${HALIDE_DISTRIB_PATH}" ]]; then
+    CXXFLAGS="${CXXFLAGS} -I${HALIDE_DISTRIB_PATH}/include"
+fi
+LDFLAGS=${LDFLAGS:--lpng -ljpeg}
+
+GENERATOR=
+NAME=
+TARGET=host
+JOBS=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)
+WORK_DIR=
+RUNGEN_OBJECT=
+
+while getopts "g:n:t:j:o:r:" opt; do
+    case "${opt}" in
+        g) GENERATOR=${OPTARG} ;;
+        n) NAME=${OPTARG} ;;
+        t) TARGET=${OPTARG} ;;
+        j) JOBS=${OPTARG} ;;
+        o) WORK_DIR=${OPTARG} ;;
+        r) RUNGEN_OBJECT=${OPTARG} ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [[ -z "${GENERATOR}" || -z "${NAME}" ]]; then
+    usage
+fi
+
+# Expand a comma-separated list of values and LO:HI[:STEP] ranges.
+expand_values() {
+    local item
+    local IFS=,
+    for item in $1; do
+        if [[ "${item}" =~ ^(-?[0-9]+):(-?[0-9]+)(:([0-9]+))?$ ]]; then
+            local lo=${BASH_REMATCH[1]} hi=${BASH_REMATCH[2]} step=${BASH_REMATCH[4]:-1}
+            if [[ ${step} -le 0 ]]; then
+                echo "Invalid step in range: ${item}" >&2
+                exit 1
+            fi
+            local v
+            for ((v = lo; v <= hi; v += step)); do
+                echo "${v}"
+            done
+        else
+            echo "${item}"
+        fi
+    done
+}
+
+# The configurations to try, one per line, each a space-separated list of
+# name=value pairs.
+CONFIGS=("")
+GENERATOR_ARGS=()
+while [[ $# -gt 0 && "$1" != "--" ]]; do
+    if [[ ! "$1" =~ ^([A-Za-z_][A-Za-z0-9_]*)=(.+)$ ]]; then
+        echo "Expected name=values, got: $1" >&2
+        usage
+    fi
+    PARAM=${BASH_REMATCH[1]}
+    VALUES=${BASH_REMATCH[2]}
+    if [[ "${VALUES}" == *,* || "${VALUES}" =~ ^-?[0-9]+:-?[0-9]+(:[0-9]+)?$ ]]; then
+        NEW_CONFIGS=()
+        for CONFIG in "${CONFIGS[@]}"; do
+            for VALUE in $(expand_values "${VALUES}"); do
+                NEW_CONFIGS+=("${CONFIG:+${CONFIG} }${PARAM}=${VALUE}")
+            done
+        done
+        CONFIGS=("${NEW_CONFIGS[@]}")
+    else
+        GENERATOR_ARGS+=("$1")
+    fi
+    shift
+done
+if [[ "$1" == "--" ]]; then
+    shift
+fi
+RUNGEN_ARGS=("$@")
+
+if [[ -z "${WORK_DIR}" ]]; then
+    WORK_DIR=$(mktemp -d -t autotune.XXXXXX)
+    trap 'rm -rf "${WORK_DIR}"' EXIT
+fi
+mkdir -p "${WORK_DIR}"
+
+if [[ -z "${RUNGEN_OBJECT}" ]]; then
+    RUNGEN_OBJECT=${WORK_DIR}/RunGen.o
+    ${CXX} -std=c++11 -O2 -c "${TOOLS_DIR}/RunGen.cpp" ${CXXFLAGS} -o "${RUNGEN_OBJECT}"
+fi
+
+echo "Compiling ${#CONFIGS[@]} variants of ${NAME} for ${TARGET}..." >&2
+
+# Compile and link the variant 'i', with the ScheduleParam values in
+# CONFIGS[i]. Failures are logged to the variant's directory.
+build_variant() {
+    local i=$1
+    local dir=${WORK_DIR}/variant_${i}
+    mkdir -p "${dir}"
+    if ! "${GENERATOR}" -g "${NAME}" -f "${NAME}" -o "${dir}" target="${TARGET}" \
+            "${GENERATOR_ARGS[@]}" ${CONFIGS[${i}]} > "${dir}/build.log" 2>&1; then
+        return 1
+    fi
+    ${CXX} -std=c++11 -DHL_RUNGEN_FILTER_HEADER="\"${NAME}.h\"" -I"${dir}" ${CXXFLAGS} \
+        "${RUNGEN_OBJECT}" "${TOOLS_DIR}/RunGenStubs.cpp" "${dir}/${NAME}.a" \
+        ${LDFLAGS} -ldl -lpthread -o "${dir}/rungen" >> "${dir}/build.log" 2>&1
+}
+
+PIDS=()
+for ((i = 0; i < ${#CONFIGS[@]}; i++)); do
+    while [[ $(jobs -rp | wc -l) -ge ${JOBS} ]]; do
+        sleep 0.1
+    done
+    build_variant ${i} &
+    PIDS[${i}]=$!
+done
+
+# Benchmark the variants one at a time, so that they don't compete for
+# the machine.
+RESULTS=()
+for ((i = 0; i < ${#CONFIGS[@]}; i++)); do
+    dir=${WORK_DIR}/variant_${i}
+    if ! wait ${PIDS[${i}]}; then
+        echo "Failed to build variant (${CONFIGS[${i}]}):" >&2
+        cat "${dir}/build.log" >&2
+        continue
+    fi
+    if ! OUTPUT=$("${dir}/rungen" "${RUNGEN_ARGS[@]}" --benchmarks=all 2>&1); then
+        echo "Failed to run variant (${CONFIGS[${i}]}):" >&2
+        echo "${OUTPUT}" >&2
+        continue
+    fi
+    if [[ ! "${OUTPUT}" =~ best\ case\ of\ ([^ ]+)\ sec/iter ]]; then
+        echo "Unable to find the benchmark result of variant (${CONFIGS[${i}]}):" >&2
+        echo "${OUTPUT}" >&2
+        continue
+    fi
+    RESULTS+=("${BASH_REMATCH[1]} ${CONFIGS[${i}]}")
+done
+
+if [[ ${#RESULTS[@]} -eq 0 ]]; then
+    echo "No variant could be benchmarked." >&2
+    exit 1
+fi
+
+printf "%s\n" "${RESULTS[@]}" | sort -g -r | while read -r TIME CONFIG; do
+    echo "${TIME} sec/iter: ${CONFIG}"
+done
+BEST=$(printf "%s\n" "${RESULTS[@]}" | sort -g | head -n 1)
+echo "Best: ${BEST#* }"
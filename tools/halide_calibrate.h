@@ -0,0 +1,104 @@
+#ifndef HALIDE_CALIBRATE_H
+#define HALIDE_CALIBRATE_H
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Halide.h"
+#include "halide_benchmark.h"
+
+namespace Halide {
+namespace Tools {
+
+// One measurement taken during calibration: the machine parameters given to
+// the auto-scheduler, and the runtime (in seconds) of the schedule it chose.
+struct CalibrationSample {
+    MachineParams params;
+    double seconds;
+};
+
+// Calibrate the auto-scheduler's machine model against the host.
+//
+// 'make_pipeline' must return a fresh, unscheduled copy of the pipeline to
+// calibrate on (with estimates on its outputs and inputs), and 'run' must
+// realize a pipeline produced by it once. The pipeline is auto-scheduled with
+// candidate parameters around 'initial' (scaling the load cost 'balance', and
+// with it 'l2_balance', and the last level cache size), which lead the
+// auto-scheduler to different groupings and tile configurations. Each distinct
+// schedule is benchmarked, and the parameters which gave the fastest one are
+// returned; 'initial' is kept unless another candidate is at least 2% faster.
+// All measurements are appended to 'samples', if it is non-null.
+//
+// The result can be passed to Pipeline::auto_schedule() directly, or made
+// the default for the host by setting HL_MACHINE_PARAMS to result.to_string().
+//
+// Note that this JIT-compiles and runs the pipeline many times, and that
+// the chosen parameters are only as representative as the pipeline used.
+inline MachineParams calibrate_machine_params(std::function<Pipeline()> make_pipeline,
+                                              std::function<void(Pipeline)> run,
+                                              const Target &target,
+                                              const MachineParams &initial = MachineParams::generic(),
+                                              std::vector<CalibrationSample> *samples = nullptr,
+                                              const BenchmarkConfig &config = {}) {
+    auto value = [](const Expr &e) {
+        const int64_t *i = Internal::as_const_int(e);
+        user_assert(i) << "MachineParams must be constant integers: " << e << "\n";
+        return *i;
+    };
+    auto scaled = [](int64_t v, double s, int64_t min_value) {
+        return (int32_t)std::max(min_value, (int64_t)(v * s + 0.5));
+    };
+
+    std::vector<MachineParams> candidates = {initial};
+    for (double cache_scale : {1.0, 0.25, 4.0}) {
+        for (double balance_scale : {1.0, 0.25, 0.5, 2.0, 4.0}) {
+            if (cache_scale == 1.0 && balance_scale == 1.0) {
+                continue;
+            }
+            MachineParams p = initial;
+            p.balance = scaled(value(initial.balance), balance_scale, 1);
+            p.last_level_cache_size = scaled(value(initial.last_level_cache_size), cache_scale, 1024);
+            if (initial.has_cache_hierarchy()) {
+                p.l2_balance = scaled(value(initial.l2_balance), balance_scale, 1);
+                p.last_level_cache_size = (int32_t)std::max(value(p.last_level_cache_size),
+                                                            value(initial.l2_cache_size));
+            }
+            candidates.push_back(p);
+        }
+    }
+
+    // Many candidates lead to the same schedule; only benchmark each
+    // schedule once.
+    std::map<std::string, double> schedule_times;
+    MachineParams best = initial;
+    double best_time = 0;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        Pipeline p = make_pipeline();
+        std::string schedule = p.auto_schedule(target, candidates[i]);
+        auto iter = schedule_times.find(schedule);
+        double seconds;
+        if (iter != schedule_times.end()) {
+            seconds = iter->second;
+        } else {
+            p.compile_jit(target);
+            seconds = benchmark([&]() { run(p); }, config).wall_time;
+            schedule_times[schedule] = seconds;
+        }
+        if (samples) {
+            samples->push_back({candidates[i], seconds});
+        }
+        if (i == 0 || seconds < best_time * 0.98) {
+            best = candidates[i];
+            best_time = seconds;
+        }
+    }
+    return best;
+}
+
+}  // namespace Tools
+}  // namespace Halide
+
+#endif  // HALIDE_CALIBRATE_H
@@ -1181,6 +1181,7 @@ bool save_mat(ImageType &im, const std::string &filename) {
         };
         break;
     case halide_type_handle:
+    case halide_type_bfloat:
         check(false, "unreachable");
     }
 